@@ -0,0 +1,267 @@
+//
+// Copyright 2018 The Simons Foundation, Inc. - All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef __ITENSOR_BENCH_H
+#define __ITENSOR_BENCH_H
+
+//
+// Minimal benchmark harness modeled on Google Benchmark.
+//
+// Benchmarks are registered with BENCH(name) and time the body
+// of a "while(state.keepRunning())" loop. Setup done before the
+// loop is not timed. The runner accepts the Google Benchmark
+// flags --benchmark_filter=<regex>, --benchmark_min_time=<sec>,
+// --benchmark_repetitions=<n>, --benchmark_out=<file> and
+// --benchmark_format=<console|json>, and its JSON output follows
+// the Google Benchmark schema so that either compare.py in this
+// directory or Google Benchmark's own tools/compare.py can read it.
+//
+
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <regex>
+#include <string>
+#include <vector>
+#include "itensor/util/print.h"
+#include "itensor/util/cputime.h"
+
+namespace itensor {
+
+class BenchState
+    {
+    public:
+    using clock_type = std::chrono::steady_clock;
+
+    private:
+    long iters_ = 0,
+         done_ = 0;
+    bool started_ = false,
+         paused_ = false;
+    clock_type::time_point wstart_;
+    double cstart_ = 0.;
+    double wall_ = 0.,
+           cpu_ = 0.;
+    public:
+
+    std::map<std::string,double> counters;
+
+    explicit
+    BenchState(long iters) : iters_(iters) { }
+
+    bool
+    keepRunning()
+        {
+        if(!started_)
+            {
+            started_ = true;
+            resumeTiming();
+            }
+        if(done_ < iters_)
+            {
+            ++done_;
+            return true;
+            }
+        pauseTiming();
+        return false;
+        }
+
+    //Exclude per-iteration setup from the timing
+    void
+    pauseTiming()
+        {
+        if(paused_) return;
+        wall_ += std::chrono::duration<double>(clock_type::now()-wstart_).count();
+        cpu_ += cpu_mytime()-cstart_;
+        paused_ = true;
+        }
+
+    void
+    resumeTiming()
+        {
+        wstart_ = clock_type::now();
+        cstart_ = cpu_mytime();
+        paused_ = false;
+        }
+
+    long
+    iterations() const { return iters_; }
+
+    double
+    wallTime() const { return wall_; }
+
+    double
+    cpuTime() const { return cpu_; }
+    };
+
+using BenchFunc = std::function<void(BenchState&)>;
+
+struct BenchEntry
+    {
+    std::string name;
+    BenchFunc func;
+    };
+
+inline std::vector<BenchEntry>&
+benchRegistry()
+    {
+    static std::vector<BenchEntry> reg;
+    return reg;
+    }
+
+struct BenchRegistrar
+    {
+    BenchRegistrar(std::string name, BenchFunc f)
+        {
+        benchRegistry().push_back({name,f});
+        }
+    };
+
+#define BENCH_CONCAT_(a,b) a##b
+#define BENCH_CONCAT(a,b) BENCH_CONCAT_(a,b)
+#define BENCH(NAME) \
+    static void NAME(itensor::BenchState&); \
+    static itensor::BenchRegistrar BENCH_CONCAT(bench_registrar_,NAME)(#NAME,NAME); \
+    static void NAME(itensor::BenchState& state)
+
+//Keep the compiler from optimizing away a result
+template<typename T>
+void
+doNotOptimize(T const& val)
+    {
+    asm volatile("" : : "r,m"(val) : "memory");
+    }
+
+struct BenchResult
+    {
+    std::string name;
+    long iterations = 0;
+    double real_time = 0., //per iteration, in ms
+           cpu_time = 0.;
+    std::map<std::string,double> counters;
+    };
+
+inline int
+runBenchmarks(int argc, char* argv[])
+    {
+    auto filter = std::string(".*");
+    auto out = std::string();
+    auto outformat = std::string("console");
+    auto min_time = 0.5;
+    auto reps = 1;
+    auto list = false;
+    for(int n = 1; n < argc; ++n)
+        {
+        auto arg = std::string(argv[n]);
+        auto val = [&arg](std::string const& flag) -> std::string
+            {
+            auto f = "--"+flag+"=";
+            if(arg.compare(0,f.size(),f) == 0) return arg.substr(f.size());
+            return "";
+            };
+        if(!val("benchmark_filter").empty()) filter = val("benchmark_filter");
+        else if(!val("benchmark_out").empty()) out = val("benchmark_out");
+        else if(!val("benchmark_format").empty()) outformat = val("benchmark_format");
+        else if(!val("benchmark_min_time").empty()) min_time = std::stod(val("benchmark_min_time"));
+        else if(!val("benchmark_repetitions").empty()) reps = std::stoi(val("benchmark_repetitions"));
+        else if(arg == "--benchmark_list_tests") list = true;
+        else
+            {
+            printfln("Unrecognized argument %s",arg);
+            return 1;
+            }
+        }
+
+    auto re = std::regex(filter);
+    auto results = std::vector<BenchResult>();
+    for(auto& B : benchRegistry())
+        {
+        if(!std::regex_search(B.name,re)) continue;
+        if(list) { println(B.name); continue; }
+        for(auto r = 0; r < reps; ++r)
+            {
+            //Grow the iteration count until the
+            //timed region takes at least min_time
+            long iters = 1;
+            while(true)
+                {
+                auto state = BenchState(iters);
+                B.func(state);
+                if(state.wallTime() >= min_time || iters >= 1000000000l)
+                    {
+                    auto res = BenchResult{};
+                    res.name = B.name;
+                    if(reps > 1) res.name += format("/repeat:%d",r);
+                    res.iterations = iters;
+                    res.real_time = 1E3*state.wallTime()/iters;
+                    res.cpu_time = 1E3*state.cpuTime()/iters;
+                    res.counters = state.counters;
+                    if(outformat == "console")
+                        {
+                        printf("%-40s %12.4f ms %12.4f ms %10d",res.name,res.real_time,res.cpu_time,iters);
+                        for(auto& c : res.counters) printf("  %s=%.4g",c.first,c.second);
+                        println();
+                        }
+                    results.push_back(res);
+                    break;
+                    }
+                auto t = std::max(state.wallTime(),1E-9);
+                auto grow = std::min(10.,std::max(1.5,1.4*min_time/t));
+                iters = std::max(iters+1,long(iters*grow));
+                }
+            }
+        }
+
+    auto writeJSON = [&results](std::ostream & s)
+        {
+        auto t = std::time(nullptr);
+        char date[64];
+        std::strftime(date,sizeof(date),"%Y-%m-%dT%H:%M:%S",std::localtime(&t));
+        s << "{\n  \"context\": {\n    \"date\": \"" << date << "\",\n"
+          << "    \"library\": \"itensor\"\n  },\n  \"benchmarks\": [";
+        for(auto j = 0ul; j < results.size(); ++j)
+            {
+            auto& r = results[j];
+            s << (j > 0 ? ",\n" : "\n");
+            s << "    {\"name\": \"" << r.name << "\", \"run_type\": \"iteration\""
+              << ", \"iterations\": " << r.iterations
+              << ", \"real_time\": " << r.real_time
+              << ", \"cpu_time\": " << r.cpu_time
+              << ", \"time_unit\": \"ms\"";
+            for(auto& c : r.counters) s << ", \"" << c.first << "\": " << c.second;
+            s << "}";
+            }
+        s << "\n  ]\n}\n";
+        };
+
+    if(outformat == "json" && out.empty()) writeJSON(std::cout);
+    if(!out.empty())
+        {
+        std::ofstream f(out);
+        if(!f.is_open())
+            {
+            printfln("Could not open output file %s",out);
+            return 1;
+            }
+        writeJSON(f);
+        }
+    return 0;
+    }
+
+} //namespace itensor
+
+#endif
@@ -0,0 +1,520 @@
+//
+// Copyright 2018 The Simons Foundation, Inc. - All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "itensor/all.h"
+#include "bench.h"
+
+using namespace itensor;
+
+//
+// MPS/MPO algorithm benchmarks: davidson, DMRG sweeps,
+// applyMPO and toMPO
+//
+// Expensive setup (warming up a state to its target bond
+// dimension) is cached in function-local statics, since the
+// runner may call each benchmark several times while
+// calibrating the iteration count.
+//
+
+namespace {
+
+int const N = 40;
+
+MPO
+heisenbergMPO(SpinHalf const& sites)
+    {
+    auto ampo = AutoMPO(sites);
+    for(auto j : range1(length(sites)-1))
+        {
+        ampo += 0.5,"S+",j,"S-",j+1;
+        ampo += 0.5,"S-",j,"S+",j+1;
+        ampo +=     "Sz",j,"Sz",j+1;
+        }
+    return toMPO(ampo);
+    }
+
+MPO
+hubbardMPO(Electron const& sites, Real U = 4.)
+    {
+    auto ampo = AutoMPO(sites);
+    for(auto j : range1(length(sites)))
+        {
+        ampo += U,"Nupdn",j;
+        }
+    for(auto b : range1(length(sites)-1))
+        {
+        ampo += -1.,"Cdagup",b,"Cup",b+1;
+        ampo += -1.,"Cdagup",b+1,"Cup",b;
+        ampo += -1.,"Cdagdn",b,"Cdn",b+1;
+        ampo += -1.,"Cdagdn",b+1,"Cdn",b;
+        }
+    return toMPO(ampo);
+    }
+
+//Long-range model with O(N^2) terms, typical of
+//2D cylinders or quantum chemistry style Hamiltonians
+AutoMPO
+longRangeAutoMPO(SpinHalf const& sites)
+    {
+    auto ampo = AutoMPO(sites);
+    auto L = length(sites);
+    for(auto i : range1(L))
+    for(auto j : range1(i+1,L))
+        {
+        auto J = 1./((j-i)*(j-i));
+        ampo += 0.5*J,"S+",i,"S-",j;
+        ampo += 0.5*J,"S-",i,"S+",j;
+        ampo +=     J,"Sz",i,"Sz",j;
+        }
+    return ampo;
+    }
+
+template<typename SiteSetT>
+MPS
+neelState(SiteSetT const& sites, std::string const& up, std::string const& dn)
+    {
+    auto state = InitState(sites);
+    for(auto j : range1(length(sites)))
+        {
+        state.set(j,j%2==1 ? up : dn);
+        }
+    return MPS(state);
+    }
+
+//Ground state of H warmed up to bond dimension maxdim
+MPS
+warmup(MPO const& H, MPS psi, int maxdim)
+    {
+    auto sweeps = Sweeps(4);
+    sweeps.maxdim() = 20,maxdim/2,maxdim;
+    sweeps.cutoff() = 1E-12;
+    sweeps.noise() = 1E-8,0.;
+    dmrg(psi,H,sweeps,{"Quiet=",true,"Silent=",true});
+    return psi;
+    }
+
+struct HeisenbergFixture
+    {
+    SpinHalf sites;
+    MPO H;
+    MPS psi;
+    HeisenbergFixture()
+        {
+        sites = SpinHalf(N,{"ConserveQNs=",true});
+        H = heisenbergMPO(sites);
+        psi = warmup(H,neelState(sites,"Up","Dn"),100);
+        }
+    };
+
+HeisenbergFixture const&
+heisenberg()
+    {
+    static auto F = HeisenbergFixture{};
+    return F;
+    }
+
+struct HubbardFixture
+    {
+    Electron sites;
+    MPO H;
+    MPS psi;
+    HubbardFixture()
+        {
+        sites = Electron(N/2,{"ConserveQNs=",true});
+        H = hubbardMPO(sites);
+        psi = warmup(H,neelState(sites,"Up","Dn"),100);
+        }
+    };
+
+HubbardFixture const&
+hubbard()
+    {
+    static auto F = HubbardFixture{};
+    return F;
+    }
+
+struct LongRangeFixture
+    {
+    SpinHalf sites;
+    MPO H;
+    MPS psi;
+    LongRangeFixture()
+        {
+        sites = SpinHalf(N,{"ConserveQNs=",true});
+        auto ampo = longRangeAutoMPO(sites);
+        //Without the SVD compression W[j] keeps
+        //the sparsity of the AutoMPO terms
+        H = toMPO(ampo,{"Exact=",true});
+        psi = warmup(toMPO(ampo),neelState(sites,"Up","Dn"),60);
+        }
+    };
+
+LongRangeFixture const&
+longRange()
+    {
+    static auto F = LongRangeFixture{};
+    return F;
+    }
+
+}
+
+//Single local eigensolve at the center bond
+//of a Heisenberg chain at m=100
+BENCH(Davidson_Heisenberg_m100)
+    {
+    auto& F = heisenberg();
+    auto psi = F.psi;
+    auto b = N/2;
+    psi.position(b);
+    auto PH = LocalMPO(F.H);
+    PH.position(b,psi);
+    auto phi0 = psi(b)*psi(b+1);
+    while(state.keepRunning())
+        {
+        auto phi = phi0;
+        auto E = davidson(PH,phi,{"MaxIter=",2,"ErrGoal=",1E-14});
+        doNotOptimize(E);
+        }
+    }
+
+//Local eigensolve at the center bond of a Heisenberg
+//chain at m=100, projecting out four lower states
+BENCH(DavidsonExcited_Heisenberg_m100)
+    {
+    auto& F = heisenberg();
+    //Lower states with the bond dimension of psi:
+    //psi with Sz applied at different sites
+    static auto psis = [&F]()
+        {
+        auto states = std::vector<MPS>(4);
+        for(auto n : range(states))
+            {
+            auto j = 4+8*n;
+            auto& p = states[n];
+            p = F.psi;
+            p.position(j);
+            p.ref(j) = noPrime(p(j)*op(F.sites,"Sz",j));
+            p.normalize();
+            }
+        return states;
+        }();
+    auto psi = F.psi;
+    auto b = N/2;
+    psi.position(b);
+    auto PH = LocalMPO_MPS(F.H,psis,{"Weight=",20.});
+    PH.position(b,psi);
+    auto phi0 = psi(b)*psi(b+1);
+    while(state.keepRunning())
+        {
+        auto phi = phi0;
+        auto E = davidson(PH,phi,{"MaxIter=",2,"ErrGoal=",1E-14});
+        doNotOptimize(E);
+        }
+    }
+
+//Matrix-vector products at the center bond of the
+//long-range chain, whose MPO has mostly zero entries
+BENCH(LocalMPOProduct_LongRange)
+    {
+    auto& F = longRange();
+    auto psi = F.psi;
+    auto b = N/2;
+    psi.position(b);
+    auto PH = LocalMPO(F.H);
+    PH.position(b,psi);
+    auto phi = psi(b)*psi(b+1);
+    while(state.keepRunning())
+        {
+        ITensor phip;
+        PH.product(phi,phip);
+        doNotOptimize(phip);
+        }
+    state.counters["k"] = dim(linkIndex(F.H,b));
+    }
+
+BENCH(LocalMPOProductFused_LongRange)
+    {
+    auto& F = longRange();
+    auto psi = F.psi;
+    auto b = N/2;
+    psi.position(b);
+    auto PH = LocalMPO(F.H,{"FuseOps=",true});
+    PH.position(b,psi);
+    auto phi = psi(b)*psi(b+1);
+    while(state.keepRunning())
+        {
+        ITensor phip;
+        PH.product(phi,phip);
+        doNotOptimize(phip);
+        }
+    }
+
+BENCH(LocalSparseMPOProduct_LongRange)
+    {
+    auto& F = longRange();
+    auto psi = F.psi;
+    auto b = N/2;
+    psi.position(b);
+    auto SH = SparseMPO(F.H);
+    auto PH = LocalSparseMPO(SH);
+    PH.position(b,psi);
+    auto phi = psi(b)*psi(b+1);
+    while(state.keepRunning())
+        {
+        ITensor phip;
+        PH.product(phi,phip);
+        doNotOptimize(phip);
+        }
+    state.counters["nnz"] = SH.terms(b).size()+SH.terms(b+1).size();
+    }
+
+//Local eigensolves at the center bond of the long-range
+//chain, applying L,W[b],W[b+1],R in turn or with the
+//fused tensors of FuseOps (including the time to fuse)
+void
+davidsonLongRange(BenchState & state, Args const& args)
+    {
+    auto& F = longRange();
+    auto psi = F.psi;
+    auto b = N/2;
+    psi.position(b);
+    auto phi0 = psi(b)*psi(b+1);
+    while(state.keepRunning())
+        {
+        auto PH = LocalMPO(F.H,args);
+        PH.position(b,psi);
+        auto phi = phi0;
+        auto E = davidson(PH,phi,{"MaxIter=",2,"ErrGoal=",1E-14});
+        doNotOptimize(E);
+        }
+    }
+
+BENCH(Davidson_LongRange)
+    {
+    davidsonLongRange(state,{});
+    }
+
+BENCH(DavidsonFused_LongRange)
+    {
+    davidsonLongRange(state,{"FuseOps=",true});
+    }
+
+BENCH(DMRGSweep_Heisenberg_m100)
+    {
+    auto& F = heisenberg();
+    auto sweeps = Sweeps(1);
+    sweeps.maxdim() = 100;
+    sweeps.cutoff() = 1E-12;
+    sweeps.niter() = 2;
+    while(state.keepRunning())
+        {
+        state.pauseTiming();
+        auto psi = F.psi;
+        state.resumeTiming();
+        auto E = dmrg(psi,F.H,sweeps,{"Quiet=",true,"Silent=",true});
+        doNotOptimize(E);
+        }
+    }
+
+BENCH(DMRGSweep_Hubbard_m100)
+    {
+    auto& F = hubbard();
+    auto sweeps = Sweeps(1);
+    sweeps.maxdim() = 100;
+    sweeps.cutoff() = 1E-12;
+    sweeps.niter() = 2;
+    while(state.keepRunning())
+        {
+        state.pauseTiming();
+        auto psi = F.psi;
+        state.resumeTiming();
+        auto E = dmrg(psi,F.H,sweeps,{"Quiet=",true,"Silent=",true});
+        doNotOptimize(E);
+        }
+    }
+
+//Move the orthogonality center across the whole
+//chain and back, with QR and with the svd
+BENCH(Position_Heisenberg_m100)
+    {
+    auto& F = heisenberg();
+    auto psi = F.psi;
+    psi.position(1);
+    while(state.keepRunning())
+        {
+        psi.position(N);
+        psi.position(1);
+        }
+    }
+
+BENCH(PositionSVD_Heisenberg_m100)
+    {
+    auto& F = heisenberg();
+    auto psi = F.psi;
+    psi.position(1);
+    while(state.keepRunning())
+        {
+        psi.position(N,{"UseSVD=",true});
+        psi.position(1,{"UseSVD=",true});
+        }
+    }
+
+//Relabeling the indices of every tensor of an MPS and an MPO
+BENCH(TagOps_Heisenberg_m100)
+    {
+    auto& F = heisenberg();
+    while(state.keepRunning())
+        {
+        auto psi = F.psi;
+        psi.replaceTags("Site","x");
+        psi.addTags("a","Link");
+        psi.removeTags("a","Link");
+        auto H = F.H;
+        H.replaceTags("Site","x");
+        H.prime("Link");
+        doNotOptimize(psi);
+        doNotOptimize(H);
+        }
+    }
+
+//Options written by DMRGWorker and read by davidson
+//and svd at each bond of a 100 site sweep
+BENCH(ArgsLookup_DMRGBonds)
+    {
+    auto args = Args("Quiet",true,"RespectDegenerate",true,"DebugLevel",0,
+                     "DoNormalize",true,"Sweep",1,"NSweep",5,"Cutoff",1E-10,
+                     "MinDim",1,"MaxDim",100,"Noise",0.,"MaxIter",2);
+    auto bonds = [&args]
+        {
+        auto sum = 0.;
+        for(auto b = 1; b < 100; ++b)
+            {
+            args.add(keys::AtBond,b);
+            args.add(keys::HalfSweep,1);
+            args.add(keys::Energy,-0.4*b);
+            args.add(keys::Truncerr,1E-12);
+            sum += args.getSizeT(keys::MaxIter,2)+args.getSizeT(keys::MinIter,1)
+                 + args.getReal(keys::ErrGoal,1E-14)+args.getInt(keys::DebugLevel,-1);
+            sum += args.defined(keys::Minm)+args.defined(keys::Maxm)
+                 + args.getBool(keys::Truncate,true)+args.getReal(keys::Cutoff,1E-14)
+                 + args.getInt(keys::MaxDim,1000)+args.getInt(keys::MinDim,1)
+                 + args.getBool(keys::DoRelCutoff,true)+args.getBool(keys::AbsoluteCutoff,false)
+                 + args.getBool(keys::ShowEigs,false)+args.getBool(keys::RespectDegenerate,false);
+            }
+        return sum;
+        };
+    while(state.keepRunning())
+        {
+        doNotOptimize(bonds());
+        }
+    argsResetStats();
+    argsProfile(true);
+    bonds();
+    argsProfile(false);
+    auto S = argsStats();
+    state.counters["lookups"] = S.lookups+S.keyed;
+    state.counters["slot_hits"] = S.slotHits;
+    }
+
+//100 samples drawn as one batch and one at a time
+BENCH(Sample_Heisenberg_m100)
+    {
+    auto& F = heisenberg();
+    while(state.keepRunning())
+        {
+        auto res = sample(F.psi,100,{"Seed=",1,"BatchSize=",100});
+        doNotOptimize(res);
+        }
+    }
+
+BENCH(SampleUnbatched_Heisenberg_m100)
+    {
+    auto& F = heisenberg();
+    while(state.keepRunning())
+        {
+        auto res = sample(F.psi,100,{"Seed=",1,"BatchSize=",1});
+        doNotOptimize(res);
+        }
+    }
+
+BENCH(ApplyMPO_DensityMatrix)
+    {
+    auto& F = heisenberg();
+    while(state.keepRunning())
+        {
+        auto Hpsi = applyMPO(F.H,F.psi,{"Method=","DensityMatrix","MaxDim=",200,"Cutoff=",1E-10});
+        doNotOptimize(Hpsi);
+        }
+    }
+
+BENCH(ApplyMPO_Fit)
+    {
+    auto& F = heisenberg();
+    while(state.keepRunning())
+        {
+        auto Hpsi = applyMPO(F.H,F.psi,{"Method=","Fit","MaxDim=",200,"Cutoff=",1E-10,"Nsweep=",2});
+        doNotOptimize(Hpsi);
+        }
+    }
+
+BENCH(ToMPO_LongRange)
+    {
+    auto sites = SpinHalf(N,{"ConserveQNs=",true});
+    auto ampo = longRangeAutoMPO(sites);
+    while(state.keepRunning())
+        {
+        auto H = toMPO(ampo);
+        doNotOptimize(H);
+        }
+    state.counters["maxLinkDim"] = maxLinkDim(toMPO(ampo));
+    }
+
+BENCH(ToMPOOnDisk_LongRange)
+    {
+    auto sites = SpinHalf(N,{"ConserveQNs=",true});
+    auto ampo = longRangeAutoMPO(sites);
+    while(state.keepRunning())
+        {
+        auto H = toMPO(ampo,{"WriteToDisk=",true});
+        doNotOptimize(H);
+        }
+    }
+
+//Moves a LocalMPO of the exact long-range MPO right
+//and back across the chain, building all edge tensors
+void
+sweepLongRange(BenchState & state, MPO const& H)
+    {
+    auto& F = longRange();
+    while(state.keepRunning())
+        {
+        auto PH = LocalMPO(H);
+        for(auto b : range1(N-1)) PH.position(b,F.psi);
+        for(auto b = N-1; b >= 1; --b) PH.position(b,F.psi);
+        doNotOptimize(PH);
+        }
+    }
+
+BENCH(LocalMPOSweep_LongRange)
+    {
+    sweepLongRange(state,longRange().H);
+    }
+
+BENCH(LocalMPOSweepOnDisk_LongRange)
+    {
+    static auto Hd = toMPO(longRangeAutoMPO(longRange().sites),
+                           {"Exact=",true,"WriteToDisk=",true});
+    sweepLongRange(state,Hd);
+    }
@@ -0,0 +1,346 @@
+//
+// Copyright 2018 The Simons Foundation, Inc. - All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include <future>
+#include "itensor/all.h"
+#include "bench.h"
+
+using namespace itensor;
+
+//
+// Core kernel benchmarks: dense and block-sparse
+// contraction, permutation, complex gemm and QN SVD,
+// and the index bookkeeping of small contractions
+//
+
+namespace {
+
+//Link index of total dimension m split into
+//nsector Sz sectors of (nearly) equal size
+Index
+qnLink(int m, int nsector, std::string const& tags)
+    {
+    auto qns = Index::qnstorage{};
+    auto q0 = -(nsector-1);
+    for(auto n : range(nsector))
+        {
+        auto size = m/nsector + (n < m%nsector ? 1 : 0);
+        qns.emplace_back(QN({"Sz",q0+2*n}),size);
+        }
+    return Index(std::move(qns),tags);
+    }
+
+Index
+qnSite(std::string const& tags)
+    {
+    return Index(QN({"Sz",+1}),1,
+                 QN({"Sz",-1}),1,tags);
+    }
+
+}
+
+//Two-site wavefunction times left environment,
+//the leading contraction of a DMRG matvec (m=200, k=5, d=2)
+BENCH(DenseContract_DMRGEnv)
+    {
+    auto m = 200, k = 5, d = 2;
+    auto l = Index(m,"Link,l"),
+         r = Index(m,"Link,r"),
+         s1 = Index(d,"Site,1"),
+         s2 = Index(d,"Site,2"),
+         w = Index(k,"Link,w");
+    auto L = randomITensor(l,prime(l),w);
+    auto phi = randomITensor(l,s1,s2,r);
+    while(state.keepRunning())
+        {
+        auto R = phi*L;
+        doNotOptimize(R);
+        }
+    state.counters["flops"] = 2.*m*m*k*d*d*m;
+    }
+
+//Two-site wavefunction times two MPO tensors
+BENCH(DenseContract_DMRGMPO)
+    {
+    auto m = 200, k = 5, d = 2;
+    auto l = Index(m,"Link,l"),
+         r = Index(m,"Link,r"),
+         s1 = Index(d,"Site,1"),
+         s2 = Index(d,"Site,2"),
+         w1 = Index(k,"Link,w1"),
+         w2 = Index(k,"Link,w2"),
+         w3 = Index(k,"Link,w3");
+    auto Lphi = randomITensor(prime(l),w1,s1,s2,r);
+    auto W1 = randomITensor(w1,s1,prime(s1),w2);
+    auto W2 = randomITensor(w2,s2,prime(s2),w3);
+    while(state.keepRunning())
+        {
+        auto R = Lphi*W1;
+        R *= W2;
+        doNotOptimize(R);
+        }
+    }
+
+BENCH(Permute_Order4)
+    {
+    auto m = 100, d = 4;
+    auto a = Index(m,"a"),
+         b = Index(d,"b"),
+         c = Index(d,"c"),
+         e = Index(m,"e");
+    auto T = randomITensor(a,b,c,e);
+    while(state.keepRunning())
+        {
+        auto P = permute(T,e,c,a,b);
+        doNotOptimize(P);
+        }
+    }
+
+BENCH(ComplexGemm_512)
+    {
+    auto n = 512;
+    auto A = randomMatC(n,n);
+    auto B = randomMatC(n,n);
+    auto C = CMatrix(n,n);
+    while(state.keepRunning())
+        {
+        mult(A,B,C);
+        doNotOptimize(C);
+        }
+    state.counters["flops"] = 8.*n*n*n;
+    }
+
+BENCH(ComplexContract_DMRGEnv)
+    {
+    auto m = 150, k = 5, d = 2;
+    auto l = Index(m,"Link,l"),
+         r = Index(m,"Link,r"),
+         s1 = Index(d,"Site,1"),
+         s2 = Index(d,"Site,2"),
+         w = Index(k,"Link,w");
+    auto L = randomITensorC(l,prime(l),w);
+    auto phi = randomITensorC(l,s1,s2,r);
+    while(state.keepRunning())
+        {
+        auto R = phi*L;
+        doNotOptimize(R);
+        }
+    }
+
+//Block-sparse contraction where every sector has
+//dimension 1, so that block lookups dominate
+BENCH(QDenseContract_TinyBlocks)
+    {
+    auto m = 101, nsector = 101, k = 3;
+    auto l = qnLink(m,nsector,"Link,l"),
+         r = qnLink(m,nsector,"Link,r"),
+         s1 = qnSite("Site,1"),
+         s2 = qnSite("Site,2"),
+         w = Index(QN({"Sz",0}),k,"Link,w");
+    auto L = randomITensor(QN({"Sz",0}),dag(l),prime(l),w);
+    auto phi = randomITensor(QN({"Sz",0}),l,s1,s2,r);
+    while(state.keepRunning())
+        {
+        auto R = phi*L;
+        doNotOptimize(R);
+        }
+    state.counters["nblocks"] = nnzblocks(phi);
+    }
+
+//Singular values times a block-sparse tensor,
+//as in forming U*S after a QN svd
+BENCH(QDiagContract_ManyBlocks)
+    {
+    auto m = 400, nsector = 21;
+    auto l = qnLink(m,nsector,"Link,l"),
+         r = qnLink(m,nsector,"Link,r"),
+         s1 = qnSite("Site,1"),
+         s2 = qnSite("Site,2");
+    auto Dis = IndexSet(dag(l),prime(l));
+    auto D = ITensor(Dis,QDiagReal(Dis));
+    D.generate([]() { return Global::random(); });
+    auto V = randomITensor(QN({"Sz",0}),l,s1,s2,r);
+    while(state.keepRunning())
+        {
+        auto R = D*V;
+        doNotOptimize(R);
+        }
+    state.counters["nblocks"] = nnzblocks(V);
+    }
+
+//Block-sparse contraction with many QN sectors
+BENCH(QDenseContract_ManyBlocks)
+    {
+    auto m = 400, nsector = 21, k = 5;
+    auto l = qnLink(m,nsector,"Link,l"),
+         r = qnLink(m,nsector,"Link,r"),
+         s1 = qnSite("Site,1"),
+         s2 = qnSite("Site,2"),
+         w = Index(QN({"Sz",0}),k,"Link,w");
+    auto L = randomITensor(QN({"Sz",0}),dag(l),prime(l),w);
+    auto phi = randomITensor(QN({"Sz",0}),l,s1,s2,r);
+    while(state.keepRunning())
+        {
+        auto R = phi*L;
+        doNotOptimize(R);
+        }
+    state.counters["nblocks"] = nnzblocks(phi);
+    }
+
+BENCH(QNSVD_TwoSite)
+    {
+    auto m = 200, nsector = 15;
+    auto l = qnLink(m,nsector,"Link,l"),
+         r = qnLink(m,nsector,"Link,r"),
+         s1 = qnSite("Site,1"),
+         s2 = qnSite("Site,2");
+    auto phi = randomITensor(QN({"Sz",0}),l,s1,s2,r);
+    while(state.keepRunning())
+        {
+        auto [U,S,V] = svd(phi,{l,s1},{"MaxDim=",m,"Cutoff=",1E-12});
+        doNotOptimize(S);
+        }
+    }
+
+//Combine the left link and first site of a two-site
+//wavefunction (as svdBond and denmatDecomp do), then uncombine
+BENCH(QCombiner_TwoSite)
+    {
+    auto m = 400, nsector = 5;
+    auto l = qnLink(m,nsector,"Link,l"),
+         r = qnLink(m,nsector,"Link,r"),
+         s1 = qnSite("Site,1"),
+         s2 = qnSite("Site,2");
+    auto phi = randomITensor(QN({"Sz",0}),l,s1,s2,r);
+    auto [C,ci] = combiner(s1,l);
+    while(state.keepRunning())
+        {
+        auto phic = phi*C;
+        auto phiu = dag(C)*phic;
+        doNotOptimize(phiu);
+        }
+    }
+
+BENCH(DenseSVD_TwoSite)
+    {
+    auto m = 200, d = 2;
+    auto l = Index(m,"Link,l"),
+         r = Index(m,"Link,r"),
+         s1 = Index(d,"Site,1"),
+         s2 = Index(d,"Site,2");
+    auto phi = randomITensor(l,s1,s2,r);
+    while(state.keepRunning())
+        {
+        auto [U,S,V] = svd(phi,{l,s1},{"MaxDim=",m,"Cutoff=",1E-12});
+        doNotOptimize(S);
+        }
+    }
+
+//Singular values times U and V, as when
+//svdBond absorbs S into one of the factors
+BENCH(DiagScale_SVDBond)
+    {
+    auto m = 400, d = 2;
+    auto l = Index(m,"Link,l"),
+         r = Index(m,"Link,r"),
+         s1 = Index(d,"Site,1"),
+         s2 = Index(d,"Site,2"),
+         u = Index(d*m,"Link,u"),
+         v = Index(d*m,"Link,v");
+    auto U = randomITensor(l,s1,u);
+    auto V = randomITensor(v,s2,r);
+    auto Sv = std::vector<Real>(d*m);
+    for(auto& el : Sv) el = Global::random();
+    auto S = diagITensor(Sv,u,v);
+    while(state.keepRunning())
+        {
+        auto US = U*S;
+        auto SV = S*V;
+        doNotOptimize(US);
+        doNotOptimize(SV);
+        }
+    }
+
+//Contraction of small tensors sharing two of their five
+//indices, where matching up the indices is most of the cost
+BENCH(SmallContract_Order5)
+    {
+    auto i = std::vector<Index>();
+    for(auto n : range(8)) i.push_back(Index(2,"Link,l="+str(n)));
+    auto A = randomITensor(i[0],i[1],i[2],i[3],i[4]);
+    auto B = randomITensor(i[3],i[4],i[5],i[6],i[7]);
+    while(state.keepRunning())
+        {
+        auto C = A*B;
+        doNotOptimize(C);
+        }
+    }
+
+//Two-site gate applied to a two-site wavefunction with small
+//bonds, as in TEBD near a product state
+BENCH(SmallContract_Gate)
+    {
+    auto s1 = Index(2,"Site,1"),
+         s2 = Index(2,"Site,2"),
+         l = Index(4,"Link,l"),
+         r = Index(4,"Link,r");
+    auto G = randomITensor(s1,s2,prime(s1),prime(s2));
+    auto psi = randomITensor(l,s1,s2,r);
+    while(state.keepRunning())
+        {
+        auto phi = G*psi;
+        doNotOptimize(phi);
+        }
+    }
+
+//Index creation from several threads at once
+BENCH(IndexCreate_4Threads)
+    {
+    auto nthread = 4;
+    auto nindex = 100000;
+    while(state.keepRunning())
+        {
+        auto futs = std::vector<std::future<Index::id_type>>();
+        for(auto t = 0; t < nthread; ++t)
+            {
+            futs.push_back(std::async(std::launch::async,[nindex]()
+                {
+                Index::id_type x = 0;
+                for(auto n = 0; n < nindex; ++n) x ^= id(Index(2));
+                return x;
+                }));
+            }
+        for(auto& f : futs) doNotOptimize(f.get());
+        }
+    }
+
+//Set operations and contraction bookkeeping
+//on two order-10 IndexSets sharing five indices
+BENCH(IndexSetOps_Order10)
+    {
+    auto i = std::vector<Index>();
+    for(auto n : range(15)) i.push_back(Index(2,"Link,l="+str(n)));
+    auto is1 = IndexSet(std::vector<Index>(i.begin(),i.begin()+10));
+    auto is2 = IndexSet(std::vector<Index>(i.begin()+5,i.end()));
+    while(state.keepRunning())
+        {
+        auto Nis = IndexSet();
+        contractIS(is1,is2,Nis);
+        doNotOptimize(Nis);
+        doNotOptimize(commonInds(is1,is2));
+        doNotOptimize(uniqueInds(is1,is2));
+        doNotOptimize(hasInds(is1,is2));
+        }
+    }
@@ -0,0 +1,83 @@
+#!/usr/bin/env python3
+#
+# Compare two benchmark result files written by
+#
+#   ./itensor_bench --benchmark_out=<file>
+#
+# (or any file in the Google Benchmark JSON format).
+#
+# Usage:
+#
+#   python3 compare.py baseline.json contender.json [--threshold=0.05]
+#
+# Prints the relative change in real time and cpu time for each
+# benchmark present in both files. Exits with status 1 if any
+# benchmark slowed down by more than the threshold (default 5%),
+# so it can be used as a regression check in CI.
+#
+
+import json
+import sys
+
+
+def load(fname):
+    with open(fname) as f:
+        data = json.load(f)
+    res = {}
+    for b in data["benchmarks"]:
+        if b.get("run_type", "iteration") != "iteration":
+            continue
+        # Average over repetitions, which are named <name>/repeat:<n>
+        name = b["name"].split("/repeat:")[0]
+        unit = b.get("time_unit", "ns")
+        scale = {"ns": 1e-6, "us": 1e-3, "ms": 1.0, "s": 1e3}[unit]
+        rt, ct, n = res.get(name, (0.0, 0.0, 0))
+        res[name] = (rt + scale * b["real_time"], ct + scale * b["cpu_time"], n + 1)
+    return {k: (rt / n, ct / n) for k, (rt, ct, n) in res.items()}
+
+
+def main(argv):
+    threshold = 0.05
+    files = []
+    for a in argv[1:]:
+        if a.startswith("--threshold="):
+            threshold = float(a.split("=", 1)[1])
+        else:
+            files.append(a)
+    if len(files) != 2:
+        print("usage: compare.py baseline.json contender.json [--threshold=0.05]")
+        return 2
+
+    base = load(files[0])
+    new = load(files[1])
+
+    print("%-40s %12s %12s %9s %9s" % ("Benchmark", "Base (ms)", "New (ms)", "Time", "CPU"))
+    print("-" * 86)
+    regressed = []
+    for name in base:
+        if name not in new:
+            continue
+        brt, bct = base[name]
+        nrt, nct = new[name]
+        drt = (nrt - brt) / brt if brt > 0 else 0.0
+        dct = (nct - bct) / bct if bct > 0 else 0.0
+        flag = ""
+        if drt > threshold:
+            flag = "  <-- slower"
+            regressed.append(name)
+        elif drt < -threshold:
+            flag = "  faster"
+        print("%-40s %12.4f %12.4f %+8.1f%% %+8.1f%%%s" % (name, brt, nrt, 100 * drt, 100 * dct, flag))
+
+    for name in sorted(set(base) ^ set(new)):
+        where = files[0] if name in base else files[1]
+        print("%-40s only in %s" % (name, where))
+
+    if regressed:
+        print("\n%d benchmark(s) slower by more than %.0f%%" % (len(regressed), 100 * threshold))
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
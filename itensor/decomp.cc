@@ -125,42 +125,42 @@ svd(ITensor const& AA,
     ITensor & V,
     Args args)
     {
-    if( args.defined("Minm") )
+    if( args.defined(keys::Minm) )
       {
-      if( args.defined("MinDim") )
+      if( args.defined(keys::MinDim) )
         {
         Global::warnDeprecated("Args Minm and MinDim are both defined. Minm is deprecated in favor of MinDim, MinDim will be used.");
         }
       else
         {
         Global::warnDeprecated("Arg Minm is deprecated in favor of MinDim.");
-        args.add("MinDim",args.getInt("Minm"));
+        args.add(keys::MinDim,args.getInt(keys::Minm));
         }
       }
 
-    if( args.defined("Maxm") )
+    if( args.defined(keys::Maxm) )
       {
-      if( args.defined("MaxDim") )
+      if( args.defined(keys::MaxDim) )
         {
         Global::warnDeprecated("Args Maxm and MaxDim are both defined. Maxm is deprecated in favor of MaxDim, MaxDim will be used.");
         }
       else
         {
         Global::warnDeprecated("Arg Maxm is deprecated in favor of MaxDim.");
-        args.add("MaxDim",args.getInt("Maxm"));
+        args.add(keys::MaxDim,args.getInt(keys::Maxm));
         }
       }
 
-    if( args.defined("UseOrigM") )
+    if( args.defined(keys::UseOrigM) )
       {
-      if( args.defined("UseOrigDim") )
+      if( args.defined(keys::UseOrigDim) )
         {
         Global::warnDeprecated("Args UseOrigM and UseOrigDim are both defined. UseOrigM is deprecated in favor of UseOrigDim, UseOrigDim will be used.");
         }
       else
         {
         Global::warnDeprecated("Arg UseOrigM is deprecated in favor of UseOrigDim.");
-        args.add("UseOrigDim",args.getBool("UseOrigM"));
+        args.add(keys::UseOrigDim,args.getBool(keys::UseOrigM));
         }
       }
 
@@ -169,8 +169,8 @@ svd(ITensor const& AA,
         Error("U and V default-initialized in svd, must indicate at least one index on U or V");
 #endif
 
-    auto noise = args.getReal("Noise",0);
-    auto useOrigDim = args.getBool("UseOrigDim",false);
+    auto noise = args.getReal(keys::Noise,0);
+    auto useOrigDim = args.getBool(keys::UseOrigDim,false);
 
     if(noise > 0)
         Error("Noise term not implemented for svd");
@@ -217,7 +217,7 @@ svd(ITensor const& AA,
         {
         //Try to determine current m,
         //then set mindim_ and maxdim_ to this.
-        args.add("Cutoff",-1);
+        args.add(keys::Cutoff,-1);
         long mindim = 1,
              maxdim = MAX_DIM;
         if(D.order() == 0)
@@ -232,8 +232,8 @@ svd(ITensor const& AA,
             {
             mindim = maxdim = dim(D.inds().front());
             }
-        args.add("MinDim",mindim);
-        args.add("MaxDim",maxdim);
+        args.add(keys::MinDim,mindim);
+        args.add(keys::MaxDim,maxdim);
         }
 
     //auto ui = commonIndex(AAcomb,Ucomb);
@@ -312,7 +312,7 @@ truncate(Vector & P,
          bool doRelCutoff,
          Args const& args)
     {
-    auto respectDegenerate = args.getBool("RespectDegenerate",false);
+    auto respectDegenerate = args.getBool(keys::RespectDegenerate,false);
 
     long origm = P.size();
     long n = origm-1;
@@ -468,38 +468,38 @@ showEigs(Vector const& P,
          LogNum const& scale,
          Args args)
     {
-    if( args.defined("Minm") )
+    if( args.defined(keys::Minm) )
       {
-      if( args.defined("MinDim") )
+      if( args.defined(keys::MinDim) )
         {
         Global::warnDeprecated("Args Minm and MinDim are both defined. Minm is deprecated in favor of MinDim, MinDim will be used.");
         }
       else
         {
         Global::warnDeprecated("Arg Minm is deprecated in favor of MinDim.");
-        args.add("MinDim",args.getInt("Minm"));
+        args.add(keys::MinDim,args.getInt(keys::Minm));
         }
       }
 
-    if( args.defined("Maxm") )
+    if( args.defined(keys::Maxm) )
       {
-      if( args.defined("MaxDim") )
+      if( args.defined(keys::MaxDim) )
         {
         Global::warnDeprecated("Args Maxm and MaxDim are both defined. Maxm is deprecated in favor of MaxDim, MaxDim will be used.");
         }
       else
         {
         Global::warnDeprecated("Arg Maxm is deprecated in favor of MaxDim.");
-        args.add("MaxDim",args.getInt("Maxm"));
+        args.add(keys::MaxDim,args.getInt(keys::Maxm));
         }
       }
 
-    auto do_truncate = args.getBool("Truncate",true);
-    auto cutoff = args.getReal("Cutoff",0.);
-    auto maxdim = args.getInt("MaxDim",P.size());
-    auto mindim = args.getInt("MinDim",1);
-    auto doRelCutoff = args.getBool("DoRelCutoff",true);
-    auto absoluteCutoff = args.getBool("AbsoluteCutoff",false);
+    auto do_truncate = args.getBool(keys::Truncate,true);
+    auto cutoff = args.getReal(keys::Cutoff,0.);
+    auto maxdim = args.getInt(keys::MaxDim,P.size());
+    auto mindim = args.getInt(keys::MinDim,1);
+    auto doRelCutoff = args.getBool(keys::DoRelCutoff,true);
+    auto absoluteCutoff = args.getBool(keys::AbsoluteCutoff,false);
 
     println();
     printfln("mindim = %d, maxdim = %d, cutoff = %.2E, truncate = %s",mindim,maxdim,cutoff,do_truncate);
@@ -802,7 +802,7 @@ diagHermitian(ITensor const& M,
               ITensor      & D,
               Args args)
     {
-    args.add("Truncate",false);
+    args.add(keys::Truncate,false);
     return diagPosSemiDef(M,U,D,args);
     }
 
@@ -924,20 +924,18 @@ expHermitian(ITensor const& T, Cplx t)
     return prime(U)*d*dag(U);
     }
 
+//Combine the indices of AA found on Q (or on R, if Q
+//is default-constructed) into qi and the rest into ri
 void
-qr(ITensor const& AA,
-    ITensor & Q,
-	  ITensor & R,
-    Args args)
+combineForQR(ITensor const& AA,
+             ITensor const& Q,
+             ITensor const& R,
+             ITensor & AAcomb,
+             ITensor & Qcomb,
+             ITensor & Rcomb,
+             Index & qi,
+             Index & ri)
     {
-
-#ifdef DEBUG
-    if(!Q && !R)
-        Error("Q and R default-initialized in qr, must indicate at least one index on Q or R");
-#endif
-    
-    //Combiners which transform AA
-    //into a order 2 tensor
     std::vector<Index> Qinds,
                        Rinds;
     Qinds.reserve(AA.order());
@@ -952,12 +950,8 @@ qr(ITensor const& AA,
         if(hasIndex(A,I)) Ainds.push_back(I);
         else              Binds.push_back(I);
         }
-    ITensor Qcomb,
-            Rcomb;
-    Index qi,
-          ri;
 
-    auto AAcomb = AA;
+    AAcomb = AA;
     if(!Qinds.empty())
         {
         std::tie(Qcomb,qi) = combiner(std::move(Qinds));
@@ -968,6 +962,26 @@ qr(ITensor const& AA,
         std::tie(Rcomb,ri) = combiner(std::move(Rinds));
         AAcomb *= Rcomb;
         }
+    }
+
+void
+qr(ITensor const& AA,
+    ITensor & Q,
+	  ITensor & R,
+    Args args)
+    {
+
+#ifdef DEBUG
+    if(!Q && !R)
+        Error("Q and R default-initialized in qr, must indicate at least one index on Q or R");
+#endif
+    
+    ITensor AAcomb,
+            Qcomb,
+            Rcomb;
+    Index qi,
+          ri;
+    combineForQR(AA,Q,R,AAcomb,Qcomb,Rcomb,qi,ri);
     
     qrOrd2(AAcomb,qi,ri,Q,R,args);
 
@@ -1173,6 +1187,218 @@ qrImpl(ITensor const& A,
 	}
     }
         
+template<typename T>
+Spectrum
+rrqrImpl(ITensor const& A,
+         Index const& qI, 
+         Index const& rI,
+         ITensor & Q,
+         ITensor & R,
+         Args const& args)
+    {
+    auto do_truncate = args.getBool(keys::Truncate);
+    auto cutoff = args.getReal(keys::Cutoff,MIN_CUT);
+    auto maxdim = args.getInt(keys::MaxDim,MAX_DIM);
+    auto mindim = args.getInt(keys::MinDim,1);
+    auto doRelCutoff = args.getBool(keys::DoRelCutoff,true);
+    auto absoluteCutoff = args.getBool(keys::AbsoluteCutoff,false);
+    auto tags = getTagSet(args,"Tags","Link,QR");
+
+    //A dense tensor is treated as a single block
+    auto blocks = std::vector<Ord2Block<T>>{};
+    if(hasQNs(A))
+        {
+        blocks = doTask(GetBlocks<T>{A.inds(),qI,rI},A.store());
+        }
+    else
+        {
+        blocks.push_back({toMatRefc<T>(A,qI,rI),0,0});
+        }
+    auto Nblock = blocks.size();
+    if(Nblock == 0) throw ResultIsZero("IQTensor has no blocks");
+
+    auto Qmats = vector<Mat<T>>(Nblock);
+    auto Rmats = vector<Mat<T>>(Nblock);
+    //Squared norms of the rows of each R, made non-increasing
+    //by replacing each by the largest weight of the rows after it
+    auto weights = vector<Vector>(Nblock);
+    auto allw = stdx::reserve_vector<Real>(std::min(dim(qI),dim(rI)));
+    Real totalw = 0;
+
+    for(auto b : range(Nblock))
+        {
+        auto& M = blocks[b].M;
+        auto& QQ = Qmats.at(b);
+        auto& RR = Rmats.at(b);
+        //Without truncation the order of the rows of R
+        //does not matter, so only wide blocks (which
+        //plain QR does not handle as well) are pivoted
+        if(do_truncate || ncols(M) > nrows(M)) pivotedQR(M,QQ,RR);
+        else                                   QR(M,QQ,RR,{"Complete=",false});
+
+        auto& w = weights.at(b);
+        w = Vector(nrows(RR));
+        for(auto i : range(nrows(RR)))
+            {
+            Real wi = 0;
+            for(auto j : range(ncols(RR))) wi += std::norm(RR(i,j));
+            w(i) = wi;
+            totalw += wi;
+            }
+        for(long i = long(w.size())-2; i >= 0; --i) w(i) = std::max(w(i),w(i+1));
+        allw.insert(allw.end(),w.begin(),w.end());
+        }
+
+    stdx::sort(allw,std::greater<Real>{});
+    auto probs = Vector(move(allw),VecRange{allw.size()});
+
+    long m = probs.size();
+    Real docut_lower = -1;
+    Real docut_upper = -1;
+    int ndegen = 1;
+    if(do_truncate)
+        {
+        tie(std::ignore,docut_lower,docut_upper,ndegen) = truncate(probs,maxdim,mindim,cutoff,
+                                                                   absoluteCutoff,doRelCutoff,args);
+        m = probs.size();
+        }
+
+    //Decide how many leading rows of R to keep in each block,
+    //as svd does for the singular values of each block
+    auto keep = vector<long>(Nblock,0);
+    auto Liq = Index::qnstorage{};
+    Liq.reserve(Nblock);
+    Real discarded = 0;
+    long total_m = 0;
+    for(auto b : range(Nblock))
+        {
+        auto& w = weights.at(b);
+        long this_m = w.size();
+        if(do_truncate)
+            {
+            this_m = 0;
+            while(this_m < long(w.size()) && total_m < m && w(this_m) > docut_upper)
+                {
+                ++this_m;
+                ++total_m;
+                }
+            while(ndegen > 0 && this_m < long(w.size()) && total_m < m && w(this_m) > docut_lower)
+                {
+                ++this_m;
+                ++total_m;
+                --ndegen;
+                }
+            //Since the weights were made non-increasing, the
+            //rows discarded (the last ones) never carry more
+            //weight than the weights used to truncate
+            auto& RR = Rmats.at(b);
+            for(auto i = this_m; i < long(nrows(RR)); ++i)
+            for(auto j : range(ncols(RR)))
+                {
+                discarded += std::norm(RR(i,j));
+                }
+            }
+        keep.at(b) = this_m;
+        if(this_m > 0 && hasQNs(A)) Liq.emplace_back(qn(qI,1+blocks[b].i1),this_m);
+        }
+    auto truncerr = discarded;
+    if(doRelCutoff && totalw > 0) truncerr /= totalw;
+
+    if(not hasQNs(A))
+        {
+        auto& QQ = Qmats.front();
+        auto& RR = Rmats.front();
+        auto k = keep.front();
+        auto qL = Index(k,tags);
+        auto Qk = Mat<T>(nrows(QQ),k);
+        makeRef(Qk) &= columns(QQ,0,k);
+        auto Rk = Mat<T>(k,ncols(RR));
+        makeRef(Rk) &= rows(RR,0,k);
+        Q = ITensor({qI,qL},Dense<T>(move(Qk.storage())));
+        R = ITensor({qL,rI},Dense<T>(move(Rk.storage())),A.scale());
+        }
+    else
+        {
+        auto qL = Index(move(Liq),qI.dir(),tags);
+        auto Qis = IndexSet(qI,dag(qL));
+        auto Ris = IndexSet(qL,rI);
+        auto Qstore = QDense<T>(Qis,QN());
+        auto Rstore = QDense<T>(Ris,QN(div(A)));
+
+        long n = 0;
+        for(auto b : range(Nblock))
+            {
+            auto k = keep.at(b);
+            if(k == 0) continue;
+            auto& B = blocks[b];
+            auto& QQ = Qmats.at(b);
+            auto& RR = Rmats.at(b);
+
+            auto qind = Block(2);
+            qind[0] = B.i1;
+            qind[1] = n;
+            auto pQ = getBlock(Qstore,Qis,qind);
+            assert(pQ.data() != nullptr);
+            auto Qref = makeMatRef(pQ,nrows(QQ),k);
+            Qref &= columns(QQ,0,k);
+
+            auto rind = Block(2);
+            rind[0] = n;
+            rind[1] = B.i2;
+            auto pR = getBlock(Rstore,Ris,rind);
+            assert(pR.data() != nullptr);
+            auto Rref = makeMatRef(pR.data(),pR.size(),k,ncols(RR));
+            Rref &= rows(RR,0,k);
+
+            ++n;
+            }
+
+        Q = ITensor(Qis,move(Qstore));
+        R = ITensor(Ris,move(Rstore),A.scale());
+        }
+
+    if(A.scale().isFiniteReal())
+        {
+        probs *= sqr(A.scale().real0());
+        }
+    return Spectrum(move(probs),{"Truncerr",truncerr});
+    }
+
+Spectrum
+rrqr(ITensor const& AA,
+     ITensor & Q,
+     ITensor & R,
+     Args args)
+    {
+#ifdef DEBUG
+    if(!Q && !R)
+        Error("Q and R default-initialized in rrqr, must indicate at least one index on Q or R");
+#endif
+    if( args.defined(keys::Maxm) && not args.defined(keys::MaxDim) )
+        {
+        Global::warnDeprecated("Arg Maxm is deprecated in favor of MaxDim.");
+        args.add(keys::MaxDim,args.getInt(keys::Maxm));
+        }
+    if(not args.defined(keys::Truncate))
+        {
+        args.add(keys::Truncate,args.defined(keys::Cutoff) || args.defined(keys::MaxDim));
+        }
+
+    ITensor AAcomb,
+            Qcomb,
+            Rcomb;
+    Index qi,
+          ri;
+    combineForQR(AA,Q,R,AAcomb,Qcomb,Rcomb,qi,ri);
+
+    auto spec = isComplex(AAcomb) ? rrqrImpl<Cplx>(AAcomb,qi,ri,Q,R,args)
+                                  : rrqrImpl<Real>(AAcomb,qi,ri,Q,R,args);
+
+    Q = dag(Qcomb) * Q;
+    R = R * dag(Rcomb);
+    return spec;
+    }
+
   void 
 qrOrd2(ITensor const& A, 
         Index const& qI, 
@@ -22,6 +22,25 @@
 
 namespace itensor {
 
+namespace keys {
+//Truncation options read by svd, diag_hermitian
+//and denmatDecomp on every call
+inline ArgKey const Cutoff("Cutoff");
+inline ArgKey const MaxDim("MaxDim");
+inline ArgKey const MinDim("MinDim");
+inline ArgKey const Truncate("Truncate");
+inline ArgKey const DoRelCutoff("DoRelCutoff");
+inline ArgKey const AbsoluteCutoff("AbsoluteCutoff");
+inline ArgKey const RespectDegenerate("RespectDegenerate");
+inline ArgKey const ShowEigs("ShowEigs");
+inline ArgKey const Noise("Noise");
+inline ArgKey const UseOrigM("UseOrigM");
+inline ArgKey const UseOrigDim("UseOrigDim");
+//Deprecated names of MinDim and MaxDim
+inline ArgKey const Minm("Minm");
+inline ArgKey const Maxm("Maxm");
+} //namespace keys
+
 //
 // Singular value decomposition (SVD)
 //
@@ -284,6 +303,33 @@ std::tuple<ITensor,ITensor>
  qr(ITensor const& T, Index const& i1, IndsArgs&&... indsargs);
 
 
+//
+// Rank-revealing QR decomposition
+//
+// Factors AA = Q*R (block by block if AA has QNs) such that Q
+// has the indices of Q on input plus a new index tagged by arg
+// "Tags" (default "Link,QR"), and has orthonormal columns.
+// Columns are pivoted, so the rows of R come out in order of
+// roughly decreasing weight (squared norm), and R is upper
+// triangular only up to a permutation of its columns.
+//
+// Accepts the truncation args of svd (Cutoff, MaxDim, MinDim,
+// DoRelCutoff, AbsoluteCutoff) and truncates if either Cutoff
+// or MaxDim is given. Since Q is orthonormal, discarding the last
+// rows of R changes AA by exactly their weight; the truncation
+// error of the returned Spectrum is this discarded weight
+// (relative to norm(AA)^2 if DoRelCutoff is true).
+// The eigs of the Spectrum are the row weights of R, made
+// non-increasing within each block and sorted.
+//
+// Cheaper than the svd (even more so without truncation, when
+// columns are not pivoted), but in general keeps somewhat more
+// states than svd for the same truncation error.
+//
+Spectrum
+rrqr(ITensor const& AA, ITensor & Q, ITensor & R, 
+     Args args = Args::global());
+
 ///////////////////////////
 //
 // Implementation (non-template parts in decomp.cc)
@@ -322,35 +368,35 @@ denmatDecomp(ITensor const& AA,
              BigMatrixT const& PH,
              Args args)
     {
-    if( args.defined("Minm") )
+    if( args.defined(keys::Minm) )
       {
-      if( args.defined("MinDim") )
+      if( args.defined(keys::MinDim) )
         {
         Global::warnDeprecated("Args Minm and MinDim are both defined. Minm is deprecated in favor of MinDim, MinDim will be used.");
         }
       else
         {
         Global::warnDeprecated("Arg Minm is deprecated in favor of MinDim.");
-        args.add("MinDim",args.getInt("Minm"));
+        args.add(keys::MinDim,args.getInt(keys::Minm));
         }
       }
 
-    if( args.defined("Maxm") )
+    if( args.defined(keys::Maxm) )
       {
-      if( args.defined("MaxDim") )
+      if( args.defined(keys::MaxDim) )
         {
         Global::warnDeprecated("Args Maxm and MaxDim are both defined. Maxm is deprecated in favor of MaxDim, MaxDim will be used.");
         }
       else
         {
         Global::warnDeprecated("Arg Maxm is deprecated in favor of MaxDim.");
-        args.add("MaxDim",args.getInt("Maxm"));
+        args.add(keys::MaxDim,args.getInt(keys::Maxm));
         }
       }
 
     //TODO: decide on a tag convention for denmatDecomp
     if(!args.defined("Tags")) args.add("Tags","Link");
-    auto noise = args.getReal("Noise",0.);
+    auto noise = args.getReal(keys::Noise,0.);
 
     //TODO: try to avoid using "Link" here
     auto mid = commonIndex(A,B);
@@ -394,11 +440,11 @@ denmatDecomp(ITensor const& AA,
         }
 
 
-    if(args.getBool("UseOrigM",false))
+    if(args.getBool(keys::UseOrigM,false))
         {
-        args.add("Cutoff",-1);
-        args.add("MinDim",dim(mid));
-        args.add("MaxDim",dim(mid));
+        args.add(keys::Cutoff,-1);
+        args.add(keys::MinDim,dim(mid));
+        args.add(keys::MaxDim,dim(mid));
         }
 
     if(args.getBool("TraceReIm",false))
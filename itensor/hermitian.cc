@@ -44,50 +44,50 @@ diagHImpl(ITensor H,
           ITensor& D,
           Args args)
     {
-    if( args.defined("Minm") )
+    if( args.defined(keys::Minm) )
       {
-      if( args.defined("MinDim") )
+      if( args.defined(keys::MinDim) )
         {
         Global::warnDeprecated("Args Minm and MinDim are both defined. Minm is deprecated in favor of MinDim, MinDim will be used.");
         }
       else
         {
         Global::warnDeprecated("Arg Minm is deprecated in favor of MinDim.");
-        args.add("MinDim",args.getInt("Minm"));
+        args.add(keys::MinDim,args.getInt(keys::Minm));
         }
       }
 
-    if( args.defined("Maxm") )
+    if( args.defined(keys::Maxm) )
       {
-      if( args.defined("MaxDim") )
+      if( args.defined(keys::MaxDim) )
         {
         Global::warnDeprecated("Args Maxm and MaxDim are both defined. Maxm is deprecated in favor of MaxDim, MaxDim will be used.");
         }
       else
         {
         Global::warnDeprecated("Arg Maxm is deprecated in favor of MaxDim.");
-        args.add("MaxDim",args.getInt("Maxm"));
+        args.add(keys::MaxDim,args.getInt(keys::Maxm));
         }
       }
 
     auto origdim = dim(H.inds().front());
-    auto cutoff = args.getReal("Cutoff",0.);
-    auto maxdim = args.getInt("MaxDim",origdim);
-    auto mindim = args.getInt("MinDim",1);
-    auto def_do_trunc = args.defined("Cutoff") || args.defined("MaxDim");
-    auto do_truncate = args.getBool("Truncate",def_do_trunc);
-    auto doRelCutoff = args.getBool("DoRelCutoff",true);
-    auto absoluteCutoff = args.getBool("AbsoluteCutoff",false);
-    auto showeigs = args.getBool("ShowEigs",false);
+    auto cutoff = args.getReal(keys::Cutoff,0.);
+    auto maxdim = args.getInt(keys::MaxDim,origdim);
+    auto mindim = args.getInt(keys::MinDim,1);
+    auto def_do_trunc = args.defined(keys::Cutoff) || args.defined(keys::MaxDim);
+    auto do_truncate = args.getBool(keys::Truncate,def_do_trunc);
+    auto doRelCutoff = args.getBool(keys::DoRelCutoff,true);
+    auto absoluteCutoff = args.getBool(keys::AbsoluteCutoff,false);
+    auto showeigs = args.getBool(keys::ShowEigs,false);
     auto itagset = getTagSet(args,"Tags","Link");
 
     // If no truncation is occuring, reset MaxDim
     // to the full matrix dimension
     if(!do_truncate)
         {
-        if(args.defined("MaxDim"))
+        if(args.defined(keys::MaxDim))
             {
-            args.add("MaxDim",origdim);
+            args.add(keys::MaxDim,origdim);
             maxdim = origdim;
             }
         }
@@ -13,6 +13,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 //
+#include <atomic>
+#include <chrono>
 #include "itensor/index.h"
 #include "itensor/util/readwrite.h"
 #include "itensor/util/print_macro.h"
@@ -44,6 +46,46 @@ putprimes(string s, int plev)
 // class Index
 //
 
+namespace detail {
+
+void RandomID::
+reserveBlock(result_type & next, result_type & end)
+    {
+    static std::atomic<result_type> counter(0);
+    result_type const blocksize = 1ul << 16;
+    next = counter.fetch_add(blocksize,std::memory_order_relaxed);
+    end = next+blocksize;
+    }
+
+RandomID::result_type RandomID::
+salt()
+    {
+    static result_type const salt_ = []()
+        {
+        auto rd = std::random_device();
+        auto t = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+        return mix64((result_type(rd()) << 32) ^ rd() ^ result_type(t));
+        }();
+    return salt_;
+    }
+
+//Hash of the tags, independent of the prime level:
+//the interned tag IDs packed into one word
+//(exactly, for up to four tags)
+std::uint64_t
+tagsHash(TagSet const& ts)
+    {
+    std::uint64_t h = 0;
+    for(auto id : ts.ids()) h = ((h << 16) | (h >> 48)) ^ id;
+    return h;
+    }
+
+//Changing the prime level by n adds n*PrimeHashStep
+//to the hash, so prime() can update it cheaply
+std::uint64_t const PrimeHashStep = 0x9e3779b97f4a7c15ull;
+
+} //namespace detail
+
 Index::id_type Index::
 generateID()
     {
@@ -51,14 +93,23 @@ generateID()
     return G();
     }
 
+void Index::
+updateHash()
+    {
+    hash_ = detail::mix64(id_ ^ detail::tagsHash(tags_))
+          + std::uint64_t(primeLevel())*detail::PrimeHashStep;
+    }
+
 Index::
 Index() 
     : 
     id_(0),
-    dim_(1),
-    tags_(TagSet("0"))
+    dim_(1)
     {
-    if(primeLevel() < 0) setPrime(0);
+    //Same as tags_(TagSet("0")), without parsing a string;
+    //default Indices are made in bulk by IndexSet storage
+    tags_.setPrime(0);
+    updateHash();
     }
 
 Index::
@@ -69,6 +120,7 @@ Index(long m,
     tags_(t)
     { 
     if(primeLevel() < 0) setPrime(0);
+    updateHash();
     } 
 
 Index::
@@ -82,12 +134,14 @@ Index(id_type id,
     tags_(ts)
     { 
     if(primeLevel() < 0) setPrime(0);
+    updateHash();
     } 
 
 
 Index& Index::
 setPrime(int plev) 
     { 
+    hash_ += std::uint64_t(plev-primeLevel())*detail::PrimeHashStep;
     tags_.setPrime(plev);
 #ifdef DEBUG
     if(this->primeLevel() < 0)
@@ -100,14 +154,14 @@ setPrime(int plev)
 Index& Index::
 noPrime()  
     {
-    tags_.setPrime(0);
-    return *this;
+    return setPrime(0);
     }
 
 
 Index& Index::
 prime(int inc) 
     { 
+    hash_ += std::uint64_t(inc)*detail::PrimeHashStep;
     tags_.prime(inc);
 #ifdef DEBUG
     if(this->primeLevel() < 0)
@@ -134,18 +188,6 @@ operator=(long val) const
     return operator()(val); 
     }
 
-bool 
-operator==(Index const& i1, Index const& i2)
-    { 
-    return (id(i1) == id(i2)) && (tags(i1) == tags(i2));
-    }
-
-bool 
-operator!=(Index const& i1, Index const& i2)
-    { 
-    return not operator==(i1,i2);
-    }
-
 Index::id_type
 id(Index const& I) { return I.id(); }
 
@@ -721,6 +763,7 @@ read(std::istream& s)
         }
     itensor::read(s,dim_);
     itensor::read(s,dir_);
+    updateHash();
     IQIndexDat dat;
     itensor::read(s,dat);
     if(dat.size()>0)
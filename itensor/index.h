@@ -19,7 +19,7 @@
 #include "itensor/tagset.h"
 #include "itensor/arrow.h"
 #include "itensor/qn.h"
-#include <thread>
+#include <cstdint>
 
 namespace itensor {
 
@@ -29,20 +29,56 @@ class IndexVal;
 using QNInt = std::pair<QN,long>;
 
 namespace detail {
+
+    //Finalizer of the splitmix64 generator: a bijection
+    //of 64-bit integers which scrambles all of the bits
+    std::uint64_t inline
+    mix64(std::uint64_t x)
+        {
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ull;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebull;
+        x ^= x >> 31;
+        return x;
+        }
+
+    //
+    // Generates Index IDs that never repeat within a process
+    // and look random, so that IDs of indices written to disk
+    // are unlikely to equal those of another run.
+    //
+    // Each thread reserves blocks of consecutive numbers from
+    // a global atomic counter and hands them out without any
+    // locking; the numbers, offset by a random per-process
+    // salt, are scrambled by the bijection mix64.
+    //
     struct RandomID
         {
-        using rng_type = std::mt19937_64;
-        using result_type = typename rng_type::result_type;
-        std::hash<std::thread::id> hasher;
-        RandomID()
-            : rng(std::clock() + hasher(std::this_thread::get_id()))
-            { }
+        using result_type = std::uint64_t;
 
         result_type
-        operator()() { return rng(); }
+        operator()()
+            {
+            while(true)
+                {
+                if(next_ == end_) reserveBlock(next_,end_);
+                auto id = mix64(salt()+next_);
+                ++next_;
+                //0 is the ID of a default-constructed Index
+                if(id != 0) return id;
+                }
+            }
 
         private:
-        rng_type rng;
+        result_type next_ = 0,
+                    end_ = 0;
+
+        static void
+        reserveBlock(result_type & next, result_type & end);
+
+        static result_type
+        salt();
         };
 
     struct SequentialID
@@ -91,6 +127,9 @@ class Index
     Arrow dir_ = Out;
     qn_ptr pd;
     TagSet tags_;
+    //Combined hash of id_, tags_ and the prime level,
+    //so that different indices almost always differ in it
+    std::uint64_t hash_ = 0;
     public:
 
     Index();
@@ -127,9 +166,14 @@ class Index
     primeLevel() const { return tags_.primeLevel(); }
 
     // Returns the TagSet
-    TagSet
+    TagSet const&
     tags() const { return tags_; }
 
+    // Hash of the id, tags and prime level;
+    // equal indices have equal hashes
+    std::uint64_t
+    hash() const { return hash_; }
+
     id_type
     id() const { return id_; }
 
@@ -143,23 +187,23 @@ class Index
 
     // Add tags
     Index&
-    addTags(const TagSet& t) { tags_.addTags(t); return *this; }
+    addTags(const TagSet& t) { tags_.addTags(t); updateHash(); return *this; }
 
     // Remove tags
     Index&
-    removeTags(const TagSet& t) { tags_.removeTags(t); return *this; }
+    removeTags(const TagSet& t) { tags_.removeTags(t); updateHash(); return *this; }
 
     // Set tags
     Index&
-    setTags(const TagSet& t) { tags_.setTags(t); return *this; }
+    setTags(const TagSet& t) { tags_.setTags(t); updateHash(); return *this; }
 
     // Remove all tags
     Index&
-    noTags() { tags_.noTags(); return *this; }
+    noTags() { tags_.noTags(); updateHash(); return *this; }
 
     // Set tags
     Index&
-    replaceTags(const TagSet& tsold, const TagSet& tsnew) { tags_.replaceTags(tsold,tsnew); return *this; }
+    replaceTags(const TagSet& tsold, const TagSet& tsnew) { tags_.replaceTags(tsold,tsnew); updateHash(); return *this; }
 
     // Sets the prime level to a specified value.
     Index& 
@@ -225,6 +269,7 @@ class Index
       {
       *this = I;
       id_ = generateID();
+      updateHash();
       return *this;
       }
 
@@ -236,6 +281,9 @@ class Index
     Index::id_type 
     generateID();
 
+    void
+    updateHash();
+
     public:
 
     //
@@ -276,10 +324,20 @@ class Index
     }; //class Index
 
 // i1 compares equal to i2 if i2 is a copy of i1 with same primelevel
-bool 
-operator==(Index const& i1, Index const& i2);
-bool 
-operator!=(Index const& i1, Index const& i2);
+// (and tags). Comparing the hashes first settles most mismatches.
+bool inline
+operator==(Index const& i1, Index const& i2)
+    {
+    return i1.hash() == i2.hash() 
+        && i1.id() == i2.id() 
+        && i1.tags() == i2.tags();
+    }
+
+bool inline
+operator!=(Index const& i1, Index const& i2)
+    {
+    return not operator==(i1,i2);
+    }
 
 // Useful for sorting Index objects
 bool 
@@ -412,9 +412,10 @@ indexPositions(IndexSet const& is,
                IndexSet const& ismatch)
     {
     auto ilocs = std::vector<int>();
+    auto H = detail::IndexHashes(is);
     for(auto const& J : ismatch)
         {
-        auto loc = indexPosition(is,J);
+        auto loc = H.find(J);
         if( loc != -1 ) ilocs.push_back(loc);
         }
 #ifdef DEBUG
@@ -436,8 +437,9 @@ bool
 hasInds(IndexSet const& is,   
         IndexSet const& ismatch)
   {
+  auto H = detail::IndexHashes(is);
   for( auto& I : ismatch )
-    if( !hasIndex(is,I) ) return false;
+    if( !H.contains(I) ) return false;
   return true;
   }
 
@@ -486,8 +488,9 @@ IndexSet
 sim(IndexSet is,
     IndexSet const& ismatch)
     {
+    auto H = detail::IndexHashes(ismatch);
     for(auto& J : is)
-        if( hasIndex(ismatch,J) )
+        if( H.contains(J) )
             J = sim(J);
     return is;
     }
@@ -502,6 +505,42 @@ sim(IndexSet is,
     return is;
     }
 
+long
+computeLabels(IndexSet const& Lis,
+              long rL,
+              IndexSet const& Ris,
+              long rR,
+              Labels & Lind,
+              Labels & Rind)
+    {
+    Lind.assign(rL,0);
+    Rind.assign(rR,0);
+
+    //Contracted indices get the labels -1,-2,...,-ncont
+    auto H = detail::IndexHashes(Ris,rR);
+    long ncont = 0;
+    for(long i = 0; i < rL; ++i)
+        {
+        auto j = H.find(Lis[i]);
+        if(j < 0) continue;
+        Lind[i] = -(1+ncont);
+        Rind[j] = -(1+ncont);
+        ++ncont;
+        }
+
+    //Uncontracted ones get ncont+1,ncont+2,...
+    auto uu = ncont;
+    for(long j = 0; j < rL; ++j)
+        {
+        if(Lind[j] == 0) Lind[j] = ++uu;
+        }
+    for(long j = 0; j < rR; ++j)
+        {
+        if(Rind[j] == 0) Rind[j] = ++uu;
+        }
+    return ncont;
+    }
+
 void
 contractIS(IndexSet const& Lis,
            IndexSet const& Ris,
@@ -593,8 +632,9 @@ commonInds(IndexSet const& is1,
            IndexSet const& is2)
     {
     auto inds = std::vector<Index>();
+    auto H = detail::IndexHashes(is2);
     for( auto& I : is1 )
-        if( hasIndex(is2,I) )
+        if( H.contains(I) )
             inds.push_back(std::move(I));
     return IndexSet(inds);
     }
@@ -606,8 +646,9 @@ unionInds(IndexSet const& is1,
     auto inds = std::vector<Index>();
     for( auto& I : is1 )
         inds.push_back(std::move(I));
+    auto H = detail::IndexHashes(is1);
     for( auto& I : is2 )
-        if( !hasIndex(is1, I) )
+        if( !H.contains(I) )
             inds.push_back(std::move(I));
     return IndexSet(inds);
     }
@@ -651,8 +692,9 @@ uniqueInds(IndexSet const& is1,
            IndexSet const& is2)
     {
     auto inds = std::vector<Index>();
+    auto H = detail::IndexHashes(is2);
     for( auto& I : is1 )
-        if( !hasIndex(is2,I) )
+        if( !H.contains(I) )
             inds.push_back(std::move(I));
     return IndexSet(inds);
     }
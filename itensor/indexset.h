@@ -639,6 +639,72 @@ sim(IndexSet is,
     TagSet const& tsmatch);
 
 
+namespace detail {
+
+//
+// The hashes of the indices of an IndexSet, packed
+// into a contiguous array so that repeatedly matching
+// indices against the set scans 64-bit integers rather
+// than the much larger Index objects.
+//
+// A candidate position is confirmed by a full Index
+// comparison, so find(I) returns exactly what a linear
+// search with operator== would.
+//
+class IndexHashes
+    {
+    IndexSet const* is_ = nullptr;
+    InfArray<std::uint64_t,16> h_;
+    public:
+
+    explicit
+    IndexHashes(IndexSet const& is)
+      : IndexHashes(is,is.order())
+        { }
+
+    //Hashes of the first n indices of is only
+    IndexHashes(IndexSet const& is,
+                long n)
+      : is_(&is),
+        h_(n)
+        {
+        for(decltype(n) j = 0; j < n; ++j) h_[j] = is[j].hash();
+        }
+
+    long
+    size() const { return h_.size(); }
+
+    //Position of the first index equal to I, or -1
+    long
+    find(Index const& I) const
+        {
+        auto h = I.hash();
+        auto n = size();
+        for(decltype(n) b = 0; b < n; b += 64)
+            {
+            auto m = std::min(n-b,64l);
+            //No early exit, so that this loop can be vectorized
+            std::uint64_t mask = 0;
+            for(decltype(m) j = 0; j < m; ++j)
+                {
+                mask |= std::uint64_t(h_[b+j] == h) << j;
+                }
+            while(mask)
+                {
+                auto j = b+__builtin_ctzll(mask);
+                if((*is_)[j] == I) return j;
+                mask &= mask-1;
+                }
+            }
+        return -1;
+        }
+
+    bool
+    contains(Index const& I) const { return find(I) >= 0; }
+    };
+
+} //namespace detail
+
 //
 // IndexSet helper methods
 //
@@ -701,6 +767,16 @@ minDim(IndexSet const& iset);
 long
 maxDim(IndexSet const& iset);
 
+//Same as the generic computeLabels of tensor/contract.h,
+//but matches indices through their packed hashes
+long
+computeLabels(IndexSet const& Lis,
+              long rL,
+              IndexSet const& Ris,
+              long rR,
+              Labels & Lind,
+              Labels & Rind);
+
 void
 contractIS(IndexSet const& Lis,
            IndexSet const& Ris,
@@ -52,6 +52,23 @@ permuteStore(Dense<T>   const& d,
     m.makeNewData<Dense<T>>(move(to.storage()));
     }
 
+//True if permuting the indices "is" of a tensor by P
+//leaves its data unchanged, which is the case when the
+//indices of dimension greater than one keep their order
+bool
+isReshape(Permutation const& P,
+          IndexSet    const& is)
+    {
+    long last = -1;
+    for(auto j : range(is.order()))
+        {
+        if(dim(is[j]) == 1) continue;
+        if(P.dest(j) < last) return false;
+        last = P.dest(j);
+        }
+    return true;
+    }
+
 template<typename Storage>
 void
 combine(Storage  const& d,
@@ -62,6 +79,9 @@ combine(Storage  const& d,
     {
     //TODO: try to make use of Lind,Rind label vectors
     //      to simplify combine logic
+    //Except where the combined indices have to be brought
+    //together, combining and uncombining only replace
+    //indices: the result shares the storage of d
     auto const& cind = Cis[0];
     auto jc = indexPosition(dis,cind);
     if(jc >= 0) //has cind, uncombining
@@ -149,7 +169,9 @@ combine(Storage  const& d,
                     newind.setIndex(i++,dis[j]);
                     }
             Nis = newind.build();
-            permuteStore(d,dis,P,m);
+            //Only indices of dimension 1 are out
+            //of place: no need to move the data
+            if(!isReshape(P,dis)) permuteStore(d,dis,P,m);
             }
         }
     }
@@ -111,6 +111,20 @@ doTask(Mult<Cplx> const& M, Dense<Cplx> & D)
     for(auto& el : D) el *= M.x;
     }
 void
+doTask(Mult<Cplx> const& M, Dense<Cplx> const& D, ManageStore & m)
+    {
+    if(m.uniqueArg1())
+        {
+        doTask(M,*m.modifyData(D));
+        return;
+        }
+    auto nd = m.makeNewData<DenseCplx>(undef,D.size());
+    auto pd = D.data();
+    auto pn = nd->data();
+    for(auto j : range(D.size())) pn[j] = M.x*pd[j];
+    }
+
+void
 doTask(Mult<Cplx> const& M, Dense<Real> const& D, ManageStore & m)
     {
     auto nd = m.makeNewData<DenseCplx>(D.begin(),D.end());
@@ -131,6 +145,29 @@ template
 void
 doTask(Mult<Real> const& M, DenseCplx & D);
 
+template<typename T>
+void
+doTask(Mult<Real> const& M, Dense<T> const& D, ManageStore & m)
+    {
+    if(m.uniqueArg1())
+        {
+        doTask(M,*m.modifyData(D));
+        return;
+        }
+    //D is shared: rather than copying it and
+    //then scaling the copy, scale into new storage
+    auto nd = m.makeNewData<Dense<T>>(undef,D.size());
+    auto d = realData(D);
+    auto n = realData(*nd);
+    for(auto j : range(d.size())) n[j] = M.x*d[j];
+    }
+template
+void
+doTask(Mult<Real> const& M, DenseReal const& D, ManageStore & m);
+template
+void
+doTask(Mult<Real> const& M, DenseCplx const& D, ManageStore & m);
+
 void
 doTask(MakeCplx const&, Dense<Cplx> & D)
     {
@@ -399,6 +436,17 @@ doTask(PlusEQ const& P,
         auto *ncD1 = m.makeNewData<DenseCplx>(D1.begin(),D1.end());
         add(P,*ncD1,D2);
         }
+    else if(!m.uniqueArg1() && isTrivial(P.perm()) && std::is_same<T1,T2>::value)
+        {
+        //D1 is shared: write D1+alpha*D2 into new
+        //storage instead of copying D1 and adding to it
+        auto *nD1 = m.makeNewData<Dense<T1>>(undef,D1.size());
+        auto d1 = realData(D1);
+        auto d2 = realData(D2);
+        auto n1 = realData(*nD1);
+        auto alpha = P.alpha();
+        for(auto j : range(n1.size())) n1[j] = d1[j]+alpha*d2[j];
+        }
     else
         {
         auto *ncD1 = m.modifyData(D1);
@@ -244,12 +244,22 @@ template<typename T>
 void
 doTask(Mult<Real> const& f, Dense<T> & D);
 
+//Scales in place if D is not shared with
+//another ITensor, otherwise writes the
+//scaled data into new storage in one pass
+template<typename T>
+void
+doTask(Mult<Real> const& f, Dense<T> const& D, ManageStore & m);
+
 void
 doTask(Mult<Cplx> const& f, Dense<Real> const& D, ManageStore & m);
 
 void
 doTask(Mult<Cplx> const& f, Dense<Cplx> & D);
 
+void
+doTask(Mult<Cplx> const& f, Dense<Cplx> const& D, ManageStore & m);
+
 void
 doTask(MakeCplx const&, Dense<Cplx> & D);
 void
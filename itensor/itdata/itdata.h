@@ -16,9 +16,12 @@
 #ifndef __ITENSOR_ITDATA_H
 #define __ITENSOR_ITDATA_H
 
+#include <atomic>
+#include <iostream>
 #include <memory>
 #include "itensor/types.h"
 #include "itensor/util/error.h"
+#include "itensor/util/stdx.h"
 #include "itensor/util/timers.h"
 #include "itensor/itdata/storage_types.h"
 
@@ -86,6 +89,101 @@ struct ITData
     plugInto(FuncBase& f) = 0;
     };
 
+//
+// Counts of the implicit copies made when storage shared by
+// several ITensors is modified (copy-on-write). Every such copy
+// passes through detail::noteStoreClone, which is also a
+// convenient place for a debugger breakpoint when looking for
+// the origin of a large copy.
+//
+struct StoreCloneStats
+    {
+    //Number of storage copies
+    size_t count = 0;
+    //Total and largest size of the copied data, in bytes
+    size_t bytes = 0,
+           maxbytes = 0;
+    };
+
+namespace detail {
+
+struct StoreCloneCounter
+    {
+    std::atomic<size_t> count{0},
+                        bytes{0},
+                        maxbytes{0};
+    };
+
+inline StoreCloneCounter&
+storeCloneCounter()
+    {
+    static StoreCloneCounter C;
+    return C;
+    }
+
+void inline
+noteStoreClone(size_t bytes)
+    {
+    auto& C = storeCloneCounter();
+    C.count += 1;
+    C.bytes += bytes;
+    auto m = C.maxbytes.load();
+    while(bytes > m && !C.maxbytes.compare_exchange_weak(m,bytes)) { }
+    }
+
+//Size of the data held in the vector member "store"
+//of Dense, QDense, Diag, QDiag; sizeof(T) otherwise
+template<typename T>
+auto
+storeBytesImpl(stdx::choice<1>, T const& d)
+    -> stdx::if_compiles_return<size_t,decltype(d.store.size())>
+    {
+    using value_type = typename stdx::decay_t<decltype(d.store)>::value_type;
+    return sizeof(T)+d.store.size()*sizeof(value_type);
+    }
+template<typename T>
+size_t
+storeBytesImpl(stdx::choice<2>, T const& d)
+    {
+    return sizeof(T);
+    }
+template<typename T>
+size_t
+storeBytes(T const& d)
+    {
+    return storeBytesImpl(stdx::select_overload{},d);
+    }
+
+} //namespace detail
+
+StoreCloneStats inline
+storeCloneStats()
+    {
+    auto& C = detail::storeCloneCounter();
+    auto S = StoreCloneStats{};
+    S.count = C.count;
+    S.bytes = C.bytes;
+    S.maxbytes = C.maxbytes;
+    return S;
+    }
+
+void inline
+resetStoreCloneStats()
+    {
+    auto& C = detail::storeCloneCounter();
+    C.count = 0;
+    C.bytes = 0;
+    C.maxbytes = 0;
+    }
+
+inline std::ostream&
+operator<<(std::ostream & s, StoreCloneStats const& S)
+    {
+    return s << "Storage copies: " << S.count 
+             << ", total " << S.bytes/(1024.*1024.) << " MB"
+             << ", largest " << S.maxbytes/(1024.*1024.) << " MB";
+    }
+
 template<typename T>
 class ITWrap : public ITData
     {
@@ -106,6 +204,7 @@ class ITWrap : public ITData
     PData
     clone() const final 
         { 
+        detail::noteStoreClone(detail::storeBytes(d));
         return std::make_shared<ITWrap<T>>(d);
         }
 
@@ -231,6 +330,11 @@ class ManageStore
     PData&
     newData() { return nd_; }
 
+    //True if the first argument's storage is not
+    //shared, so that modifying it does not copy it
+    bool
+    uniqueArg1() const { return pparg1_ && pparg1_->use_count() == 1; }
+
     void
     assignPointerRtoL();
 
@@ -252,12 +356,11 @@ class ManageStore
         template<typename T>
         operator T&()
             {
-            if(!(pdata_->unique())) 
+            if(pdata_->use_count() != 1) 
                 {
-                auto* olda1 = static_cast<T*>(pdata_->get());
-                *pdata_ = std::make_shared<ITWrap<T>>(*olda1);
+                *pdata_ = (*pdata_)->clone();
                 }
-            return *(static_cast<T*>(pdata_->get()));
+            return static_cast<ITWrap<T>*>(pdata_->get())->d;
             }
         };
     };
@@ -318,10 +421,9 @@ T* ManageStore::
 modifyData(const T& d)
     {
     //if(!pparg1_) Error("Can't modify const data");
-    if(!(pparg1_->unique())) 
+    if(pparg1_->use_count() != 1) 
         {
-        auto* olda1 = static_cast<ITWrap<T>*>(pparg1_->get());
-        *pparg1_ = std::make_shared<ITWrap<T>>(olda1->d);
+        *pparg1_ = (*pparg1_)->clone();
         }
     auto* a1 = static_cast<ITWrap<T>*>(pparg1_->get());
     return &(a1->d);
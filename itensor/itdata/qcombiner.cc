@@ -169,26 +169,24 @@ combine(QDense<T> const& d,
     //Allocate new data
     auto& nd = *m.makeNewData<QDense<T>>(Nis,doTask(CalcDiv{dis},d));
 
-    auto drange = Range(dr), //block range of current storage
-         nrange = Range(nr); //block range of new storage
-    auto nblock = Block(nr), //block index of new storage
-         cblock = Block(ncomb); //corresponding subblock of combiner
-    size_t start = 0, //offsets within sector of combined
-           end   = 0; //Index where block will go
-    for(auto io : d.offsets) //loop over non-zero blocks
+    //Each block of d fills its own sub-block of nd,
+    //so the blocks can be processed in parallel
+    auto nblocks = d.offsets.size();
+#pragma omp parallel for schedule(dynamic)
+    for(decltype(nblocks) b = 0; b < nblocks; ++b)
         {
+        auto& io = d.offsets[b];
+
         //Make TensorRef for this block of d
+        auto drange = Range(dr);
         drange.init(make_indexdim(dis,io.block));
         auto dref = makeTenRef(d.data(),io.offset,d.size(),&drange);
 
-        //Permute combined indices to front, then
-        //group the first ncomb indices into one
-        auto Pdref = Ten<Range,T>{permute(dref,dperm)};
-        auto gPdref = groupInds(Pdref,0,ncomb);
-
         //Figure out "block index" where this block will
         //go in new storage (nblock) and which sector of
         //combined indices maps to new combined index (cblock)
+        auto nblock = Block(nr),
+             cblock = Block(ncomb);
         size_t nu = 1;
         for(auto i : range(dr)) 
             {
@@ -198,17 +196,43 @@ combine(QDense<T> const& d,
 
         //Use cblock to recover info about structure of combined Index,
         //which sector to map to, where this subsector starts, and ends
+        size_t start = 0, //offsets within sector of combined
+               end   = 0; //Index where block will go
         tie(nblock[0],start,end) = C.getBlockRange(cblock);
 
         //Get full block of new storage
+        auto nrange = Range(nr);
         nrange.init(make_indexdim(Nis,nblock));
         auto nb = getBlock(nd,Nis,nblock);
         assert(nb.data() != nullptr);
-        auto nref = makeRef(nb,&nrange);
 
-        //Slice this new-storage block to get subblock where data will go
-        auto nsub = subIndex(nref,0,start,end);
-        nsub &= gPdref;
+        //Strides of the combined indices within index 0
+        //of the new block, in the order dperm puts them
+        auto cstride = Labels(ncomb);
+        for(auto i : range(dr)) 
+            {
+            if(combined(i)) cstride[dperm[i]] = dref.extent(i);
+            }
+        long str = nrange.stride(0);
+        for(auto c : range(ncomb))
+            {
+            auto ext = cstride[c];
+            cstride[c] = str;
+            str *= ext;
+            }
+        assert(str == long(end-start)*long(nrange.stride(0)));
+
+        //View of the sub-block [start,end) of the new block
+        //with the indices of dref in dref's order, so that
+        //the block is permuted and scattered in one pass
+        auto rb = RangeBuilder(dr);
+        for(auto i : range(dr))
+            {
+            auto s = combined(i) ? cstride[dperm[i]] : nrange.stride(dperm[i]-ncomb+1);
+            rb.nextIndStr(dref.extent(i),s);
+            }
+        auto nsub = makeRef(nb+nrange.stride(0)*start,rb.build());
+        nsub &= dref;
         }
     }
 
@@ -223,7 +247,6 @@ uncombine(QDense<T> const& d,
           ManageStore    & m,
           bool              own_data)
     {
-    using size_type = decltype(order(dis));
     auto& cind = Cis[0];
     auto dr = order(dis);
     auto cr = order(Cis);
@@ -249,26 +272,39 @@ uncombine(QDense<T> const& d,
     //Allocate new data
     auto& nd = *m.makeNewData<QDense<T>>(Nis,doTask(CalcDiv{dis},d));
 
-    auto drange = Range(dr), //block range of current storage
-         nrange = Range(nr); //block range of new storage
-    auto nblock = Block(nr); //block index of new storage
-    for(auto io : d.offsets) //loop over non-zero blocks
+    //Positions in C.store_ of the subblocks of
+    //each sector of the combined index cind
+    auto sectors = std::vector<std::vector<long>>(cind.nblock());
+    for(auto o : range(C.store_))
+        {
+        sectors.at(C.store_[o].block).push_back(o);
+        }
+
+    //Each block of d fills its own blocks of nd,
+    //so the blocks can be processed in parallel
+    auto nblocks = d.offsets.size();
+#pragma omp parallel for schedule(dynamic)
+    for(decltype(nblocks) b = 0; b < nblocks; ++b)
         {
+        auto& io = d.offsets[b];
+
         //Make TensorRef for this block of d
+        auto drange = Range(dr);
         drange.init(make_indexdim(dis,io.block));
         auto dref = makeTenRef(d.data(),io.offset,d.size(),&drange);
 
-        auto n = io.block[jc];
+        auto nblock = Block(nr); //block index of new storage
+        //fill out rest of nblock
+        for(auto m : range(jc)) nblock[m] = io.block[m];
+        for(auto m : range(1+jc,dr)) nblock[ncomb+m-1] = io.block[m];
 
-        for(auto o : range(C.store_))
+        //Only loop over subblocks of combined
+        //indices compatible with current sector
+        //of combined index cind (==dis[jc])
+        for(auto o : sectors[io.block[jc]])
             {
             auto& br = C.store_[o];
 
-            //Only loop over subblocks of combined
-            //indices compatible with current sector (==n)
-            //of combined index cind (==dis[jc])
-            if(size_type(br.block) != size_type(n)) continue;
-
             //"invert" offset o into 
             //indices of nblock corresponding to
             //newly restored uncombined indices
@@ -281,13 +317,10 @@ uncombine(QDense<T> const& d,
                 }
             nblock[jc+ncomb-1] = o;
 
-            //fill out rest of nblock
-            for(auto m : range(jc)) nblock[m] = io.block[m];
-            for(auto m : range(1+jc,dr)) nblock[ncomb+m-1] = io.block[m];
-
             //Get subblock of d data
             auto dsub = subIndex(dref,jc,br.start,br.start+br.extent);
 
+            auto nrange = Range(nr);
             nrange.init(make_indexdim(Nis,nblock));
             auto nb = getBlock(nd,Nis,nblock);
             assert(nb.data() != nullptr);
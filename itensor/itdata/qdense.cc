@@ -13,6 +13,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 //
+#include <limits>
+#include <map>
 //#include "itensor/util/iterate.h"
 #include "itensor/detail/gcounter.h"
 #include "itensor/detail/algs.h"
@@ -22,6 +24,7 @@
 #include "itensor/itdata/dense.h"
 #include "itensor/itdata/qdense.h"
 #include "itensor/itdata/qutil.h"
+#include "itensor/util/scratch.h"
 #include "itensor/util/print_macro.h"
 
 using std::vector;
@@ -178,6 +181,7 @@ updateOffsets(IndexSet const& is,
     {
     auto [bofs,size] = getBlockOffsets(is,div);
     offsets = bofs;
+    resetBlockIndex();
     return size;
     }
 
@@ -187,6 +191,7 @@ updateOffsets(IndexSet const& is,
               Blocks   const& blocks)
     {
     offsets.clear();
+    resetBlockIndex();
 
     if(order(is)==0)
         {
@@ -228,6 +233,74 @@ offsetOfLoc(BlockOffsets const& offsets,
     return loc;
     }
 
+BlockIndex::
+BlockIndex(BlockOffsets const& offsets,
+           IndexSet const& is)
+    {
+    auto r = order(is);
+    nblock_.resize(r);
+    for(auto i : range(r)) nblock_[i] = std::max(1l,long(is[i].nblock()));
+
+    //Strides of the packed key, giving up (leaving
+    //stride_ empty) if the number of possible
+    //blocks does not fit in a long
+    auto stride = std::vector<long>(r);
+    long nkey = 1;
+    for(auto i : range(r))
+        {
+        stride[i] = nkey;
+        if(nkey > std::numeric_limits<long>::max()/nblock_[i]) return;
+        nkey *= nblock_[i];
+        }
+    if(r == 0) stride.push_back(0);
+    stride_ = std::move(stride);
+
+    auto nnz = long(offsets.size());
+    dense_ = (nkey <= 4*nnz+64);
+    if(dense_) table_.assign(nkey,-1);
+    else       map_.reserve(nnz);
+    for(auto n : range(nnz))
+        {
+        auto k = key(offsets[n].block);
+        if(dense_) table_[k] = int(n);
+        else       map_[k] = int(n);
+        }
+    }
+
+bool BlockIndex::
+compatible(IndexSet const& is) const
+    {
+    if(long(order(is)) != long(nblock_.size())) return false;
+    for(auto i : range(nblock_.size()))
+        {
+        if(std::max(1l,long(is[i].nblock())) != nblock_[i]) return false;
+        }
+    return true;
+    }
+
+namespace detail {
+
+BlockIndex const* BlockIndexCache::
+get(BlockOffsets const& offsets,
+    IndexSet const& is) const
+    {
+    auto* p = p_.load(std::memory_order_acquire);
+    if(!p)
+        {
+        //Threads racing to build the index
+        //keep the first one stored
+        auto* np = new BlockIndex(offsets,is);
+        if(p_.compare_exchange_strong(p,np,std::memory_order_acq_rel)) p = np;
+        else delete np;
+        }
+    //The index is not replaced here since other
+    //threads may be using it; fall back to searching
+    if(!p->compatible(is)) return nullptr;
+    return p;
+    }
+
+} //namespace detail
+
 Cplx
 doTask(GetElt& G, QDenseReal const& d)
     {
@@ -309,6 +382,25 @@ doTask(Mult<Real> const& M, QDense<T>& D)
 template void doTask(Mult<Real> const&, QDenseReal&);
 template void doTask(Mult<Real> const&, QDenseCplx&);
 
+template<typename T>
+void
+doTask(Mult<Real> const& M, QDense<T> const& D, ManageStore & m)
+    {
+    if(m.uniqueArg1())
+        {
+        doTask(M,*m.modifyData(D));
+        return;
+        }
+    //D is shared: scale into new storage
+    //instead of copying D and scaling the copy
+    auto *nd = m.makeNewData<QDense<T>>(undef,D.offsets,D.size());
+    auto d = realData(D);
+    auto n = realData(*nd);
+    for(auto j : range(d.size())) n[j] = M.x*d[j];
+    }
+template void doTask(Mult<Real> const&, QDenseReal const&, ManageStore &);
+template void doTask(Mult<Real> const&, QDenseCplx const&, ManageStore &);
+
 
 void
 doTask(Mult<Cplx> const& M, QDense<Cplx> & d)
@@ -750,6 +842,185 @@ template void doTask(Contract& Con,QDense<Cplx> const&,QDense<Real> const&,Manag
 template void doTask(Contract& Con,QDense<Real> const&,QDense<Cplx> const&,ManageStore&);
 template void doTask(Contract& Con,QDense<Cplx> const&,QDense<Cplx> const&,ManageStore&);
 
+namespace {
+
+//Contract the QDense tensor Q with the Dense tensor D,
+//writing the Dense result C. Only the non-zero blocks
+//of Q are visited: each block is contracted with the
+//slice of D it overlaps with, and the result is added
+//to the corresponding slice of C.
+template<typename VQ, typename VD>
+void
+contractQDenseDense(QDense<VQ> const& Q, IndexSet const& Qis, Labels const& Qind,
+                    Dense<VD>  const& D, IndexSet const& Dis, Labels const& Dind,
+                    IndexSet const& Cis, Labels const& Cind,
+                    ManageStore & m)
+    {
+    using VC = common_type<VQ,VD>;
+    auto rQ = order(Qis);
+    auto rD = order(Dis);
+    auto rC = order(Cis);
+
+    auto& C = *m.makeNewData<Dense<VC>>(dim(Cis));
+
+    //Start of each block of each index of Q
+    auto bstart = std::vector<std::vector<size_t>>(rQ);
+    for(auto j : range(rQ))
+        {
+        auto& st = bstart[j];
+        st.resize(nblock(Qis[j])+1,0);
+        for(auto b : range(nblock(Qis[j]))) st[b+1] = st[b]+Qis[j].blocksize0(b);
+        }
+
+    //Position in Q of the indices of D and C
+    //(-1 if an index of D is not contracted,
+    // or an index of C comes from D)
+    auto DtoQ = std::vector<long>(rD,-1);
+    for(auto k : range(rD)) DtoQ[k] = find_index(Qind,Dind[k]);
+    auto CtoQ = std::vector<long>(rC,-1);
+    auto CtoD = std::vector<long>(rC,-1);
+    for(auto c : range(rC))
+        {
+        CtoQ[c] = find_index(Qind,Cind[c]);
+        if(CtoQ[c] < 0) CtoD[c] = find_index(Dind,Cind[c]);
+        }
+
+    auto Dextents = std::vector<size_t>(rD);
+    for(auto k : range(rD)) Dextents[k] = dim(Dis[k]);
+    auto Drange = Range(Dextents);
+    auto Dref = makeTenRef(D.data(),D.size(),&Drange);
+    auto Cextents = std::vector<size_t>(rC);
+    for(auto c : range(rC)) Cextents[c] = dim(Cis[c]);
+
+    //Group the blocks of Q by the blocks of their contracted
+    //indices, so that each slice of D is gathered only once
+    auto groups = std::map<std::vector<long>,std::vector<BlOf const*>>{};
+    for(auto& io : Q.offsets)
+        {
+        auto key = std::vector<long>(rD,-1);
+        for(auto k : range(rD)) if(DtoQ[k] >= 0) key[k] = io.block[DtoQ[k]];
+        groups[key].push_back(&io);
+        }
+
+    auto Dstart = std::vector<size_t>(rD),
+         Dstop = std::vector<size_t>(rD);
+    auto Cstart = std::vector<size_t>(rC),
+         Cstop = std::vector<size_t>(rC);
+    for(auto& g : groups)
+        {
+        //Gather the slice of D overlapping these blocks,
+        //unless it is all of D
+        auto whole = true;
+        for(auto k : range(rD))
+            {
+            auto j = DtoQ[k];
+            auto b = g.first[k];
+            Dstart[k] = (j >= 0) ? bstart[j][b] : 0;
+            Dstop[k] = (j >= 0) ? bstart[j][b+1] : Dextents[k];
+            whole = whole && (Dstop[k]-Dstart[k] == Dextents[k]);
+            }
+        auto Dsub = ScratchBuffer<VD>{};
+        auto Dsubrange = Range{};
+        auto dref = Dref;
+        if(!whole)
+            {
+            auto Dsubext = std::vector<size_t>(rD);
+            for(auto k : range(rD)) Dsubext[k] = Dstop[k]-Dstart[k];
+            Dsubrange = Range(Dsubext);
+            Dsub = scratchBuffer<VD>(dim(Dsubrange));
+            auto dsub = makeTenRef(Dsub.data(),Dsub.size(),&Dsubrange);
+            dsub &= subTensor(Dref,Dstart,Dstop);
+            dref = makeRefc(dsub);
+            }
+
+        for(auto* io : g.second)
+            {
+            auto Qrange = Range{};
+            Qrange.init(make_indexdim(Qis,io->block));
+            auto qref = makeTenRef(Q.data()+io->offset,dim(Qrange),&Qrange);
+
+            //Slice of C this block contributes to. It is
+            //contiguous in C if all indices before some
+            //index k are whole and all after it have extent 1.
+            auto Csubext = std::vector<size_t>(rC);
+            size_t offset = 0,
+                   stride = 1;
+            auto contiguous = true;
+            auto partial = false;
+            for(auto c : range(rC))
+                {
+                auto j = CtoQ[c];
+                Cstart[c] = (j >= 0) ? bstart[j][io->block[j]] : Dstart[CtoD[c]];
+                Cstop[c] = (j >= 0) ? bstart[j][io->block[j]+1] : Dstop[CtoD[c]];
+                Csubext[c] = Cstop[c]-Cstart[c];
+                offset += stride*Cstart[c];
+                stride *= Cextents[c];
+                if(partial && Csubext[c] != 1) contiguous = false;
+                if(Csubext[c] != Cextents[c]) partial = true;
+                }
+            auto Csubrange = Range(Csubext);
+            auto csize = dim(Csubrange);
+            if(contiguous)
+                {
+                auto cref = makeTenRef(C.data()+offset,csize,&Csubrange);
+                contract(qref,Qind,dref,Dind,cref,Cind,1.,1.);
+                }
+            else
+                {
+                auto Cblock = scratchBuffer<VC>(csize);
+                auto cref = makeTenRef(Cblock.data(),csize,&Csubrange);
+                contract(qref,Qind,dref,Dind,cref,Cind);
+                auto Cfullrange = Range(Cextents);
+                auto Cfull = makeTenRef(C.data(),C.size(),&Cfullrange);
+                transform(makeRefc(cref),subTensor(Cfull,Cstart,Cstop),
+                          [](VC from, VC & to) { to += from; });
+                }
+            }
+        }
+    }
+
+} //namespace
+
+template<typename VA, typename VB>
+void
+doTask(Contract& Con,
+       QDense<VA> const& A,
+       Dense<VB> const& B,
+       ManageStore& m)
+    {
+    Labels Lind,
+           Rind,
+           Cind;
+    computeLabels(Con.Lis,order(Con.Lis),Con.Ris,order(Con.Ris),Lind,Rind);
+    const bool sortResult = false;
+    contractIS(Con.Lis,Lind,Con.Ris,Rind,Con.Nis,Cind,sortResult);
+    contractQDenseDense(A,Con.Lis,Lind,B,Con.Ris,Rind,Con.Nis,Cind,m);
+    }
+template void doTask(Contract& Con,QDense<Real> const&,Dense<Real> const&,ManageStore&);
+template void doTask(Contract& Con,QDense<Cplx> const&,Dense<Real> const&,ManageStore&);
+template void doTask(Contract& Con,QDense<Real> const&,Dense<Cplx> const&,ManageStore&);
+template void doTask(Contract& Con,QDense<Cplx> const&,Dense<Cplx> const&,ManageStore&);
+
+template<typename VA, typename VB>
+void
+doTask(Contract& Con,
+       Dense<VA> const& A,
+       QDense<VB> const& B,
+       ManageStore& m)
+    {
+    Labels Lind,
+           Rind,
+           Cind;
+    computeLabels(Con.Lis,order(Con.Lis),Con.Ris,order(Con.Ris),Lind,Rind);
+    const bool sortResult = false;
+    contractIS(Con.Lis,Lind,Con.Ris,Rind,Con.Nis,Cind,sortResult);
+    contractQDenseDense(B,Con.Ris,Rind,A,Con.Lis,Lind,Con.Nis,Cind,m);
+    }
+template void doTask(Contract& Con,Dense<Real> const&,QDense<Real> const&,ManageStore&);
+template void doTask(Contract& Con,Dense<Cplx> const&,QDense<Real> const&,ManageStore&);
+template void doTask(Contract& Con,Dense<Real> const&,QDense<Cplx> const&,ManageStore&);
+template void doTask(Contract& Con,Dense<Cplx> const&,QDense<Cplx> const&,ManageStore&);
+
 template<typename VA, typename VB>
 void
 doTask(NCProd& P,
@@ -769,51 +1040,17 @@ doTask(NCProd& P,
     computeLabels(Ais,rA,Bis,rB,Aind,Bind);
     ncprod(Ais,Aind,Bis,Bind,Cis,Cind);
 
-    Labels BtoA(rA,-1);
-    for(auto ia : range(rA))
-    for(auto ib : range(rB))
-        if(Bis[ib] == Ais[ia])
-            {
-            BtoA[ib] = ia;
-            break;
-            }
-
-    auto Cdiv = QN{};
-        {
-        Cdiv = doTask(CalcDiv{Ais},A);
-        auto Ablock_ind = Block(rA);
-        Ablock_ind = A.offsets.front().block;
-        auto Bblock_ind = Block(rB);
-        for(auto& bo : B.offsets)
-            {
-            Bblock_ind = bo.block;
-            bool matchesA = true;
-            for(auto n : range(rB))
-                {
-                if(Bind[n] < 0 && Ablock_ind[BtoA[n]] != Bind[n])
-                    {
-                    matchesA = false;
-                    break;
-                    }
-                }
-            if(matchesA) break;
-            }
-        //Only account for unique indices of B
-        for(auto n : range(rB))
-            if(Bind[n] > 0) //unique
-                {
-                Cdiv += Bis[n].dir()*Bis[n].qn(1+Bblock_ind[n]);
-                }
-        }
+    auto [Coffsets,Csize,blockContractions] = getContractedOffsets(A,Ais,B,Bis,Cis);
 
     //Allocate storage for C
-    auto& C = *m.makeNewData<QDense<VC>>(Cis,Cdiv);
+    auto& C = *m.makeNewData<QDense<VC>>(Coffsets,Csize);
 
     auto do_ncprod = 
         [&P,&Aind,&Bind,&Cind]
         (DataRange<const VA> ablock, Block const& Ablockind,
          DataRange<const VB> bblock, Block const& Bblockind,
-         DataRange<VC>       cblock, Block const& Cblockind)
+         DataRange<VC>       cblock, Block const& Cblockind,
+         int)
         {
         Range Arange,
               Brange,
@@ -837,6 +1074,7 @@ doTask(NCProd& P,
     loopContractedBlocks(A,Ais,
                          B,Bis,
                          C,Cis,
+                         blockContractions,
                          do_ncprod);
 
 #ifdef USESCALE
@@ -16,6 +16,8 @@
 #ifndef __ITENSOR_QDENSE_H
 #define __ITENSOR_QDENSE_H
 
+#include <atomic>
+#include <unordered_map>
 #include <vector>
 #include "itensor/itdata/task_types.h"
 #include "itensor/itdata/itdata.h"
@@ -31,6 +33,86 @@ class QDense;
 using QDenseReal = QDense<Real>;
 using QDenseCplx = QDense<Cplx>;
 
+//
+// Map from block labels to positions in a list
+// of block offsets, for constant-time block lookup.
+//
+// A block label is packed into a single integer key
+// with the first index varying fastest, so that keys
+// increase with the (reverse lexicographic) block
+// ordering. Keys are looked up in a dense table when
+// most possible blocks are present and in a hash
+// map otherwise.
+//
+class BlockIndex
+    {
+    std::vector<long> nblock_,
+                      stride_;
+    std::vector<int> table_;
+    std::unordered_map<long,int> map_;
+    bool dense_ = false;
+    public:
+
+    BlockIndex(BlockOffsets const& offsets,
+               IndexSet const& is);
+
+    //False if the block labels are too large to pack
+    //into a key; such an index must not be used
+    explicit operator bool() const { return !stride_.empty(); }
+
+    //Whether the index was built for an IndexSet
+    //with the same numbers of blocks as is
+    bool
+    compatible(IndexSet const& is) const;
+
+    long
+    key(Block const& block) const
+        {
+        long k = 0;
+        for(auto i : range(block.size())) k += block[i]*stride_[i];
+        return k;
+        }
+
+    //Position of block in the offsets, or -1 if absent
+    int
+    loc(Block const& block) const
+        {
+        auto k = key(block);
+        if(dense_) return table_[k];
+        auto it = map_.find(k);
+        return it != map_.end() ? it->second : -1;
+        }
+    };
+
+namespace detail {
+
+//Holds the BlockIndex of a QDense; copies start out
+//empty so that an index is never shared with storage
+//whose offsets may later be changed independently
+class BlockIndexCache
+    {
+    mutable std::atomic<BlockIndex const*> p_{nullptr};
+    public:
+
+    BlockIndexCache() { }
+
+    BlockIndexCache(BlockIndexCache const&) { }
+
+    BlockIndexCache&
+    operator=(BlockIndexCache const&) { reset(); return *this; }
+
+    ~BlockIndexCache() { reset(); }
+
+    BlockIndex const*
+    get(BlockOffsets const& offsets,
+        IndexSet const& is) const;
+
+    void
+    reset() { delete p_.exchange(nullptr); }
+    };
+
+} //namespace detail
+
 template<typename T>
 class QDense
     {
@@ -53,6 +135,13 @@ class QDense
         //^ tensor data stored contiguously
     //////////////
 
+    private:
+    detail::BlockIndexCache index_;
+        //^ built on first use by blockIndex;
+        //  code changing the block labels in
+        //  offsets directly must call resetBlockIndex
+    public:
+
     QDense() { }
 
     QDense(IndexSet const& is, 
@@ -168,6 +257,16 @@ class QDense
                                std::get<2>(eltblockoffset));
         }
 
+    //Index giving the position of a block in offsets
+    //in constant time. Built on first use and safe to
+    //call from several threads at once. Returns nullptr
+    //if the index cannot be used with this IndexSet.
+    BlockIndex const*
+    blockIndex(IndexSet const& is) const { return index_.get(offsets,is); }
+
+    void
+    resetBlockIndex() { index_.reset(); }
+
     long
     updateOffsets(IndexSet const& is,
                   QN const& div);
@@ -245,6 +344,7 @@ read(std::istream & s, QDense<T> & dat)
     {
     itensor::read(s,dat.offsets);
     itensor::read(s,dat.store);
+    dat.resetBlockIndex();
     }
 
 template<typename T>
@@ -254,6 +354,8 @@ swap(QDense<T> & d1,
     {
     d1.offsets.swap(d2.offsets);
     d1.store.swap(d2.store);
+    d1.resetBlockIndex();
+    d2.resetBlockIndex();
     }
 
 template<typename T>
@@ -335,6 +437,10 @@ template<typename T>
 void
 doTask(Mult<Real> const& M, QDense<T>& d);
 
+template<typename T>
+void
+doTask(Mult<Real> const& M, QDense<T> const& d, ManageStore & m);
+
 void
 doTask(Mult<Cplx> const& M, QDense<Real> const& d, ManageStore & m);
 
@@ -415,13 +521,21 @@ doTask(Contract& Con,
        QDense<VB> const& B,
        ManageStore& m);
 
-//TODO: complete implementation
-//template<typename VA, typename VB>
-//void
-//doTask(Contract& Con,
-//       Dense<VA> const& A,
-//       QDense<VB> const& B,
-//       ManageStore& m);
+//Contract only the non-zero blocks of the QDense
+//tensor with the Dense one; the result is Dense
+template<typename VA, typename VB>
+void
+doTask(Contract& Con,
+       QDense<VA> const& A,
+       Dense<VB> const& B,
+       ManageStore& m);
+
+template<typename VA, typename VB>
+void
+doTask(Contract& Con,
+       Dense<VA> const& A,
+       QDense<VB> const& B,
+       ManageStore& m);
 
 template<typename VA, typename VB>
 void
@@ -449,6 +563,34 @@ int
 offsetOfLoc(BlockOffsets const& offsets,
             Block        const& blockind);
 
+//Same as offsetOf and offsetOfLoc, but
+//using the BlockIndex of d
+template<typename T>
+long
+offsetOf(QDense<T> const& d,
+         IndexSet  const& is,
+         Block     const& blockind)
+    {
+    auto* index = d.blockIndex(is);
+    if(!index || !*index) return offsetOf(d.offsets,blockind);
+    auto loc = index->loc(blockind);
+    return loc >= 0 ? d.offsets[loc].offset : -1;
+    }
+
+template<typename T>
+int
+offsetOfLoc(QDense<T> const& d,
+            IndexSet  const& is,
+            Block     const& blockind)
+    {
+    auto* index = d.blockIndex(is);
+    auto loc = (index && *index) ? index->loc(blockind) : -1;
+    //Absent blocks get the position where
+    //they would be inserted, as for offsetOfLoc
+    if(loc < 0) return offsetOfLoc(d.offsets,blockind);
+    return loc;
+    }
+
 template<typename T>
 template<typename Indexable>
 std::tuple<T const*,Block,long> QDense<T>::
@@ -481,9 +623,8 @@ getEltBlockOffset(IndexSet const& is,
         eoff += elt_subind*estr;
         estr *= I.blocksize0(block_subind);
         }
-    //Do a binary search (equal_range) to see
-    //if there is a block with block index "bind"
-    auto boff = offsetOf(offsets,block);
+    //See if there is a block with block index "bind"
+    auto boff = offsetOf(*this,is,block);
     if(boff >= 0)
         {
 #ifdef DEBUG
@@ -530,6 +671,7 @@ insertBlock(IndexSet const& is,
 
     // Insert the block and offset into the block-offsets list
     offsets.insert(offsets.begin()+insert_loc,make_blof(block,new_offset));
+    resetBlockIndex();
     return new_offset;
     }
 
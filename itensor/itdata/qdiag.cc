@@ -30,10 +30,9 @@ typeNameOf(QDiagReal const& d) { return "QDiagReal"; }
 const char*
 typeNameOf(QDiagCplx const& d) { return "QDiagCplx"; }
 
-template<typename T, class F>
+template<class F>
 void
-loopDiagBlocks(QDiag<T> const& D,
-               IndexSet const& is,
+loopDiagBlocks(IndexSet const& is,
                F const& callback)
     {
     auto r = order(is);
@@ -107,7 +106,7 @@ doTask(CalcDiv const& C, QDiag<T> const& D)
             }
         if(q != d) Error("Diagonal elements of QDiag ITensor would have inconsistent divergence");
         };
-    loopDiagBlocks(D,C.is,checkBlock);
+    loopDiagBlocks(C.is,checkBlock);
 #endif
 
     return d;
@@ -115,6 +114,28 @@ doTask(CalcDiv const& C, QDiag<T> const& D)
 template QN doTask(CalcDiv const& C, QDiag<Real> const& D);
 template QN doTask(CalcDiv const& C, QDiag<Cplx> const& D);
 
+BlockOffsets
+diagBlockOffsets(IndexSet const& is)
+    {
+    auto offsets = BlockOffsets{};
+    if(order(is)==0)
+        {
+        offsets.push_back(make_blof(Block(0),0));
+        return offsets;
+        }
+    auto addBlock = [&offsets]
+        (size_t nb,
+         size_t ne,
+         IntArray const& block)
+        {
+        auto b = Block(block.size());
+        for(auto n : range(block)) b[n] = block[n];
+        offsets.push_back(make_blof(b,nb));
+        };
+    loopDiagBlocks(is,addBlock);
+    return offsets;
+    }
+
 size_t
 computeLength(IndexSet const& is)
     {
@@ -132,7 +153,8 @@ computeLength(IndexSet const& is)
 template<typename T>
 QDiag<T>::
 QDiag(IndexSet const& is)
-  : length(computeLength(is))
+  : length(computeLength(is)),
+    offsets(diagBlockOffsets(is))
     {
     store.assign(length,0);
 #ifdef DEBUG
@@ -146,7 +168,8 @@ template<typename T>
 QDiag<T>::
 QDiag(IndexSet const& is, T val_)
   : val(val_),
-    length(computeLength(is))
+    length(computeLength(is)),
+    offsets(diagBlockOffsets(is))
     {
 #ifdef DEBUG
     doTask(CalcDiv{is},*this);
@@ -242,6 +265,7 @@ doTask(Mult<Cplx> const& M, QDiag<Real> const& d, ManageStore & m)
     auto *nd = m.makeNewData<QDiagCplx>();
     nd->length = d.length;
     nd->val = d.val;
+    nd->offsets = d.offsets;
     if(not d.allSame())
         {
         auto *nd = m.makeNewData<QDiagCplx>();
@@ -329,7 +353,7 @@ doTask(PrintIT& P, QDiag<T> const& d)
             }
         };
 
-    loopDiagBlocks(d,P.is,printBlock);
+    loopDiagBlocks(P.is,printBlock);
     }
 template void doTask(PrintIT& P, QDiag<Real> const& d);
 template void doTask(PrintIT& P, QDiag<Cplx> const& d);
@@ -374,18 +398,21 @@ blockDiagDense(QDiag<VD> const& D,
             break;
             }
 
-    auto Cdiv = doTask(CalcDiv{Dis},D)+doTask(CalcDiv{Tis},T);
+    auto [Coffsets,Csize,blockContractions] = getContractedOffsets(T.offsets,Tis,
+                                                                   diagBlockOffsets(D,Dis),Dis,
+                                                                   Cis);
 
     if(T_has_uncontracted)
         {
-        auto *nd = m.makeNewData<QDense<VC>>(Cis,Cdiv);
+        auto *nd = m.makeNewData<QDense<VC>>(Coffsets,Csize);
         auto& C = *nd;
 
         auto do_contract =
             [&D,&Dis,&Tis,&Cis,&DL,&TL,&CL]
             (DataRange<const VT> tblock, Block const& Tblockind,
              DataRange<const VD> dblock, Block const& Dblockind,
-             DataRange<VC>       cblock, Block const& Cblockind)
+             DataRange<VC>       cblock, Block const& Cblockind,
+             int)
             {
             Range Trange,
                   Crange;
@@ -430,6 +457,7 @@ blockDiagDense(QDiag<VD> const& D,
         loopContractedBlocks(T,Tis,
                              D,Dis,
                              C,Cis,
+                             blockContractions,
                              do_contract);
         }
     else
@@ -441,7 +469,8 @@ blockDiagDense(QDiag<VD> const& D,
             [&D,&Dis,&Tis,&DL,&TL,&CL]
             (DataRange<const VT> tblock, Block const& Tblockind,
              DataRange<const VD> dblock, Block const& Dblockind,
-             DataRange<VC>       cblock, Block const& Cblockind)
+             DataRange<VC>       cblock, Block const& Cblockind,
+             int)
             {
             Range Trange;
             Trange.init(make_indexdim(Tis,Tblockind));
@@ -476,6 +505,7 @@ blockDiagDense(QDiag<VD> const& D,
         loopContractedBlocks(T,Tis,
                              D,Dis,
                              C,Cis,
+                             blockContractions,
                              do_contract);
         }
     }
@@ -565,6 +595,45 @@ template void doTask(Contract& Con,QDense<Cplx> const& A,QDiag<Real> const& B,Ma
 template void doTask(Contract& Con,QDense<Real> const& A,QDiag<Cplx> const& B,ManageStore& m);
 template void doTask(Contract& Con,QDense<Cplx> const& A,QDiag<Cplx> const& B,ManageStore& m);
 
+//The diagonal elements of a QDiag are stored in the
+//same order as those of a Diag, so a QDiag-Dense product
+//only needs the diagonal copied, not the full tensor
+template<typename V>
+Diag<V>
+diagOf(QDiag<V> const& d)
+    {
+    if(d.allSame()) return Diag<V>(d.length,d.val);
+    return Diag<V>(d.begin(),d.end());
+    }
+
+template<typename VA, typename VB>
+void
+doTask(Contract& Con,
+       QDiag<VA> const& A,
+       Dense<VB> const& B,
+       ManageStore& m)
+    {
+    doTask(Con,diagOf(A),B,m);
+    }
+template void doTask(Contract& Con,QDiag<Real> const& A,Dense<Real> const& B,ManageStore& m);
+template void doTask(Contract& Con,QDiag<Cplx> const& A,Dense<Real> const& B,ManageStore& m);
+template void doTask(Contract& Con,QDiag<Real> const& A,Dense<Cplx> const& B,ManageStore& m);
+template void doTask(Contract& Con,QDiag<Cplx> const& A,Dense<Cplx> const& B,ManageStore& m);
+
+template<typename VA, typename VB>
+void
+doTask(Contract& Con,
+       Dense<VA> const& A,
+       QDiag<VB> const& B,
+       ManageStore& m)
+    {
+    doTask(Con,A,diagOf(B),m);
+    }
+template void doTask(Contract& Con,Dense<Real> const& A,QDiag<Real> const& B,ManageStore& m);
+template void doTask(Contract& Con,Dense<Cplx> const& A,QDiag<Real> const& B,ManageStore& m);
+template void doTask(Contract& Con,Dense<Real> const& A,QDiag<Cplx> const& B,ManageStore& m);
+template void doTask(Contract& Con,Dense<Cplx> const& A,QDiag<Cplx> const& B,ManageStore& m);
+
 template<typename T>
 bool
 doTask(IsDense,
@@ -43,6 +43,14 @@ class QDiag
 
     T val = 0;
     size_t length = 0ul;
+
+    BlockOffsets offsets;
+        //^ Blocks containing diagonal elements, in
+        //  increasing order, and the position of
+        //  their first diagonal element in store.
+        //  May be empty (for example for storage
+        //  read from disk), in which case use
+        //  diagBlockOffsets to compute them.
     //////////////
 
     QDiag() { }
@@ -59,7 +67,8 @@ class QDiag
     QDiag(QDiag<V> const& D)
       : store(D.begin(),D.end()),
         val(D.val),
-        length(D.length)
+        length(D.length),
+        offsets(D.offsets)
         { }
 
     QDiag(size_t size)
@@ -95,6 +104,20 @@ class QDiag
 
     };
 
+//Block offsets of QDiag storage with IndexSet is
+BlockOffsets
+diagBlockOffsets(IndexSet const& is);
+
+//The block offsets of D, computed from is if D does not store them
+template<typename T>
+BlockOffsets
+diagBlockOffsets(QDiag<T> const& D,
+                 IndexSet const& is)
+    {
+    if(!D.offsets.empty()) return D.offsets;
+    return diagBlockOffsets(is);
+    }
+
 const char*
 typeNameOf(QDiagReal const& d);
 const char*
@@ -155,6 +178,7 @@ doTask(ApplyIT<F> & A, QDiag<T> const& d, ManageStore & m)
         {
         auto *nd = m.makeNewData<QDiag<new_type>>(d.size());
         assert(nd->store.size() == d.store.size());
+        nd->offsets = d.offsets;
         A(d.val,nd->val);
         for(auto n : range(d.store.size()))
             {
@@ -207,6 +231,7 @@ doTask(GenerateIT<F,Real>& G, QDiagCplx const& D, ManageStore & m)
     {
     auto *nD = m.makeNewData<QDiagReal>();
     nD->store.resize(D.length);
+    nD->offsets = D.offsets;
     stdx::generate(*nD,G.f);
     }
 
@@ -216,6 +241,7 @@ doTask(GenerateIT<F,Cplx>& G, QDiagReal const& D, ManageStore & m)
     {
     auto *nD = m.makeNewData<QDiagCplx>();
     nD->store.resize(D.length);
+    nD->offsets = D.offsets;
     stdx::generate(*nD,G.f);
     }
 
@@ -284,10 +310,30 @@ doTask(Contract& Con,
        QDiag<VB> const& B,
        ManageStore& m);
 
+//Result is Dense
+template<typename VA, typename VB>
+void
+doTask(Contract& Con,
+       QDiag<VA> const& A,
+       Dense<VB> const& B,
+       ManageStore& m);
+
+template<typename VA, typename VB>
+void
+doTask(Contract& Con,
+       Dense<VA> const& A,
+       QDiag<VB> const& B,
+       ManageStore& m);
+
+//Permuting the indices leaves the diagonal
+//elements in place, but not the block labels
 template<typename T>
 void
 doTask(Order const& P,
-       QDiag<T> & dA) { }
+       QDiag<T> & dA)
+    {
+    if(!dA.offsets.empty()) dA.offsets = diagBlockOffsets(P.is2());
+    }
 
 template<typename Indexable>
 std::tuple<size_t,size_t,IntArray>
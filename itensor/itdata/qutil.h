@@ -21,6 +21,7 @@
 #endif
 
 #include "itensor/indexset.h"
+#include "itensor/util/contracttrace.h"
 
 namespace itensor {
 
@@ -67,35 +68,71 @@ getBlockLoc(QDense<T> const& d,
     return loc;
     }
 
+template<typename T>
+int
+getBlockLoc(QDense<T> const& d,
+            IndexSet const& is,
+            Block const& block_ind)
+    {
+    return offsetOfLoc(d,is,block_ind);
+    }
+
+//Storage other than QDense, such as QDiag, is
+//searched by a binary search over its offsets
 template<typename BlockSparse>
+int
+getBlockLoc(BlockSparse const& d,
+            IndexSet const& is,
+            Block const& block_ind)
+    {
+    return offsetOfLoc(d.offsets,block_ind);
+    }
+
+template<typename QDenseT>
 auto
-getBlock(BlockSparse & d,
-         IndexSet const& is,
-         Block const& block_ind)
-    -> stdx::if_compiles_return<decltype(makeDataRange(d.data(),d.size())),decltype(d.offsets)>
+getQDenseBlock(QDenseT & d,
+               IndexSet const& is,
+               Block const& block_ind)
+    -> decltype(makeDataRange(d.data(),d.size()))
     {
     auto r = long(block_ind.size());
     if(r == 0) return makeDataRange(d.data(),d.size());
 #ifdef DEBUG
     if(is.order() != r) Error("Mismatched size of IndexSet and block_ind in getBlock");
 #endif
-    //Do binary search to see if there
-    //is a block with block index ii
-    auto boff = offsetOf(d.offsets,block_ind);
+    //See if there is a block with block index ii
+    auto boff = offsetOf(d,is,block_ind);
     if(boff >= 0) return makeDataRange(d.data(),boff,d.size());
     using data_range_type = decltype(makeDataRange(d.data(),d.size()));
     return data_range_type{};
     }
 
-// From two input block-sparse tensors,
-// output the offsets and data size of the
+template<typename T>
+DataRange<T>
+getBlock(QDense<T> & d,
+         IndexSet const& is,
+         Block const& block_ind)
+    {
+    return getQDenseBlock(d,is,block_ind);
+    }
+
+template<typename T>
+DataRange<const T>
+getBlock(QDense<T> const& d,
+         IndexSet const& is,
+         Block const& block_ind)
+    {
+    return getQDenseBlock(d,is,block_ind);
+    }
+
+// From the block offsets of two input block-sparse
+// tensors, output the offsets and data size of the
 // result of contracting the tensors
-template<typename BlockSparseA,
-         typename BlockSparseB>
+inline
 std::tuple<BlockOffsets,size_t,std::vector<std::tuple<Block,Block,Block>>>
-getContractedOffsets(BlockSparseA const& A,
+getContractedOffsets(BlockOffsets const& Aoffsets,
                      IndexSet const& Ais,
-                     BlockSparseB const& B,
+                     BlockOffsets const& Boffsets,
                      IndexSet const& Bis,
                      IndexSet const& Cis)
     {
@@ -152,16 +189,16 @@ getContractedOffsets(BlockSparseA const& A,
 #endif
 
 #pragma omp for schedule(dynamic)
-    for (int i=0; i<(int)A.offsets.size(); ++i)
+    for (int i=0; i<(int)Aoffsets.size(); ++i)
         {
-        auto const& aio = A.offsets[i];
+        auto const& aio = Aoffsets[i];
 
         //Begin computing elements of Cblock(=destination of this block-block contraction)
         for(auto iA : range(rA))
             if(AtoC[iA] != -1) Cblockind[AtoC[iA]] = aio.block[iA];
 
         //Loop over blocks of B which contract with current block of A
-        for(auto const& bio : B.offsets)
+        for(auto const& bio : Boffsets)
             {
             auto do_blocks_contract = true;
             for(auto iA : range(rA))
@@ -241,16 +278,31 @@ getContractedOffsets(BlockSparseA const& A,
     return std::make_tuple(Cblocksizes,Csize,blockContractions);
     }
 
-template<typename TA,
-         typename TB,
-         typename TC,
+template<typename BlockSparseA,
+         typename BlockSparseB>
+std::tuple<BlockOffsets,size_t,std::vector<std::tuple<Block,Block,Block>>>
+getContractedOffsets(BlockSparseA const& A,
+                     IndexSet const& Ais,
+                     BlockSparseB const& B,
+                     IndexSet const& Bis,
+                     IndexSet const& Cis)
+    {
+    return getContractedOffsets(A.offsets,Ais,B.offsets,Bis,Cis);
+    }
+
+// Call callback on each block contraction of the plan
+// made by getContractedOffsets. The storage types may
+// be QDense, or QDiag for A or B or C
+template<typename BlockSparseA,
+         typename BlockSparseB,
+         typename BlockSparseC,
          typename Callable>
 void
-_loopContractedBlocks(QDense<TA> const& A,
+_loopContractedBlocks(BlockSparseA const& A,
                       IndexSet const& Ais,
-                      QDense<TB> const& B,
+                      BlockSparseB const& B,
                       IndexSet const& Bis,
-                      QDense<TC> & C,
+                      BlockSparseC & C,
                       IndexSet const& Cis,
                       std::vector<std::tuple<Block,Block,Block>> const& blockContractions,
                       Callable & callback)
@@ -260,7 +312,7 @@ _loopContractedBlocks(QDense<TA> const& A,
         auto ablock = getBlock(A,Ais,Ablockind);
         auto bblock = getBlock(B,Bis,Bblockind);
         auto cblock = getBlock(C,Cis,Cblockind);
-        auto Cblockloc = getBlockLoc(C,Cblockind);
+        auto Cblockloc = getBlockLoc(C,Cis,Cblockind);
         callback(ablock,Ablockind,
                  bblock,Bblockind,
                  cblock,Cblockind,
@@ -268,16 +320,16 @@ _loopContractedBlocks(QDense<TA> const& A,
         }
     }
 
-template<typename TA,
-         typename TB,
-         typename TC,
+template<typename BlockSparseA,
+         typename BlockSparseB,
+         typename BlockSparseC,
          typename Callable>
 void
-_loopContractedBlocksOMP(QDense<TA> const& A,
+_loopContractedBlocksOMP(BlockSparseA const& A,
                          IndexSet const& Ais,
-                         QDense<TB> const& B,
+                         BlockSparseB const& B,
                          IndexSet const& Bis,
-                         QDense<TC> & C,
+                         BlockSparseC & C,
                          IndexSet const& Cis,
                          std::vector<std::tuple<Block,Block,Block>> const& blockContractions,
                          Callable & callback)
@@ -291,28 +343,31 @@ _loopContractedBlocksOMP(QDense<TA> const& A,
     std::sort(std::begin(blockContractionsSorted),std::end(blockContractionsSorted),
               sortBlockContractions);
 
-    auto nnzblocksC = C.offsets.size();
-    auto offset = std::vector<int>(nnzblocksC,0);
-    auto nrepeat = std::vector<int>(nnzblocksC,1);
-
-    int nblockC = 0;
+    // Group the contractions by output block. Not every
+    // block of C need be written to (for example when C
+    // is QDiag storage), so count the groups here
+    // rather than using the number of blocks of C
     auto ncontractions = blockContractionsSorted.size();
+    auto offset = std::vector<int>();
+    auto nrepeat = std::vector<int>();
+    offset.reserve(C.offsets.size());
+    nrepeat.reserve(C.offsets.size());
 
-    for(decltype(ncontractions) i = 1; i < ncontractions; i++)
+    for(decltype(ncontractions) i = 0; i < ncontractions; i++)
         {
-        if(std::get<2>(blockContractionsSorted[i]) == 
-           std::get<2>(blockContractionsSorted[i-1]))
+        if(i > 0 && std::get<2>(blockContractionsSorted[i]) == 
+                    std::get<2>(blockContractionsSorted[i-1]))
             {
-            nrepeat[nblockC] += 1;
+            nrepeat.back() += 1;
             }
         else
             {
-            nblockC += 1;
-            offset[nblockC] = i;
+            offset.push_back(i);
+            nrepeat.push_back(1);
             }
         }
+    auto nnzblocksC = offset.size();
 
-      
 #ifdef DEBUG
     decltype(ncontractions) n = 0;
     for(decltype(nnzblocksC) i = 0; i < nnzblocksC; i++)
@@ -339,7 +394,7 @@ _loopContractedBlocksOMP(QDense<TA> const& A,
         auto ablock = getBlock(A,Ais,Ablockind);
         auto bblock = getBlock(B,Bis,Bblockind);
         auto cblock = getBlock(C,Cis,Cblockind);
-        auto Cblockloc = getBlockLoc(C,Cblockind);
+        auto Cblockloc = getBlockLoc(C,Cis,Cblockind);
         callback(ablock,Ablockind,
                  bblock,Bblockind,
                  cblock,Cblockind,
@@ -349,122 +404,63 @@ _loopContractedBlocksOMP(QDense<TA> const& A,
     }
 
 
-template<typename TA,
-         typename TB,
-         typename TC,
+template<typename BlockSparseA,
+         typename BlockSparseB,
+         typename BlockSparseC,
          typename Callable>
 void
-loopContractedBlocks(QDense<TA> const& A,
+loopContractedBlocks(BlockSparseA const& A,
                      IndexSet const& Ais,
-                     QDense<TB> const& B,
+                     BlockSparseB const& B,
                      IndexSet const& Bis,
-                     QDense<TC> & C,
+                     BlockSparseC & C,
                      IndexSet const& Cis,
                      std::vector<std::tuple<Block,Block,Block>> const& blockContractions,
                      Callable & callback)
     {
+    using TA = typename BlockSparseA::value_type;
+    using TB = typename BlockSparseB::value_type;
+    using TC = typename BlockSparseC::value_type;
+    auto trace = ContractTrace::enabled();
+    auto t0 = trace ? ContractTrace::now() : ContractTrace::time_point{};
 #ifdef ITENSOR_USE_OMP
     _loopContractedBlocksOMP(A,Ais,B,Bis,C,Cis,blockContractions,callback);
 #else
     _loopContractedBlocks(A,Ais,B,Bis,C,Cis,blockContractions,callback);
 #endif
-    }
-
-// This is a special case of loopContractedBlocks for QDiag
-// since QDiag doesn't have a .offsets function
-// TODO: add .offsets for QDiag so it can use the generic
-// (faster) version
-template<typename TA, 
-         typename TB,
-         typename TC,
-         typename Callable>
-void
-loopContractedBlocks(TA const& A,
-                     IndexSet const& Ais,
-                     TB const& B,
-                     IndexSet const& Bis,
-                     TC & C,
-                     IndexSet const& Cis,
-                     Callable & callback)
-    {
-    auto rA = Ais.order();
-    auto rB = Bis.order();
-    auto rC = Cis.order();
-
-    auto AtoB = IntArray(rA,-1);
-    auto AtoC = IntArray(rA,-1);
-    auto BtoC = IntArray(rB,-1);
-    for(auto ic : range(rC))
+    if(trace)
         {
-        auto j = indexPosition(Ais,Cis[ic]);
-        if(j >= 0)
+        auto r = ContractRecord{};
+        r.kind = ContractRecord::Blocks;
+        for(auto& I : Ais) r.Adims.push_back(dim(I));
+        for(auto& I : Bis) r.Bdims.push_back(dim(I));
+        for(auto& I : Cis) r.Cdims.push_back(dim(I));
+        r.Acplx = isCplx(A);
+        r.Bcplx = isCplx(B);
+        r.bytes = sizeof(TA)*double(A.size())+sizeof(TB)*double(B.size())
+                 +sizeof(TC)*double(C.size());
+        r.nblocks = blockContractions.size();
+        r.nCblocks = C.offsets.size();
+        //For a block contraction (m x k)*(k x n), m*k*n is
+        //the square root of the product of the three block sizes
+        auto blockSize = [](IndexSet const& is, Block const& b)
             {
-            AtoC[j] = ic;
-            }
-        else
+            double s = 1.;
+            for(auto j : range(order(is))) s *= is[j].blocksize0(b[j]);
+            return s;
+            };
+        for(auto const& [Ablockind,Bblockind,Cblockind] : blockContractions)
             {
-            j = indexPosition(Bis,Cis[ic]);
-            BtoC[j] = ic;
+            auto mkn = std::sqrt(blockSize(Ais,Ablockind)
+                                *blockSize(Bis,Bblockind)
+                                *blockSize(Cis,Cblockind));
+            r.flops += gemmFlops(1,1,1,r.Acplx,r.Bcplx)*mkn;
             }
+        r.ttotal = ContractTrace::seconds(t0,ContractTrace::now());
+        ContractTrace::record(r);
         }
-    for(auto ia : range(rA))
-    for(auto ib : range(rB))
-        {
-        if(Ais[ia] == Bis[ib])
-            {
-            AtoB[ia] = ib;
-            break;
-            }
-        }
-
-    auto couB = detail::GCounter(rB);
-    auto Bblockind = Block(rB,0);
-    auto Cblockind = Block(rC,0);
-    //Loop over blocks of A (labeled by elements of A.offsets)
-    for(auto const& aio : A.offsets)
-        {
-        //Reset couB to run over indices of B (at first)
-        couB.reset();
-        for(auto iB : range(rB))
-            {
-            couB.setRange(iB,0,Bis[iB].nblock()-1);
-            }
-        for(auto iA : range(rA))
-            {
-            auto ival = aio.block[iA];
-            //Restrict couB to be fixed for indices of B contracted with A
-            if(AtoB[iA] != -1) couB.setRange(AtoB[iA],ival,ival);
-            //Begin computing elements of Cblock(=destination of this block-block contraction)
-            if(AtoC[iA] != -1) Cblockind[AtoC[iA]] = ival;
-            }
-        //Loop over blocks of B which contract with current block of A
-        for(;couB.notDone(); ++couB)
-            {
-            //Check whether B contains non-zero block for this setting of couB
-            //TODO: check whether block is present by storing all blocks
-            //      but most have null pointers to data
-            //Finish making Cblockind and Bblockind
-            for(auto iB : range(rB))
-                {
-                if(BtoC[iB] != -1) Cblockind[BtoC[iB]] = couB.i[iB];
-                Bblockind[iB] = couB.i[iB];
-                }
-            auto bblock = getBlock(B,Bis,Bblockind);
-            if(!bblock) continue;
-
-            auto cblock = getBlock(C,Cis,Cblockind);
-            assert(cblock);
-
-            auto ablock = makeDataRange(A.data(),aio.offset,A.size());
-
-            callback(ablock,aio.block,
-                     bblock,Bblockind,
-                     cblock,Cblockind);
-            } //for couB
-        } //for A.offsets
     }
 
-
 } //namespace itensor
 
 #endif
@@ -887,9 +887,23 @@ checkSameDiv(ITensor const& T1,
         }
     }
 
+//Whether the product of Q (with QNs) and D (without)
+//can be done directly, without removing the QNs of Q:
+//true for QDense or QDiag storage times Dense storage
+bool
+hasMixedContract(ITensor const& Q, ITensor const& D)
+    {
+    using ST = StorageType;
+    auto tq = doTask(StorageType{},Q.store());
+    auto td = doTask(StorageType{},D.store());
+    auto qok = (tq == ST::QDenseReal || tq == ST::QDenseCplx 
+             || tq == ST::QDiagReal || tq == ST::QDiagCplx);
+    auto dok = (td == ST::DenseReal || td == ST::DenseCplx);
+    return qok && dok;
+    }
+
 } //namespace detail
 
-//TODO: implement proper Dense*QDense to avoid conversion cost
 ITensor& ITensor::
 operator*=(ITensor const& R)
     {
@@ -912,19 +926,33 @@ operator*=(ITensor const& R)
 
     if(Global::checkArrows()) detail::checkArrows(L.inds(),R.inds());
 
-    //TODO: create a proper doTask(Contract,Dense,QDense)
+    //QDense and QDiag times Dense are contracted directly,
+    //giving a Dense result; in other products of tensors
+    //with and without QNs, the QNs are removed first
     auto hqL = hasQNs(L);
     auto hqR = hasQNs(R);
-    auto Rdense = R;
-    if(hqL && !hqR) L = removeQNs(L);
-    else if(!hqL && hqR) Rdense = removeQNs(Rdense);
+    auto mixed = false;
+    //Only make a QN-free copy of R when it is needed,
+    //otherwise contract with R itself
+    auto Rdense = ITensor{};
+    if(hqL && !hqR) 
+        {
+        mixed = detail::hasMixedContract(L,R);
+        if(!mixed) L = removeQNs(std::move(L));
+        }
+    else if(!hqL && hqR) 
+        {
+        mixed = detail::hasMixedContract(R,L);
+        if(!mixed) Rdense = removeQNs(R);
+        }
+    auto const& Rc = Rdense ? Rdense : R;
 
-    auto C = doTask(Contract{L.inds(),Rdense.inds()},
+    auto C = doTask(Contract{L.inds(),Rc.inds()},
                     L.store(),
-                    Rdense.store());
+                    Rc.store());
 
 #ifdef USESCALE
-    L.scale_ *= Rdense.scale();
+    L.scale_ *= Rc.scale();
     if(!std::isnan(C.scalefac)) L.scale_ *= C.scalefac;
 #endif
 
@@ -933,6 +961,8 @@ operator*=(ITensor const& R)
     checkIndexSet(C.Nis);
 #endif
 
+    if(mixed) C.Nis.removeQNs();
+
     L.is_.swap(C.Nis);
 
     return L;
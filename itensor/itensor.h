@@ -545,6 +545,13 @@ ITensor
 operator-(ITensor A, ITensor const& B);
 ITensor
 operator-(ITensor const& A, ITensor&& B);
+
+//L += alpha*R, without forming alpha*R;
+//L must not be default constructed
+void
+daxpy(ITensor & L,
+      ITensor const& R,
+      Real alpha);
 ITensor
 operator/(ITensor A, ITensor const& B);
 ITensor
@@ -22,6 +22,14 @@
 
 namespace itensor {
 
+namespace keys {
+//Options read by the iterative solvers on every call
+inline ArgKey const MaxIter("MaxIter");
+inline ArgKey const MinIter("MinIter");
+inline ArgKey const ErrGoal("ErrGoal");
+inline ArgKey const DebugLevel("DebugLevel");
+} //namespace keys
+
 //
 // Use the Davidson algorithm to find the 
 // eigenvector of the Hermitian matrix A with minimal eigenvalue.
@@ -102,10 +110,10 @@ davidson(BigMatrixT const& A,
          std::vector<ITensor>& phi,
          Args const& args)
     {
-    auto maxiter_ = args.getSizeT("MaxIter",2);
-    auto errgoal_ = args.getReal("ErrGoal",1E-14);
-    auto debug_level_ = args.getInt("DebugLevel",-1);
-    auto miniter_ = args.getSizeT("MinIter",1);
+    auto maxiter_ = args.getSizeT(keys::MaxIter,2);
+    auto errgoal_ = args.getReal(keys::ErrGoal,1E-14);
+    auto debug_level_ = args.getInt(keys::DebugLevel,-1);
+    auto miniter_ = args.getSizeT(keys::MinIter,1);
 
     Real Approx0 = 1E-12;
 
@@ -534,10 +542,10 @@ gmresImpl(BigMatrixT const& A,
           Args const& args)
     {
     auto n = A.size();
-    auto max_iter = args.getInt("MaxIter",n);
+    auto max_iter = args.getInt(keys::MaxIter,n);
     auto m = args.getInt("RestartIter",max_iter);
-    auto tol = args.getReal("ErrGoal",1E-14);
-    auto debug_level_ = args.getInt("DebugLevel",-1);
+    auto tol = args.getReal(keys::ErrGoal,1E-14);
+    auto debug_level_ = args.getInt(keys::DebugLevel,-1);
 
     auto H = Mat<T>(m+1,m+1);
 
@@ -644,7 +652,7 @@ gmres(BigMatrixT const& A,
       BigVectorT& x,
       Args const& args)
     {
-    auto debug_level_ = args.getInt("DebugLevel",-1);
+    auto debug_level_ = args.getInt(keys::DebugLevel,-1);
 
     // Precompute Ax to figure out whether A or x is
     // complex, maybe there is a cleaner code design
@@ -716,11 +724,11 @@ arnoldi(const BigMatrixT& A,
         std::vector<ITensor>& phi,
         Args const& args)
     {
-    int maxiter_ = args.getInt("MaxIter",10);
+    int maxiter_ = args.getInt(keys::MaxIter,10);
     int maxrestart_ = args.getInt("MaxRestart",0);
     std::string whicheig_ = args.getString("WhichEig","LargestMagnitude");
-    const Real errgoal_ = args.getReal("ErrGoal",1E-6);
-    const int debug_level_ = args.getInt("DebugLevel",-1);
+    const Real errgoal_ = args.getReal(keys::ErrGoal,1E-6);
+    const int debug_level_ = args.getInt(keys::DebugLevel,-1);
 
     if(maxiter_ < 1) maxiter_ = 1;
     if(maxrestart_ < 0) maxrestart_ = 0;
@@ -970,9 +978,9 @@ void
 applyExp(BigMatrixT const& H, ITensor& phi,
          ElT tau, Args const& args)
     {
-    auto tol = args.getReal("ErrGoal",1E-10);
-    auto max_iter = args.getInt("MaxIter",30);
-    auto debug_level = args.getInt("DebugLevel",-1);
+    auto tol = args.getReal(keys::ErrGoal,1E-10);
+    auto max_iter = args.getInt(keys::MaxIter,30);
+    auto debug_level = args.getInt(keys::DebugLevel,-1);
     auto beta_tol = args.getReal("NormCutoff",1e-7);
 
     // Initialize Lanczos vectors
@@ -21,6 +21,18 @@
 
 namespace itensor {
 
+namespace keys {
+//Options DMRGWorker sets at every bond for the observer
+inline ArgKey const Sweep("Sweep");
+inline ArgKey const NSweep("NSweep");
+inline ArgKey const AtBond("AtBond");
+inline ArgKey const HalfSweep("HalfSweep");
+inline ArgKey const Energy("Energy");
+inline ArgKey const Truncerr("Truncerr");
+inline ArgKey const Silent("Silent");
+inline ArgKey const Quiet("Quiet");
+} //namespace keys
+
 //
 // Class for monitoring DMRG calculations.
 // The measure and checkDone methods are virtual
@@ -95,14 +107,14 @@ void inline DMRGObserver::
 measure(Args const& args)
     {
     auto N = length(psi_);
-    auto b = args.getInt("AtBond",1);
-    auto sw = args.getInt("Sweep",0);
-    auto nsweep = args.getInt("NSweep",0);
-    auto ha = args.getInt("HalfSweep",0);
-    auto energy = args.getReal("Energy",0);
-    auto silent = args.getBool("Silent",false);
-
-    //if(!args.getBool("Quiet",false) && !args.getBool("NoMeasure",false))
+    auto b = args.getInt(keys::AtBond,1);
+    auto sw = args.getInt(keys::Sweep,0);
+    auto nsweep = args.getInt(keys::NSweep,0);
+    auto ha = args.getInt(keys::HalfSweep,0);
+    auto energy = args.getReal(keys::Energy,0);
+    auto silent = args.getBool(keys::Silent,false);
+
+    //if(!args.getBool(keys::Quiet,false) && !args.getBool("NoMeasure",false))
     //    {
     //    if(b < N && b > 0)
     //        {
@@ -175,8 +187,8 @@ measure(Args const& args)
 bool inline DMRGObserver::
 checkDone(Args const& args)
     {
-    const int sw = args.getInt("Sweep",0);
-    const Real energy = args.getReal("Energy",0);
+    const int sw = args.getInt(keys::Sweep,0);
+    const Real energy = args.getReal(keys::Energy,0);
     
     if(sw == 1)
         {
@@ -555,6 +555,7 @@ toMPOImpl(AutoMPO const& am,
     auto const& sites = am.sites();
     auto H = MPO(sites);
     auto N = length(sites);
+    if(args.getBool("WriteToDisk",false)) H.doWrite(true,args);
 
     for(auto& t : am.terms())
     if(t.Nops() > 2) 
@@ -818,11 +819,12 @@ toMPOImpl(AutoMPO const& am,
             println("=========================================");
             }
 #endif
+        //Done while W is in memory, since with
+        //WriteToDisk the earlier W's are on disk
+        if(n == 1) W *= setElt(links.at(0)(1));
+        if(n == N) W *= setElt(dag(links.at(N))(1));
         }
 
-    H.ref(1) *= setElt(links.at(0)(1));
-    H.ref(N) *= setElt(dag(links.at(N))(1));
-
     //checkQNs(H);
 
     return H;
@@ -1358,18 +1360,22 @@ compressMPO(SiteSet const& sites,
     //println("Maximal dimension of the MPO is ", max_d);
     }
 
+//Releases each piece of finalMPO once
+//the site tensor is made from it
 template<typename T>
 MPO
 constructMPOTensors(SiteSet const& sites,
-                    vector<MPOPiece<T>> const& finalMPO, 
+                    vector<MPOPiece<T>> & finalMPO, 
                     vector<Index> const& links, 
                     Args const& args = Args::global())
     {
     auto H = MPO(sites);
     int N = length(sites);
+    if(args.getBool("WriteToDisk",false)) H.doWrite(true,args);
 
     auto isExpH = args.getBool("IsExpH",false);
     auto infinite = args.getBool("Infinite",false);
+    int min_n = isExpH ? 1 : 2;
 
     for(int n = 1; n <= N; ++n)
         {
@@ -1408,19 +1414,22 @@ constructMPOTensors(SiteSet const& sites,
                 }
             W.scaleTo(1.);
             }
+        MPOPiece<T>().swap(finalMPO.at(n-1));
+
+        if(!infinite)
+            {
+            //Done while W is in memory, since with
+            //WriteToDisk the earlier W's are on disk
+            if(n == 1) W *= setElt(links.at(0)(min_n));
+            if(n == N) W *= setElt(dag(links.at(N))(1));
+            }
         }
 
-    int min_n = isExpH ? 1 : 2;
     if(infinite)
         {
         H.ref(0) = setElt(links.at(0)(min_n));
         H.ref(N+1) = setElt(dag(links.at(N))(1));   
         }
-    else
-        {
-        H.ref(1) *= setElt(links.at(0)(min_n));
-        H.ref(N) *= setElt(dag(links.at(N))(1));   
-        }
     
     return H;
     }
@@ -1442,11 +1451,11 @@ svdMPO(AutoMPO const& am,
             }
         }
 
-    MPO H;
-
     auto checkqns = args.getBool("CheckQN=",true);
     if(not hasQNs(am.sites()(1))) checkqns = false;
 
+    //Returning from each branch avoids copying H, which
+    //copies its directory if it was written to disk
     if(is_real)
         {
         auto qbs = vector<QNBlock<Real>>();
@@ -1455,33 +1464,15 @@ svdMPO(AutoMPO const& am,
         auto finalMPO = vector<MPOPiece<Real>>();
         auto links = vector<Index>();
         compressMPO(am.sites(),qbs,tempMPO,finalMPO,links,isExpH,tau,args);
-        H = constructMPOTensors<Real>(am.sites(),finalMPO,links,args);
+        return constructMPOTensors<Real>(am.sites(),finalMPO,links,args);
         }
-    else
-        {
-        auto qbs = vector<QNBlock<Cplx>>();
-        auto tempMPO = vector<IQMatEls>();
-        partitionHTerms(am.sites(),am.terms(),qbs,tempMPO,checkqns);
-        auto finalMPO = vector<MPOPiece<Cplx>>();
-        auto links = vector<Index>();
-        compressMPO(am.sites(),qbs,tempMPO,finalMPO,links,isExpH,tau,args);
-        H = constructMPOTensors<Cplx>(am.sites(),finalMPO,links,args);
-        }
-
-//#ifdef DEBUG
-//    if(is_real)
-//        {
-//        for(auto n : range1(length(H)))
-//            {
-//            if(isComplex(H(n)))
-//                {
-//                Error("Complex tensor produced from real AutoMPO terms");
-//                }
-//            }
-//        }
-//#endif
-
-    return H;
+    auto qbs = vector<QNBlock<Cplx>>();
+    auto tempMPO = vector<IQMatEls>();
+    partitionHTerms(am.sites(),am.terms(),qbs,tempMPO,checkqns);
+    auto finalMPO = vector<MPOPiece<Cplx>>();
+    auto links = vector<Index>();
+    compressMPO(am.sites(),qbs,tempMPO,finalMPO,links,isExpH,tau,args);
+    return constructMPOTensors<Cplx>(am.sites(),finalMPO,links,args);
     }
 
 MPO 
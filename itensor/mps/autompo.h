@@ -28,6 +28,15 @@ class AutoMPO;
 // Given an AutoMPO representing a Hamiltonian H,
 // returns an exact MPO form of H.
 //
+// Arguments recognized:
+// o "Exact" (default false): skip the SVD compression
+// o "WriteToDisk" (default false): write each site tensor
+//   to disk as soon as the next one is made, so that only
+//   a few are in memory at a time. The MPO is returned with
+//   doWrite() == true, keeping its tensors in a temporary
+//   directory inside "WriteDir" (default "./").
+//   (Copying such an MPO copies the directory.)
+//
 MPO
 toMPO(AutoMPO const& a,
       Args const& args = Args::global());
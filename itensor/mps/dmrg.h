@@ -19,9 +19,11 @@
 #include "itensor/iterativesolvers.h"
 #include "itensor/mps/localmposet.h"
 #include "itensor/mps/localmpo_mps.h"
+#include "itensor/mps/localsparsempo.h"
 #include "itensor/mps/sweeps.h"
 #include "itensor/mps/DMRGObserver.h"
 #include "itensor/util/cputime.h"
+#include "itensor/util/scratch.h"
 
 
 namespace itensor {
@@ -177,6 +179,20 @@ dmrg(MPO const& H,
     return std::tuple<Real,MPS>(energy,psi);
     }
 
+//
+//DMRG with an MPO stored as a SparseMPO
+//
+Real inline
+dmrg(MPS & psi, 
+     SparseMPO const& H, 
+     Sweeps const& sweeps,
+     Args const& args = Args::global())
+    {
+    LocalSparseMPO PH(H,args);
+    Real energy = DMRGWorker(psi,PH,sweeps,args);
+    return energy;
+    }
+
 //
 //DMRG with a set of MPOs (lazily summed)
 //(H vector is 0-indexed)
@@ -355,37 +371,39 @@ DMRGWorker(MPS & psi,
       }
 
     // Truncate blocks of degenerate singular values (or not)
-    args.add("RespectDegenerate",args.getBool("RespectDegenerate",true));
+    args.add(keys::RespectDegenerate,args.getBool(keys::RespectDegenerate,true));
 
-    const bool silent = args.getBool("Silent",false);
+    const bool silent = args.getBool(keys::Silent,false);
     if(silent)
         {
-        args.add("Quiet",true);
+        args.add(keys::Quiet,true);
         args.add("PrintEigs",false);
         args.add("NoMeasure",true);
-        args.add("DebugLevel",0);
+        args.add(keys::DebugLevel,0);
         }
-    const bool quiet = args.getBool("Quiet",false);
-    const int debug_level = args.getInt("DebugLevel",(quiet ? 0 : 1));
+    const bool quiet = args.getBool(keys::Quiet,false);
+    const int debug_level = args.getInt(keys::DebugLevel,(quiet ? 0 : 1));
+    //Return cached contraction scratch memory to the OS after each sweep
+    const bool release_scratch = args.getBool("ReleaseScratch",false);
 
     const int N = length(psi);
     Real energy = NAN;
 
     psi.position(1);
 
-    args.add("DebugLevel",debug_level);
+    args.add(keys::DebugLevel,debug_level);
     args.add("DoNormalize",true);
     
     for(int sw = 1; sw <= sweeps.nsweep(); ++sw)
         {
         cpu_time sw_time;
-        args.add("Sweep",sw);
-        args.add("NSweep",sweeps.nsweep());
-        args.add("Cutoff",sweeps.cutoff(sw));
-        args.add("MinDim",sweeps.mindim(sw));
-        args.add("MaxDim",sweeps.maxdim(sw));
-        args.add("Noise",sweeps.noise(sw));
-        args.add("MaxIter",sweeps.niter(sw));
+        args.add(keys::Sweep,sw);
+        args.add(keys::NSweep,sweeps.nsweep());
+        args.add(keys::Cutoff,sweeps.cutoff(sw));
+        args.add(keys::MinDim,sweeps.mindim(sw));
+        args.add(keys::MaxDim,sweeps.maxdim(sw));
+        args.add(keys::Noise,sweeps.noise(sw));
+        args.add(keys::MaxIter,sweeps.niter(sw));
 
         if(!PH.doWrite()
            && args.defined("WriteDim")
@@ -437,10 +455,10 @@ TIMER_STOP(4);
 
             obs.lastSpectrum(spec);
 
-            args.add("AtBond",b);
-            args.add("HalfSweep",ha);
-            args.add("Energy",energy); 
-            args.add("Truncerr",spec.truncerr()); 
+            args.add(keys::AtBond,b);
+            args.add(keys::HalfSweep,ha);
+            args.add(keys::Energy,energy); 
+            args.add(keys::Truncerr,spec.truncerr()); 
 
             obs.measure(args);
 
@@ -457,6 +475,8 @@ TIMER_STOP(4);
 #endif
             }
 
+        if(release_scratch) scratchRelease();
+
         if(obs.checkDone(args)) break;
     
         } //for loop over sw
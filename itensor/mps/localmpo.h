@@ -15,6 +15,7 @@
 //
 #ifndef __ITENSOR_LOCALMPO
 #define __ITENSOR_LOCALMPO
+#include <list>
 #include "itensor/mps/mpo.h"
 #include "itensor/mps/localop.h"
 //#include "itensor/util/print_macro.h"
@@ -42,6 +43,12 @@ namespace itensor {
 //  This results in an unprojected region of
 //  num_center sites starting at site j.
 //
+//  If the MPO is kept on disk (doWrite() is true,
+//  as for toMPO with WriteToDisk=true) its site
+//  tensors are read as they are needed, and the
+//  MPOCacheSize (default 4, at least 2) most
+//  recently used ones are kept in memory.
+//
 
 class LocalMPO
     {
@@ -125,6 +132,17 @@ class LocalMPO
     ITensor
     diag() const { return lop_.diag(); }
 
+    //
+    // For a LocalMPO made from an MPS Psi,
+    // returns the conjugate of the center
+    // tensors of Psi written in the basis of
+    // the edge tensors, such that product
+    // computes phip = dag(v)*(v*phi) where
+    // v = overlapTensor()
+    //
+    ITensor
+    overlapTensor() const;
+
     //
     // position(b,psi) uses the MPS psi
     // to adjust the edge tensors such
@@ -134,6 +152,15 @@ class LocalMPO
     void
     position(int b, MPS const& psi);
 
+    //
+    // Same as position(b,psi), with psi(j) given
+    // by A[j]. Only the sites read by position are
+    // needed: j = leftLim()+1,...,b-1 and
+    // j = b+numCenter(),...,rightLim()-1
+    //
+    void
+    position(int b, std::vector<ITensor> const& A);
+
     int
     position() const;
 
@@ -155,7 +182,7 @@ class LocalMPO
     L() const { return PH_[LHlim_]; }
     // Replace left edge tensor at current bond
     void
-    L(ITensor const& nL) { PH_[LHlim_] = nL; }
+    L(ITensor const& nL) { PH_[LHlim_] = nL; lop_.clearFusion(); }
     // Replace left edge tensor bordering site j
     // (so that nL includes sites < j)
     void
@@ -166,7 +193,7 @@ class LocalMPO
     R() const { return PH_[RHlim_]; }
     // Replace right edge tensor at current bond
     void
-    R(ITensor const& nR) { PH_[RHlim_] = nR; }
+    R(ITensor const& nR) { PH_[RHlim_] = nR; lop_.clearFusion(); }
     // Replace right edge tensor bordering site j
     // (so that nR includes sites > j)
     void
@@ -237,14 +264,29 @@ class LocalMPO
 
     const MPS* Psi_;
 
+    //Site tensors of an MPO kept on disk,
+    //most recently used first
+    mutable std::list<std::pair<int,ITensor>> wcache_;
+    size_t wcache_size_ = 4;
+
     //
     /////////////////
 
+    ITensor const&
+    W(int j) const;
+
+    //psi(j) returns the j'th MPS tensor
+    template<typename PsiA>
+    void
+    positionImpl(int b, PsiA const& psi);
+
+    template<typename PsiA>
     void
-    makeL(const MPS& psi, int k);
+    makeL(PsiA const& psi, int k);
 
+    template<typename PsiA>
     void
-    makeR(const MPS& psi, int k);
+    makeR(PsiA const& psi, int k);
 
     void
     setLHlim(int val);
@@ -280,8 +322,10 @@ LocalMPO(const MPO& H,
       LHlim_(0),
       RHlim_(H.length()+1),
       nc_(2),
+      lop_(args),
       Psi_(0)
     { 
+    wcache_size_ = std::max(2l,args.getInt("MPOCacheSize",4));
     if(args.defined("NumCenter"))
         numCenter(args.getInt("NumCenter"));
     }
@@ -308,6 +352,7 @@ LocalMPO(const ITensor& LH, const ITensor& RH,
       LHlim_(0),
       RHlim_(1),
       nc_(0),
+      lop_(args),
       Psi_(0)
     { 
     PH_[0] = LH;
@@ -324,14 +369,16 @@ LocalMPO(const MPO& H,
       LHlim_(0),
       RHlim_(H.length()+1),
       nc_(2),
+      lop_(args),
       Psi_(0)
     { 
+    wcache_size_ = std::max(2l,args.getInt("MPOCacheSize",4));
     PH_[0] = LH;
     PH_[H.length()+1] = RH;
     if(H.length() == 1)
-        lop_.update(Op_->A(1), L(), R());
+        lop_.update(W(1), L(), R());
 	else if(H.length() == 2)
-        lop_.update(Op_->A(1), Op_->A(2), L(), R());
+        lop_.update(W(1), W(2), L(), R());
     if(args.defined("NumCenter"))
         numCenter(args.getInt("NumCenter"));
     }
@@ -366,14 +413,16 @@ LocalMPO(MPO const& H,
       LHlim_(LHlim),
       RHlim_(RHlim),
       nc_(2),
+      lop_(args),
       Psi_(0)
     { 
+    wcache_size_ = std::max(2l,args.getInt("MPOCacheSize",4));
     PH_.at(LHlim) = LH;
     PH_.at(RHlim) = RH;
     if(H.length() == 1)
-        lop_.update(Op_->A(1), L(), R());
+        lop_.update(W(1), L(), R());
     if(H.length() == 2) 
-        lop_.update(Op_->A(1), Op_->A(2), L(), R());
+        lop_.update(W(1), W(2), L(), R());
     if(args.defined("NumCenter")) numCenter(args.getInt("NumCenter"));
     }
 
@@ -388,33 +437,8 @@ product(ITensor const& phi,
     else 
     if(Psi_ != 0)
         {
-        int b = position();
- 
-        ITensor othr;
-        if(nc_ == 2)
-            {
-            othr = (!L() ? dag(prime(Psi_->A(b),"Link")) : L()*dag(prime(Psi_->A(b),"Link")));
-            othr *= (!R() ? dag(prime(Psi_->A(b+1),"Link")) : R()*dag(prime(Psi_->A(b+1),"Link")));
-            }
-        else if(nc_ == 1)
-            {
-            othr = (!L() ? dag(prime(Psi_->A(b),"Link")) : L()*dag(prime(Psi_->A(b),"Link")));
-            if(R()) othr *= R();	
-            }
-        else if(nc_ == 0)
-            {
-            if(!L())
-                {
-                if(!R()) Error("LocalMPO: Empty L() and R() in function product");
-                else othr = R();
-                }
-            else
-                {
-                othr = L();
-                if(R()) othr *= R();
-                }
-            }
-        
+        auto othr = overlapTensor();
+
         auto z = (othr*phi).eltC();
 
         phip = dag(othr);
@@ -426,11 +450,45 @@ product(ITensor const& phi,
         }
     }
 
+ITensor inline LocalMPO::
+overlapTensor() const
+    {
+    if(Psi_ == 0) Error("LocalMPO::overlapTensor: LocalMPO not made from an MPS");
+    int b = position();
+
+    ITensor othr;
+    if(nc_ == 2)
+        {
+        othr = (!L() ? dag(prime(Psi_->A(b),"Link")) : L()*dag(prime(Psi_->A(b),"Link")));
+        othr *= (!R() ? dag(prime(Psi_->A(b+1),"Link")) : R()*dag(prime(Psi_->A(b+1),"Link")));
+        }
+    else if(nc_ == 1)
+        {
+        othr = (!L() ? dag(prime(Psi_->A(b),"Link")) : L()*dag(prime(Psi_->A(b),"Link")));
+        if(R()) othr *= R();
+        }
+    else if(nc_ == 0)
+        {
+        if(!L())
+            {
+            if(!R()) Error("LocalMPO: Empty L() and R() in function overlapTensor");
+            else othr = R();
+            }
+        else
+            {
+            othr = L();
+            if(R()) othr *= R();
+            }
+        }
+    return othr;
+    }
+
 void inline LocalMPO::
 L(int j, ITensor const& nL)
     {
     if(LHlim_ > j-1) setLHlim(j-1);
     PH_[LHlim_] = nL;
+    lop_.clearFusion();
     }
 
 void inline LocalMPO::
@@ -438,10 +496,24 @@ R(int j, ITensor const& nR)
     {
     if(RHlim_ < j+1) setRHlim(j+1);
     PH_[RHlim_] = nR;
+    lop_.clearFusion();
     }
 
 inline void LocalMPO::
 position(int b, MPS const& psi)
+    {
+    positionImpl(b,[&psi](int j) -> ITensor const& { return psi(j); });
+    }
+
+inline void LocalMPO::
+position(int b, std::vector<ITensor> const& A)
+    {
+    positionImpl(b,[&A](int j) -> ITensor const& { return A.at(j); });
+    }
+
+template<typename PsiA>
+void LocalMPO::
+positionImpl(int b, PsiA const& psi)
     {
     if(!(*this)) Error("LocalMPO is null");
 
@@ -461,9 +533,9 @@ position(int b, MPS const& psi)
     if(Op_ != 0) //normal MPO case
         {
         if(nc_ == 2)
-            lop_.update(Op_->A(b), Op_->A(b+1), L(), R());
+            lop_.update(W(b), W(b+1), L(), R());
         else if(nc_ == 1)
-            lop_.update(Op_->A(b), L(), R());
+            lop_.update(W(b), L(), R());
         else if(nc_ == 0)
             lop_.update(L(),R());
         }
@@ -503,15 +575,15 @@ shift(int j,
         auto& E = PH_.at(LHlim_);
         auto& nE = PH_.at(j);
         nE = E * A;
-        nE *= Op_->A(j);
+        nE *= W(j);
         nE *= dag(prime(A));
         setLHlim(j);
         setRHlim(j+nc_+1);
 
         if(nc_ == 2)
-            lop_.update(Op_->A(j+1), Op_->A(j+2), L(), R());
+            lop_.update(W(j+1), W(j+2), L(), R());
         else if(nc_ == 1)
-            lop_.update(Op_->A(j+1), L(), R());
+            lop_.update(W(j+1), L(), R());
         else if(nc_ == 0)
             lop_.update(L(), R());
         }
@@ -525,22 +597,23 @@ shift(int j,
         auto& E = PH_.at(RHlim_);
         auto& nE = PH_.at(j);
         nE = E * A;
-        nE *= Op_->A(j);
+        nE *= W(j);
         nE *= dag(prime(A));
         setLHlim(j-nc_-1);
         setRHlim(j);
 	
         if(nc_ == 2)
-            lop_.update(Op_->A(j-2), Op_->A(j-1), L(), R());
+            lop_.update(W(j-2), W(j-1), L(), R());
         else if(nc_ == 1)
-            lop_.update(Op_->A(j-1), L(), R());
+            lop_.update(W(j-1), L(), R());
         else if(nc_ == 0)
             lop_.update(L(), R());
         }
     }
 
-inline void LocalMPO::
-makeL(MPS const& psi, int k)
+template<typename PsiA>
+void LocalMPO::
+makeL(PsiA const& psi, int k)
     {
     if(!PH_.empty())
         {
@@ -567,7 +640,7 @@ makeL(MPS const& psi, int k)
                     {
                     PH_.at(ll+1) = psi(ll+1);
                     }
-                PH_.at(ll+1) *= Op_->A(ll+1);
+                PH_.at(ll+1) *= W(ll+1);
                 PH_.at(ll+1) *= dag(prime(psi(ll+1)));
                 setLHlim(ll+1);
                 }
@@ -575,8 +648,9 @@ makeL(MPS const& psi, int k)
         }
     }
 
-inline void LocalMPO::
-makeR(MPS const& psi, int k)
+template<typename PsiA>
+void LocalMPO::
+makeR(PsiA const& psi, int k)
     {
     if(!PH_.empty())
         {
@@ -607,7 +681,7 @@ makeR(MPS const& psi, int k)
                     {
                     PH_.at(rl-1) = psi(rl-1);
                     }
-                PH_.at(rl-1) *= Op_->A(rl-1);
+                PH_.at(rl-1) *= W(rl-1);
                 PH_.at(rl-1) *= dag(prime(psi(rl-1)));
                 //printfln("PH[%d] = \n%s",rl-1,PH_.at(rl-1));
                 //PAUSE
@@ -617,6 +691,23 @@ makeR(MPS const& psi, int k)
         }
     }
 
+//Tensors held by lop_ stay valid until the next call,
+//since any call moving it reuses or reads at most two
+inline ITensor const& LocalMPO::
+W(int j) const
+    {
+    if(!Op_->doWrite()) return Op_->A(j);
+    for(auto it = wcache_.begin(); it != wcache_.end(); ++it)
+        {
+        if(it->first != j) continue;
+        wcache_.splice(wcache_.begin(),wcache_,it);
+        return wcache_.front().second;
+        }
+    wcache_.emplace_front(j,Op_->loadSite(j));
+    if(wcache_.size() > wcache_size_) wcache_.pop_back();
+    return wcache_.front().second;
+    }
+
 void inline LocalMPO::
 setLHlim(int val)
     {
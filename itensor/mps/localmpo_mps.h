@@ -15,10 +15,28 @@
 //
 #ifndef __ITENSOR_LOCALMPO_MPS
 #define __ITENSOR_LOCALMPO_MPS
+#include <future>
 #include "itensor/mps/localmpo.h"
 
 namespace itensor {
 
+//
+// LocalMPO_MPS projects H + weight*sum_j |psi_j><psi_j|
+// into the reduced Hilbert space of the center sites,
+// as used by dmrg to find excited states orthogonal to
+// the states psi_j.
+//
+// The overlap of each psi_j with the center sites is a
+// fixed tensor v_j for a given position, so position()
+// computes the v_j once, and product() only needs the
+// scalars v_j*phi and a scaled addition per state.
+// With the argument NThread (default 1), position()
+// updates the edge tensors of H and of the states
+// on up to NThread threads. The tensors of psi they
+// need are read before the threads start, so psi may
+// be kept on disk.
+//
+
 class LocalMPO_MPS
     {
     private:
@@ -30,7 +48,11 @@ class LocalMPO_MPS
     //LocalMPO objects representing projected version
     //of each MPS in psis_
     std::vector<LocalMPO> lmps_;
+    //Overlap tensors of the states
+    //at the current position
+    std::vector<ITensor> ovs_;
     Real weight_ = 1;
+    int nthread_ = 1;
     public:
 
     LocalMPO_MPS(Args const& args = Args::global()) { }
@@ -95,7 +117,9 @@ LocalMPO_MPS(MPO const& Op,
              Args const& args)
   : Op_(&Op),
     lmps_(psis.size()),
-    weight_(args.getReal("Weight",1))
+    ovs_(psis.size()),
+    weight_(args.getReal("Weight",1)),
+    nthread_(args.getInt("NThread",1))
     { 
     lmpo_ = LocalMPO(Op);
 
@@ -115,7 +139,9 @@ LocalMPO_MPS(MPO const& Op,
              Args const& args)
   : Op_(&Op),
     lmps_(psis.size()),
-    weight_(args.getReal("Weight",1))
+    ovs_(psis.size()),
+    weight_(args.getReal("Weight",1)),
+    nthread_(args.getInt("NThread",1))
     { 
     lmpo_ = LocalMPO(Op,LOp,ROp,args);
 #ifdef DEBUG
@@ -135,23 +161,81 @@ product(ITensor const& phi,
     {
     lmpo_.product(phi,phip);
 
-    ITensor outer;
-    for(auto& M : lmps_)
+    //Overlaps first, so that phi is read once
+    //per state before phip is modified
+    auto z = std::vector<Cplx>(ovs_.size());
+    for(auto j : range(ovs_))
+        {
+        z[j] = weight_*eltC(ovs_[j]*phi);
+        }
+    for(auto j : range(ovs_))
         {
-        M.product(phi,outer);
-        outer *= weight_;
-        phip += outer;
+        //Skips states with no overlap, including
+        //those having a different QN flux than phi
+        if(z[j] == 0.) continue;
+        if(z[j].imag() != 0.) phip += z[j]*dag(ovs_[j]);
+        else                  daxpy(phip,dag(ovs_[j]),z[j].real());
         }
     }
 
 void inline LocalMPO_MPS::
 position(int b, const MPS& psi)
     {
-    lmpo_.position(b,psi);
-    for(auto& M : lmps_)
+    auto ntask = int(lmps_.size())+1;
+    auto nthread = std::max(1,std::min(nthread_,ntask));
+    if(nthread == 1)
+        {
+        lmpo_.position(b,psi);
+        for(auto n : range(lmps_.size()))
+            {
+            lmps_[n].position(b,psi);
+            ovs_[n] = lmps_[n].overlapTensor();
+            }
+        return;
+        }
+
+    //Reading psi may load its tensors from disk, so the
+    //tensors the tasks need are gathered here, before
+    //any thread starts, and the tasks only read A
+    auto A = std::vector<ITensor>(length(psi)+1);
+    auto gather = [&A,&psi,b](LocalMPO const& M)
+        {
+        for(auto j = std::max(1,M.leftLim()+1); j < b; ++j)
+            {
+            if(!A[j]) A[j] = psi(j);
+            }
+        for(auto j = b+M.numCenter(); j < M.rightLim(); ++j)
+            {
+            if(!A[j]) A[j] = psi(j);
+            }
+        };
+    gather(lmpo_);
+    for(auto& M : lmps_) gather(M);
+
+    //Task 0 moves the projected H, task n > 0 the
+    //projected state n-1, each touching only its
+    //own edge tensors
+    auto move = [this,b,&A](int n)
+        {
+        if(n == 0)
+            {
+            lmpo_.position(b,A);
+            return;
+            }
+        auto& M = lmps_[n-1];
+        M.position(b,A);
+        ovs_[n-1] = M.overlapTensor();
+        };
+    auto futs = std::vector<std::future<void>>(nthread);
+    for(auto t : range(nthread))
         {
-        M.position(b,psi);
+        futs[t] = std::async(std::launch::async,
+                  [&move,t,nthread,ntask]()
+                      {
+                      for(auto n = t; n < ntask; n += nthread) move(n);
+                      });
         }
+    for(auto& f : futs) f.get();
     }
 
 } //namespace itensor
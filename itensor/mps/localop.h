@@ -15,6 +15,7 @@
 //
 #ifndef __ITENSOR_LOCAL_OP
 #define __ITENSOR_LOCAL_OP
+#include <array>
 #include "itensor/itensor.h"
 //#include "itensor/util/print_macro.h"
 
@@ -39,16 +40,43 @@ namespace itensor {
 //  can even be null in which case
 //  they will not be used.)
 //
+// With the argument FuseOps=true, the first
+// call to product() after an update for two
+// center sites precomputes L*Op1 and Op2*R,
+// or L*Op1*Op2, or Op1*Op2*R, if a cost model
+// finds that contracting phi with them takes
+// fewer operations than applying L, Op1, Op2
+// and R in turn. These stay valid for the whole
+// local eigensolve, and can save much of the
+// m^2 k^2 d^3 cost of applying Op1 and Op2 for
+// models with small d and large k. Fused tensors
+// having more than FuseMaxSize elements in total
+// (default 5E7) are not considered.
+//
 
 
 class LocalOp
     {
+    public:
+
+    //Which products product() precomputes
+    enum Fusion { NotPlanned, NoFusion, FuseHalves, FuseLeft, FuseRight };
+
+    private:
     ITensor const* Op1_;
     ITensor const* Op2_;
     ITensor const* L_;
     ITensor const* R_;
     mutable size_t size_;
     int nc_;
+    bool fuse_ = false;
+    Real fuse_max_size_ = 5E7;
+    //FuseHalves: LF_ = L*Op1, RF_ = Op2*R
+    //FuseLeft: LF_ = L*Op1*Op2
+    //FuseRight: RF_ = Op1*Op2*R
+    mutable Fusion fusion_ = NotPlanned;
+    mutable ITensor LF_,
+                    RF_;
     public:
 
 
@@ -104,8 +132,15 @@ class LocalOp
         {
         if(val < 0 || val > 2) Error("numCenter must be set to be 0 or 1 or 2");
         nc_ = val;
+        clearFusion();
         }
 
+    //Fusion chosen by the last product()
+    //(NotPlanned if not yet called since
+    //the last update)
+    Fusion
+    fusion() const { return fusion_; }
+
     //
     // Accessor Methods
     //
@@ -170,6 +205,24 @@ class LocalOp
     bool
     RIsNull() const;
 
+    //Drops the fused tensors; to be called after
+    //changing any of Op1, Op2, L or R in place
+    void
+    clearFusion()
+        {
+        fusion_ = NotPlanned;
+        LF_ = ITensor();
+        RF_ = ITensor();
+        }
+
+    private:
+
+    void
+    readArgs(Args const& args);
+
+    void
+    planFusion() const;
+
     };
 
 inline LocalOp::
@@ -182,6 +235,7 @@ LocalOp(Args const& args)
     size_(-1)
     {
     nc_ = args.getInt("NumCenter",2);
+    readArgs(args);
     }
 
 inline LocalOp::
@@ -195,6 +249,7 @@ LocalOp(const ITensor& Op1,
     size_(-1)
     {
     nc_ = args.getInt("NumCenter",2);
+    readArgs(args);
     if(nc_ == 1)	
       updateOp(Op1);
     else
@@ -212,6 +267,7 @@ LocalOp(const ITensor& Op1, const ITensor& Op2,
     size_(-1)
     {
     nc_ = args.getInt("NumCenter",2);
+    readArgs(args);
     if(nc_ == 2)
       updateOp(Op1,Op2);
     else if(nc_ == 0)
@@ -232,6 +288,7 @@ LocalOp(const ITensor& Op1,
     size_(-1)
     {
     nc_ = args.getInt("NumCenter",1);
+    readArgs(args);
     if(nc_ == 1)
       update(Op1,L,R);
     else
@@ -250,12 +307,20 @@ LocalOp(const ITensor& Op1, const ITensor& Op2,
     size_(-1)
     {
     nc_ = args.getInt("NumCenter",2);
+    readArgs(args);
     if(nc_ == 2)
       update(Op1,Op2,L,R);
     else
       Error("In LocalOp(ITensor,ITensor,ITensor,ITensor), NumCenter cannot be set other than 2");
     }
 
+void inline LocalOp::
+readArgs(Args const& args)
+    {
+    fuse_ = args.getBool("FuseOps",false);
+    fuse_max_size_ = args.getReal("FuseMaxSize",5E7);
+    }
+
 void inline LocalOp::
 updateOp(const ITensor& Op1)
     {
@@ -265,6 +330,7 @@ updateOp(const ITensor& Op1)
     R_ = nullptr;
     size_ = -1;
     nc_ = 1;
+    clearFusion();
     }
 
 void inline LocalOp::
@@ -276,6 +342,7 @@ updateOp(const ITensor& Op1, const ITensor& Op2)
     R_ = nullptr;
     size_ = -1;
     nc_ = 2;
+    clearFusion();
     }
 
 void inline LocalOp::
@@ -287,6 +354,7 @@ update(const ITensor& L, const ITensor& R)
     R_ = &R;
     size_ = -1;
     nc_ = 0;
+    clearFusion();
     }
 
 void inline LocalOp::
@@ -321,13 +389,111 @@ RIsNull() const
     return !bool(*R_);
     }
 
+//
+// Estimates the multiply-adds of one product for each
+// way of grouping the contractions, treating all
+// tensors as dense, and keeps the cheapest grouping
+// whose fused tensors fit in fuse_max_size_ elements.
+// (Computing the fused tensors costs about as much as
+// one product, and is paid once per update.)
+//
+void inline LocalOp::
+planFusion() const
+    {
+    fusion_ = NoFusion;
+    if(!fuse_ || nc_ != 2 || LIsNull() || RIsNull()) return;
+
+    auto& L = *L_;
+    auto& R = *R_;
+    auto& Op1 = *Op1_;
+    auto& Op2 = *Op2_;
+    auto linkDim = [](ITensor const& E)
+        {
+        for(auto& I : E.inds()) if(I.primeLevel() > 0) return Real(dim(I));
+        return 1.;
+        };
+    auto mL = linkDim(L),
+         mR = linkDim(R);
+    auto kL = Real(dim(commonInds(L,Op1))),
+         kM = Real(dim(commonInds(Op1,Op2))),
+         kR = Real(dim(commonInds(Op2,R)));
+    auto d1 = Real(dim(findIndex(Op1,"Site,0"))),
+         d2 = Real(dim(findIndex(Op2,"Site,0")));
+
+    struct Option
+        {
+        Fusion fusion;
+        Real cost,
+             size;
+        };
+    auto options = std::array<Option,4>
+        {{
+        //phi*L*Op1*Op2*R
+        {NoFusion,
+         mL*mL*d1*d2*mR*kL + mL*mR*d1*d1*d2*kL*kM
+         + mL*mR*d1*d2*d2*kM*kR + mL*mR*mR*d1*d2*kR,
+         0.},
+        //(phi*(L*Op1))*(Op2*R)
+        {FuseHalves,
+         mL*mL*d1*d1*d2*mR*kM + mL*mR*mR*d1*d2*d2*kM,
+         mL*mL*d1*d1*kM + mR*mR*d2*d2*kM},
+        //(phi*(L*Op1*Op2))*R
+        {FuseLeft,
+         mL*mL*d1*d1*d2*d2*mR*kR + mL*mR*mR*d1*d2*kR,
+         mL*mL*d1*d1*d2*d2*kR},
+        //(phi*L)*(Op1*Op2*R)
+        {FuseRight,
+         mL*mL*d1*d2*mR*kL + mL*mR*mR*d1*d1*d2*d2*kL,
+         mR*mR*d1*d1*d2*d2*kL}
+        }};
+    auto best = options[0];
+    for(auto& o : options)
+        {
+        if(o.size <= fuse_max_size_ && o.cost < best.cost) best = o;
+        }
+    fusion_ = best.fusion;
+
+    if(fusion_ == FuseHalves)
+        {
+        LF_ = L*Op1;
+        RF_ = Op2*R;
+        }
+    else if(fusion_ == FuseLeft)
+        {
+        LF_ = L*Op1;
+        LF_ *= Op2;
+        }
+    else if(fusion_ == FuseRight)
+        {
+        RF_ = Op2*R;
+        RF_ *= Op1;
+        }
+    }
+
 void inline LocalOp::
 product(ITensor const& phi, 
         ITensor      & phip) const
     {
     if(!(*this)) Error("LocalOp is null");
 
-    if(LIsNull())
+    if(fusion_ == NotPlanned) planFusion();
+
+    if(fusion_ == FuseHalves)
+        {
+        phip = phi * LF_;
+        phip *= RF_;
+        }
+    else if(fusion_ == FuseLeft)
+        {
+        phip = phi * LF_;
+        phip *= R();
+        }
+    else if(fusion_ == FuseRight)
+        {
+        phip = phi * L();
+        phip *= RF_;
+        }
+    else if(LIsNull())
         {
         phip = phi;
         if(!RIsNull()) 
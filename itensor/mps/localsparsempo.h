@@ -0,0 +1,330 @@
+//
+// Copyright 2018 The Simons Foundation, Inc. - All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef __ITENSOR_LOCALSPARSEMPO
+#define __ITENSOR_LOCALSPARSEMPO
+#include "itensor/mps/sparsempo.h"
+
+namespace itensor {
+
+//
+// The LocalSparseMPO class projects a SparseMPO
+// into the reduced Hilbert space of one or two
+// sites of an MPS, like LocalMPO does for an MPO.
+//
+// Instead of one edge tensor carrying the MPO link
+// index, the edges are kept as one tensor per value
+// of that index. The product then loops over the
+// nonzero entries of the exposed site tensors:
+//
+//   X[a] = phi * L[a]
+//   Y[b] = sum_a op1(a,b) X[a]
+//   Z[c] = sum_b op2(b,c) Y[b]
+//   phip = sum_c Z[c] * R[c]
+//
+// The sums over a and b cost a scaled addition of
+// m^2 d^2 elements per nonzero entry (plus a few
+// applications of each distinct site operator) in
+// place of the m^2 k^2 d^3 of contracting dense W's.
+//
+
+class LocalSparseMPO
+    {
+    SparseMPO const* Op_ = nullptr;
+    //PH_[j] holds one edge tensor per value of the
+    //MPO link bordering the projected region, with
+    //null tensors for values no term leads to
+    std::vector<std::vector<ITensor>> PH_;
+    int LHlim_ = -1,
+        RHlim_ = -1;
+    int nc_ = 2;
+    size_t size_ = 0;
+    public:
+
+    LocalSparseMPO() { }
+
+    LocalSparseMPO(SparseMPO const& H,
+                   Args const& args = Args::global());
+
+    //
+    // Sparse Matrix Methods
+    //
+
+    void
+    product(ITensor const& phi, ITensor & phip) const;
+
+    Real
+    expect(ITensor const& phi) const;
+
+    ITensor
+    deltaRho(ITensor const& AA,
+             ITensor const& combine,
+             Direction dir) const;
+
+    size_t
+    size() const { return size_; }
+
+    //
+    // position(b,psi) uses the MPS psi
+    // to adjust the edge tensors such
+    // that the MPO tensors at positions
+    // b (and b+1 if numCenter() == 2)
+    // are exposed
+    //
+    void
+    position(int b, MPS const& psi);
+
+    int
+    position() const;
+
+    //
+    // Accessor Methods
+    //
+
+    void
+    reset()
+        {
+        LHlim_ = 0;
+        RHlim_ = Op_->length()+1;
+        }
+
+    SparseMPO const&
+    H() const
+        {
+        if(!Op_) Error("LocalSparseMPO is null");
+        return *Op_;
+        }
+
+    int
+    numCenter() const { return nc_; }
+    void
+    numCenter(int val)
+        {
+        if(val < 1 || val > 2) Error("numCenter must be set to 1 or 2");
+        nc_ = val;
+        }
+
+    explicit operator bool() const { return Op_ != nullptr; }
+
+    bool
+    doWrite() const { return false; }
+    void
+    doWrite(bool val,
+            Args const& args = Args::global())
+        {
+        if(val) Error("Write to disk not supported for LocalSparseMPO");
+        }
+
+    int
+    leftLim() const { return LHlim_; }
+
+    int
+    rightLim() const { return RHlim_; }
+
+    private:
+
+    //Returns T times each edge tensor at lim,
+    //or just T if lim is past the end of H
+    std::vector<ITensor>
+    applyEdge(int lim, ITensor const& T) const;
+
+    void
+    makeL(MPS const& psi, int k);
+
+    void
+    makeR(MPS const& psi, int k);
+
+    std::vector<ITensor>
+    applyCenter(ITensor const& phi, Direction dir) const;
+    };
+
+inline LocalSparseMPO::
+LocalSparseMPO(SparseMPO const& H,
+               Args const& args)
+    : Op_(&H),
+      PH_(H.length()+2),
+      LHlim_(0),
+      RHlim_(H.length()+1)
+    {
+    if(args.defined("NumCenter"))
+        numCenter(args.getInt("NumCenter"));
+    }
+
+inline std::vector<ITensor> LocalSparseMPO::
+applyEdge(int lim, ITensor const& T) const
+    {
+    if(lim < 1 || lim > Op_->length()) return {T};
+    auto& E = PH_.at(lim);
+    auto X = std::vector<ITensor>(E.size());
+    for(auto a : range(E))
+        {
+        if(E[a]) X[a] = T*E[a];
+        }
+    return X;
+    }
+
+//Applies the left edge and the first center site to phi
+//(dir == Fromleft) or the right edge and the last center
+//site (dir == Fromright)
+inline std::vector<ITensor> LocalSparseMPO::
+applyCenter(ITensor const& phi, Direction dir) const
+    {
+    auto& H = *Op_;
+    auto b = position();
+    if(dir == Fromleft)
+        {
+        auto X = applyEdge(LHlim_,phi);
+        return detail::applyTerms(H,b,X);
+        }
+    auto j = b+nc_-1;
+    auto X = applyEdge(RHlim_,phi);
+    return detail::applyTerms(H,j,X,true);
+    }
+
+void inline LocalSparseMPO::
+product(ITensor const& phi,
+        ITensor & phip) const
+    {
+    if(!(*this)) Error("LocalSparseMPO is null");
+    auto& H = *Op_;
+    auto b = position();
+
+    auto X = applyCenter(phi,Fromleft);
+    if(nc_ == 2) X = detail::applyTerms(H,b+1,X);
+
+    phip = ITensor();
+    if(RHlim_ > H.length())
+        {
+        phip = X.front();
+        }
+    else
+        {
+        auto& R = PH_.at(RHlim_);
+        for(auto c : range(X))
+            {
+            if(X[c] && R[c]) phip += X[c]*R[c];
+            }
+        }
+    if(!phip) Error("LocalSparseMPO: product is zero, the SparseMPO has no path through the center sites");
+    phip.noPrime();
+    }
+
+Real inline LocalSparseMPO::
+expect(ITensor const& phi) const
+    {
+    ITensor phip;
+    product(phi,phip);
+    return real(eltC(dag(phip) * phi));
+    }
+
+ITensor inline LocalSparseMPO::
+deltaRho(ITensor const& AA,
+         ITensor const& combine,
+         Direction dir) const
+    {
+    if(nc_ != 2)
+        {
+        Error("LocalSparseMPO: currently only support 2 center sites in deltaRho");
+        }
+
+    //Sum over the values of the MPO link between the
+    //center sites of each term's contribution
+    auto Y = applyCenter(AA,dir);
+    ITensor drho;
+    for(auto& y : Y)
+        {
+        if(!y) continue;
+        auto d = combine * noPrime(y);
+        auto ci = commonIndex(combine,d);
+        d *= dag(prime(d,ci));
+        drho += d;
+        }
+
+    //Expedient to ensure drho is Hermitian
+    drho = drho + dag(swapTags(drho,"0","1"));
+    drho /= 2.;
+
+    return drho;
+    }
+
+inline void LocalSparseMPO::
+position(int b, MPS const& psi)
+    {
+    if(!(*this)) Error("LocalSparseMPO is null");
+
+    makeL(psi,b-1);
+    makeR(psi,b+nc_);
+
+    LHlim_ = b-1; //not redundant since LHlim_ could be > b-1
+    RHlim_ = b+nc_; //not redundant since RHlim_ could be < b+nc_
+
+    auto dimOf = [](Index const& i) { return i ? size_t(dim(i)) : size_t(1); };
+    size_ = dimOf(leftLinkIndex(psi,b))*dimOf(rightLinkIndex(psi,b+nc_-1));
+    for(auto j : range(b,b+nc_)) size_ *= dimOf(siteIndex(psi,j));
+    }
+
+int inline LocalSparseMPO::
+position() const
+    {
+    if(RHlim_-LHlim_ != (nc_+1))
+        {
+        throw ITError("LocalSparseMPO position not set");
+        }
+    return LHlim_+1;
+    }
+
+inline void LocalSparseMPO::
+makeL(MPS const& psi, int k)
+    {
+    auto& H = *Op_;
+    while(LHlim_ < k)
+        {
+        auto j = LHlim_+1;
+        auto X = applyEdge(LHlim_,psi(j));
+        auto U = detail::applyTerms(H,j,X);
+        auto pA = dag(prime(psi(j),"Link"));
+        auto& nL = PH_.at(j);
+        nL.assign(U.size(),ITensor());
+        for(auto a : range(U))
+            {
+            if(U[a]) nL[a] = U[a]*pA;
+            }
+        LHlim_ = j;
+        }
+    }
+
+inline void LocalSparseMPO::
+makeR(MPS const& psi, int k)
+    {
+    auto& H = *Op_;
+    while(RHlim_ > k)
+        {
+        auto j = RHlim_-1;
+        auto X = applyEdge(RHlim_,psi(j));
+        auto U = detail::applyTerms(H,j,X,true);
+        auto pA = dag(prime(psi(j),"Link"));
+        auto& nR = PH_.at(j);
+        nR.assign(U.size(),ITensor());
+        for(auto a : range(U))
+            {
+            if(U[a]) nR[a] = U[a]*pA;
+            }
+        RHlim_ = j;
+        }
+    }
+
+} //namespace itensor
+
+#endif
@@ -0,0 +1,133 @@
+//
+// Copyright 2018 The Simons Foundation, Inc. - All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include <future>
+#include <limits>
+#include <random>
+#include "itensor/mps/metts.h"
+
+namespace itensor {
+
+using std::vector;
+using std::string;
+
+MPS
+productState(SiteSet const& sites,
+             vector<int> const& config,
+             string const& basis)
+    {
+    auto N = length(sites);
+    if(int(config.size()) != N) Error("productState: wrong number of sites in config");
+    auto state = InitState(sites);
+    if(basis == "Z")
+        {
+        for(auto j : range1(N)) state.set(j,config[j-1]);
+        return MPS(state);
+        }
+    if(basis != "X") Error("productState: unrecognized basis " + basis);
+    if(hasQNs(sites)) Error("productState: basis \"X\" requires sites without QNs");
+
+    auto psi = MPS(state);
+    for(auto j : range1(N))
+        {
+        auto s = sites(j);
+        if(dim(s) != 2) Error("productState: basis \"X\" requires sites of dimension 2");
+        auto v = ITensor(s);
+        v.set(1,1./std::sqrt(2.));
+        v.set(2,(config[j-1] == 1 ? 1. : -1.)/std::sqrt(2.));
+        //Keep the link indices of psi(j)
+        psi.ref(j) = v*(psi(j)*setElt(dag(s)=1));
+        }
+    return psi;
+    }
+
+void
+metts(SiteSet const& sites,
+      MettsEvolver const& evolve,
+      MettsMeasure const& measure,
+      Args const& args)
+    {
+    auto N = length(sites);
+    auto nchain = args.getInt("NChain",1);
+    auto nstep = args.getInt("NStep",10);
+    auto nwarm = args.getInt("NWarm",2);
+    auto nthread = std::max(1l,std::min(nchain,args.getInt("NThread",nchain)));
+    auto basis = args.getString("Basis",hasQNs(sites) ? "Z" : "ZX");
+    if(basis != "Z" && basis != "X" && basis != "ZX") Error("metts: unrecognized basis " + basis);
+    auto seed = args.defined("Seed") ? args.getInt("Seed")
+                                     : long(Global::random()*std::numeric_limits<int>::max());
+
+    auto runChain = [&](int c)
+        {
+        auto rng = std::mt19937(seed+c);
+        auto first = (basis == "X" ? "X" : "Z");
+        auto config = vector<int>(N);
+        for(auto j : range1(N))
+            {
+            auto dist = std::uniform_int_distribution<int>(1,dim(sites(j)));
+            config[j-1] = dist(rng);
+            }
+        auto phi = productState(sites,config,first);
+        for(auto step : range(nwarm+nstep))
+            {
+            evolve(phi);
+            if(step >= nwarm) measure(c,step-nwarm,phi);
+            auto b = (basis == "ZX" ? (step%2 == 0 ? "X" : "Z") : basis);
+            config = sample(phi,1,rng,{"Basis=",b}).front();
+            phi = productState(sites,config,b);
+            }
+        };
+
+    if(nthread == 1)
+        {
+        for(auto c : range(nchain)) runChain(c);
+        return;
+        }
+    auto futs = vector<std::future<void>>(nthread);
+    for(auto t : range(nthread))
+        {
+        futs[t] = std::async(std::launch::async,
+                  [&runChain,t,nthread,nchain]()
+                      {
+                      for(auto c = t; c < nchain; c += nthread) runChain(c);
+                      });
+        }
+    for(auto& f : futs) f.get();
+    }
+
+void
+metts(SiteSet const& sites,
+      MPO const& H,
+      Real beta,
+      MettsMeasure const& measure,
+      Args const& args)
+    {
+    auto tau = args.getReal("Tau",0.1);
+    auto nt = int(beta/(2*tau)+0.5);
+    if(nt < 1 || std::fabs(nt*tau-beta/2) > 1E-9) Error("metts: beta/2 not a multiple of Tau");
+    auto evolve = [&H,tau,nt,&args](MPS & phi)
+        {
+        for(int n = 1; n <= nt; ++n)
+            {
+            auto res = phi;
+            applyExpH(phi,H,tau,res,args);
+            phi = res;
+            phi.normalize();
+            }
+        };
+    metts(sites,evolve,measure,args);
+    }
+
+} //namespace itensor
@@ -0,0 +1,119 @@
+//
+// Copyright 2018 The Simons Foundation, Inc. - All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef __ITENSOR_METTS_H
+#define __ITENSOR_METTS_H
+
+#include <functional>
+#include "itensor/mps/mpo.h"
+#include "itensor/mps/tevol.h"
+
+namespace itensor {
+
+//
+// Minimally entangled typical thermal states (METTS)
+// at inverse temperature beta.
+//
+// Each chain starts from a random product state |i> and
+// repeats the steps
+//   1. |phi> = exp(-beta*H/2)|i> / norm, done by evolve(phi)
+//   2. measure(chain,step,phi), unless step is a warmup step
+//   3. draw a new product state |i> from |<i|phi>|^2
+// Averages of the measured values over all steps of all
+// chains are thermal expectation values.
+//
+// Chains are independent and are run on separate threads;
+// the random number generator of chain c is seeded with
+// Seed+c, so results do not depend on the number of threads.
+// measure is called concurrently from different threads, but
+// never concurrently for the same chain.
+//
+// Args:
+// "NChain" (default 1): number of independent chains
+// "NStep" (default 10): measured steps per chain
+// "NWarm" (default 2): unmeasured steps at the start of each chain
+// "NThread" (default NChain): number of threads running chains
+// "Basis": "Z", "X" or "ZX" (default "ZX", or "Z" if sites has
+//     QNs): basis of the product states, "ZX" alternating
+//     between "Z" and "X" (see sample). The "X" basis
+//     breaks QN conservation and requires sites without QNs.
+// "Seed" (default taken from Global::random, so fixed by seedRNG)
+//
+using MettsEvolver = std::function<void(MPS&)>;
+using MettsMeasure = std::function<void(int chain, int step, MPS const& phi)>;
+
+void
+metts(SiteSet const& sites,
+      MettsEvolver const& evolve,
+      MettsMeasure const& measure,
+      Args const& args = Args::global());
+
+//
+// METTS with exp(-beta*H/2) applied by gateTEvol, using
+// the gates in gatelist with time step tstep. args are also
+// passed to gateTEvol (for example "Cutoff" and "MaxDim").
+//
+template <class Iterable>
+void
+metts(SiteSet const& sites,
+      Iterable const& gatelist,
+      Real beta,
+      Real tstep,
+      MettsMeasure const& measure,
+      Args const& args = Args::global());
+
+//
+// METTS with exp(-beta*H/2) applied in steps of
+// "Tau" (default 0.1) by applyExpH. args are also passed
+// to applyExpH (for example "Cutoff" and "MaxDim").
+//
+void
+metts(SiteSet const& sites,
+      MPO const& H,
+      Real beta,
+      MettsMeasure const& measure,
+      Args const& args = Args::global());
+
+//Product state of sites given by a configuration
+//drawn by sample in the basis "Z" or "X"
+MPS
+productState(SiteSet const& sites,
+             std::vector<int> const& config,
+             std::string const& basis = "Z");
+
+//
+//
+// Implementations
+//
+
+template <class Iterable>
+void
+metts(SiteSet const& sites,
+      Iterable const& gatelist,
+      Real beta,
+      Real tstep,
+      MettsMeasure const& measure,
+      Args const& args)
+    {
+    auto evolve = [&gatelist,beta,tstep,&args](MPS & phi)
+        {
+        gateTEvol(gatelist,beta/2,tstep,phi,{args,"Verbose=",false});
+        };
+    metts(sites,evolve,measure,args);
+    }
+
+} //namespace itensor
+
+#endif
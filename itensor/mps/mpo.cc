@@ -256,7 +256,10 @@ replaceSiteInds(IndexSet const& sites_old, IndexSet const& sites_new)
     if( itensor::length(sites_new)!=N ) Error("In replaceSiteInds(MPO,IndexSet,IndexSet), number of new sites must be equal length of MPO");
     if( itensor::hasSiteInds(A,sites_new) ) return A;
     for( auto n : range1(N) )
+        {
+        applyRelabel(n);
         A_[n].replaceInds({sites_old(n)},{sites_new(n)});
+        }
     return A;
     }
 
@@ -52,6 +52,8 @@ class MPO : protected MPS
     using Parent::set;
 
     using Parent::doWrite;
+    using Parent::writeDir;
+    using Parent::loadSite;
 
     using Parent::read;
     using Parent::write;
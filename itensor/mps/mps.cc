@@ -68,7 +68,8 @@ MPS(int N)
     r_orth_lim_(N+1),
     atb_(1),
     writedir_("./"),
-    do_write_(false)
+    do_write_(false),
+    relabel_(N+2)
     { 
     }
 
@@ -82,7 +83,8 @@ MPS(SiteSet const& sites,
     r_orth_lim_(sites.length()+1),
     atb_(1),
     writedir_("./"),
-    do_write_(false)
+    do_write_(false),
+    relabel_(sites.length()+2)
     { 
     new_tensors(A_,sites,m);
     }
@@ -97,7 +99,8 @@ MPS(IndexSet const& sites,
     r_orth_lim_(sites.length()+1),
     atb_(1),
     writedir_("./"),
-    do_write_(false)
+    do_write_(false),
+    relabel_(sites.length()+2)
     {
     new_tensors(A_,sites,m);
     }
@@ -111,7 +114,8 @@ MPS(InitState const& initState)
     r_orth_lim_(2),
     atb_(1),
     writedir_("./"),
-    do_write_(false)
+    do_write_(false),
+    relabel_(initState.sites().length()+2)
     { 
     init_tensors(A_,initState);
     }
@@ -125,7 +129,8 @@ MPS(MPS const& other)
     r_orth_lim_(other.r_orth_lim_),
     atb_(other.atb_),
     writedir_(other.writedir_),
-    do_write_(other.do_write_)
+    do_write_(other.do_write_),
+    relabel_(other.relabel_)
     { 
     copyWriteDir();
     }
@@ -140,6 +145,7 @@ operator=(MPS const& other)
     atb_ = other.atb_;
     writedir_ = other.writedir_;
     do_write_ = other.do_write_;
+    relabel_ = other.relabel_;
 
     copyWriteDir();
     return *this;
@@ -295,6 +301,7 @@ operator()(int i) const
     { 
     if(i < 0) i = N_+i+1;
     setSite(i);
+    applyRelabel(i);
     return A_.at(i); 
     }
 
@@ -303,6 +310,7 @@ ref(int i)
     { 
     if(i < 0) i = N_+i+1;
     setSite(i);
+    applyRelabel(i);
     if(i <= l_orth_lim_) l_orth_lim_ = i-1;
     if(i >= r_orth_lim_) r_orth_lim_ = i+1;
     return A_.at(i); 
@@ -313,6 +321,7 @@ uref(int i)
     {
     if(do_write_)
         Error("replaceTags not supported if doWrite(true)");
+    applyRelabel(i);
     return A_.at(i);
     }
 
@@ -341,7 +350,11 @@ doWrite(bool val, Args const& args)
         }
     else
         {
+        //The tensors on disk are as up to date as
+        //recorded in relabel_, so keep it across read()
+        auto relabel = relabel_;
         read(writedir_);
+        relabel_ = std::move(relabel);
         cleanupWrite();
         }
     }
@@ -356,6 +369,7 @@ read(std::istream & s)
         {
         itensor::read(s,A_[j]);
         }
+    relabel_ = detail::LazyRelabel(A_.size());
     itensor::read(s,l_orth_lim_);
     itensor::read(s,r_orth_lim_);
     }
@@ -369,6 +383,7 @@ write(std::ostream& s) const
     itensor::write(s,length());
     for(auto j : range(A_.size()))
         {
+        applyRelabel(j);
         itensor::write(s,A_[j]);
         }
     itensor::write(s,leftLim());
@@ -389,9 +404,26 @@ read(std::string const& dirname)
         {
     	readFromFile(AFName(j,dirname),A_.at(j));
         }
+    relabel_ = detail::LazyRelabel(A_.size());
     }
 
 
+ITensor MPS::
+loadSite(int j) const
+    {
+    if(!do_write_) return (*this)(j);
+    if(A_.at(j))
+        {
+        applyRelabel(j);
+        return A_[j];
+        }
+    //Let operator() load it and apply the relabelings
+    if(relabel_.pending(j)) return (*this)(j);
+    auto T = ITensor();
+    readFromFile(AFName(j),T);
+    return T;
+    }
+
 string MPS::
 AFName(int j, string const& dirname) const
     { 
@@ -478,11 +510,10 @@ setBond(int b) const
 void MPS::
 setSite(int j) const
     {
-    if(!do_write_)
-        {
-        atb_ = (j > atb_ ? j-1 : j);
-        return;
-        }
+    //Nothing is loaded if the tensors are all in
+    //memory, and atb_ is left alone so that const
+    //reads from several threads do not write to it
+    if(!do_write_) return;
     if(j < 1 || j > N_) return;
 
     if(j < atb_)
@@ -652,12 +683,32 @@ orthMPS(ITensor& A1, ITensor& A2, Direction dir, Args const& args)
         Print(inds(L));
         }
 
-    ITensor A,B(bnd);
-    ITensor D;
-    auto spec = svd(L,A,D,B,args);
+    //Truncating is left to the svd, which keeps the
+    //largest singular values and reports them in the
+    //Spectrum; without truncation a QR is enough
+    auto truncate = args.defined("Truncate") ? args.getBool("Truncate")
+                                              : (args.defined("Cutoff") || args.defined("MaxDim"));
+    if(truncate || args.getBool("UseSVD",false))
+        {
+        ITensor A,B(bnd);
+        ITensor D;
+        auto spec = svd(L,A,D,B,args);
 
-    L = A;
-    R *= (D*B);
+        L = A;
+        R *= (D*B);
+
+        return spec;
+        }
+
+    //A QR of the single tensor L is enough to move the
+    //gauge, and is much cheaper than an svd
+    ITensor Q(uniqueInds(L,{R})),
+            Rm;
+    auto spec = rrqr(L,Q,Rm,{args,"Tags=",getTagSet(args,"LeftTags","Link,U"),
+                                  "Truncate=",false});
+
+    L = Q;
+    R *= Rm;
 
     return spec;
     }
@@ -751,6 +802,15 @@ orthogonalize(Args args)
 
     if(doWrite()) Error("Cannot call orthogonalize when doWrite()==true");
 
+    if(not args.getBool("Truncate",true))
+        {
+        //Without truncation a single sweep of QR
+        //decompositions toward site 1 is enough
+        l_orth_lim_ = 0;
+        r_orth_lim_ = N_+1;
+        return position(1);
+        }
+
     auto& psi = *this;
     auto N = N_;
 
@@ -967,6 +1027,7 @@ swap(MPS& other)
     std::swap(atb_,other.atb_);
     std::swap(writedir_,other.writedir_);
     std::swap(do_write_,other.do_write_);
+    std::swap(relabel_,other.relabel_);
     }
 
 InitState::
@@ -998,6 +1059,14 @@ set(int i, const String& state)
     return *this;
     }
 
+InitState& InitState::
+set(int i, int val)
+    { 
+    checkRange(i);
+    state_.at(i) = sites_(i)(val);
+    return *this;
+    }
+
 InitState& InitState::
 setAll(String const& state)
     { 
@@ -15,6 +15,11 @@
 //
 #ifndef __ITENSOR_MPS_H
 #define __ITENSOR_MPS_H
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <tuple>
 #include "itensor/decomp.h"
 #include "itensor/mps/siteset.h"
 
@@ -23,6 +28,117 @@ namespace itensor {
 // Some forward definitions
 class InitState;
 
+namespace detail {
+
+//
+// Relabelings (tag, prime and dag operations) applied to
+// every tensor of an MPS or MPO. Each one is recorded once
+// and carried out on a tensor only when that tensor is next
+// accessed, so relabeling costs O(1) no matter the length
+// and works for MPS whose tensors are kept on disk.
+//
+// Since const accessors carry out the relabelings, each
+// tensor has its own lock: several threads may read the
+// same MPS at once. Recording a relabeling (push) must not
+// overlap with reads.
+//
+class LazyRelabel
+    {
+    public:
+    using Op = std::function<void(ITensor&)>;
+    private:
+    struct Tensor
+        {
+        //number of ops_ applied to the tensor
+        std::atomic<size_t> done{0};
+        std::mutex mutex;
+        };
+    std::vector<Op> ops_;
+    std::unique_ptr<Tensor[]> t_;
+    size_t size_ = 0;
+    public:
+
+    LazyRelabel() { }
+
+    explicit
+    LazyRelabel(size_t ntensor)
+      : t_(std::make_unique<Tensor[]>(ntensor)),
+        size_(ntensor)
+        { }
+
+    LazyRelabel(LazyRelabel const& other) { *this = other; }
+
+    LazyRelabel(LazyRelabel &&) = default;
+
+    LazyRelabel&
+    operator=(LazyRelabel const& other)
+        {
+        if(this == &other) return *this;
+        ops_ = other.ops_;
+        size_ = other.size_;
+        t_ = std::make_unique<Tensor[]>(size_);
+        for(auto i : range(size_)) t_[i].done = other.t_[i].done.load();
+        return *this;
+        }
+
+    LazyRelabel&
+    operator=(LazyRelabel &&) = default;
+
+    bool
+    pending(size_t i) const { return t_[i].done.load(std::memory_order_acquire) < ops_.size(); }
+
+    void
+    push(Op op)
+        {
+        if(size_ == 0) return;
+        ops_.push_back(std::move(op));
+        //Drop the ops that every tensor has already seen
+        if(ops_.size() > std::max(size_t(16),size_))
+            {
+            auto m = ops_.size();
+            for(auto i : range(size_)) m = std::min(m,t_[i].done.load());
+            ops_.erase(ops_.begin(),ops_.begin()+m);
+            for(auto i : range(size_)) t_[i].done -= m;
+            }
+        }
+
+    //Mark tensor i up to date without changing it
+    void
+    skip(size_t i) { t_[i].done.store(ops_.size(),std::memory_order_release); }
+
+    //Null tensors are only marked up to date
+    void
+    apply(size_t i, ITensor & T)
+        {
+        std::lock_guard<std::mutex> lock(t_[i].mutex);
+        auto& done = t_[i].done;
+        if(T)
+            {
+            for(auto n = done.load(); n < ops_.size(); ++n) ops_[n](T);
+            }
+        done.store(ops_.size(),std::memory_order_release);
+        }
+    };
+
+//Arguments are stored by value, with strings
+//converted to TagSets once, up front
+template<typename T>
+auto
+relabelArg(T && t)
+    {
+    if constexpr(std::is_convertible<T,const char*>::value
+              || std::is_same<std::decay_t<T>,std::string>::value)
+        {
+        return TagSet(t);
+        }
+    else
+        {
+        return std::decay_t<T>(std::forward<T>(t));
+        }
+    }
+
+} //namespace detail
+
 class MPS
     {
     protected:
@@ -35,6 +151,8 @@ class MPS
     int atb_;
     std::string writedir_;
     bool do_write_;
+    mutable
+    detail::LazyRelabel relabel_;
     public:
 
     //
@@ -81,7 +199,10 @@ class MPS
     int 
     leftLim() const { return l_orth_lim_; }
 
-    // Read-only access to i'th MPS tensor
+    // Read-only access to i'th MPS tensor.
+    // May be called from several threads at once
+    // (pending relabelings are applied under a lock),
+    // but not while doWrite is on
     ITensor const&
     operator()(int i) const;
 
@@ -107,8 +228,7 @@ class MPS
     MPS&
     dag()
       {
-      for(auto i : range1(N_))
-          A_[i].dag();
+      relabel([](ITensor & T) { T.dag(); });
       return *this;
       }
 
@@ -125,10 +245,8 @@ class MPS
     MPS&
     setTags(TagSet const& ts, IndexSet const& is)
         {
-        if(do_write_)
-            Error("setTags not supported if doWrite(true)");
-        for(int i = 1; i <= N_; ++i)
-            A_[i].setTags(ts,is);
+        relabel([](ITensor & T, auto const&... a) { T.setTags(a...); },
+                ts,is);
         return *this;
         }
 
@@ -136,41 +254,33 @@ class MPS
     MPS&
     setTags(VarArgs&&... vargs)
         {
-        if(do_write_)
-            Error("setTags not supported if doWrite(true)");
-        for(int i = 1; i <= N_; ++i)
-            A_[i].setTags(std::forward<VarArgs>(vargs)...);
+        relabel([](ITensor & T, auto const&... a) { T.setTags(a...); },
+                std::forward<VarArgs>(vargs)...);
         return *this;
         }
 
     MPS&
     noTags(IndexSet const& is)
         {
-        if(do_write_)
-            Error("noTags not supported if doWrite(true)");
-        for(int i = 1; i <= N_; ++i)
-            A_[i].noTags(is);
+        relabel([](ITensor & T, auto const&... a) { T.noTags(a...); },
+                is);
         return *this;
         }
 
     template<typename... VarArgs>
-    MPS& 
+    MPS&
     noTags(VarArgs&&... vargs)
         {
-        if(do_write_)
-            Error("noTags not supported if doWrite(true)");
-        for(int i = 1; i <= N_; ++i)
-            A_[i].noTags(std::forward<VarArgs>(vargs)...);
+        relabel([](ITensor & T, auto const&... a) { T.noTags(a...); },
+                std::forward<VarArgs>(vargs)...);
         return *this;
         }
 
     MPS&
     addTags(TagSet const& ts, IndexSet const& is)
         {
-        if(do_write_)
-            Error("addTags not supported if doWrite(true)");
-        for(int i = 1; i <= N_; ++i)
-            A_[i].addTags(ts,is);
+        relabel([](ITensor & T, auto const&... a) { T.addTags(a...); },
+                ts,is);
         return *this;
         }
 
@@ -178,20 +288,16 @@ class MPS
     MPS&
     addTags(VarArgs&&... vargs)
         {
-        if(do_write_)
-            Error("addTags not supported if doWrite(true)");
-        for(int i = 1; i <= N_; ++i)
-            A_[i].addTags(std::forward<VarArgs>(vargs)...);
+        relabel([](ITensor & T, auto const&... a) { T.addTags(a...); },
+                std::forward<VarArgs>(vargs)...);
         return *this;
         }
 
     MPS&
     removeTags(TagSet const& ts, IndexSet const& is)
         {
-        if(do_write_)
-            Error("removeTags not supported if doWrite(true)");
-        for(int i = 1; i <= N_; ++i)
-            A_[i].removeTags(ts,is);
+        relabel([](ITensor & T, auto const&... a) { T.removeTags(a...); },
+                ts,is);
         return *this;
         }
 
@@ -199,20 +305,16 @@ class MPS
     MPS&
     removeTags(VarArgs&&... vargs)
         {
-        if(do_write_)
-            Error("removeTags not supported if doWrite(true)");
-        for(int i = 1; i <= N_; ++i)
-            A_[i].removeTags(std::forward<VarArgs>(vargs)...);
+        relabel([](ITensor & T, auto const&... a) { T.removeTags(a...); },
+                std::forward<VarArgs>(vargs)...);
         return *this;
         }
 
     MPS&
     replaceTags(TagSet const& ts1, TagSet const& ts2, IndexSet const& is)
         {
-        if(do_write_)
-            Error("replaceTags not supported if doWrite(true)");
-        for(int i = 1; i <= N_; ++i)
-            A_[i].replaceTags(ts1,ts2,is);
+        relabel([](ITensor & T, auto const&... a) { T.replaceTags(a...); },
+                ts1,ts2,is);
         return *this;
         }
 
@@ -220,20 +322,16 @@ class MPS
     MPS&
     replaceTags(VarArgs&&... vargs)
         {
-        if(do_write_)
-            Error("replaceTags not supported if doWrite(true)");
-        for(int i = 1; i <= N_; ++i)
-            A_[i].replaceTags(std::forward<VarArgs>(vargs)...);
+        relabel([](ITensor & T, auto const&... a) { T.replaceTags(a...); },
+                std::forward<VarArgs>(vargs)...);
         return *this;
         }
 
     MPS&
     swapTags(TagSet const& ts1, TagSet const& ts2, IndexSet const& is)
         {
-        if(do_write_)
-            Error("swapTags not supported if doWrite(true)");
-        for(int i = 1; i <= N_; ++i)
-            A_[i].swapTags(ts1,ts2,is);
+        relabel([](ITensor & T, auto const&... a) { T.swapTags(a...); },
+                ts1,ts2,is);
         return *this;
         }
 
@@ -241,30 +339,24 @@ class MPS
     MPS&
     swapTags(VarArgs&&... vargs)
         {
-        if(do_write_)
-            Error("swapTags not supported if doWrite(true)");
-        for(int i = 1; i <= N_; ++i)
-            A_[i].swapTags(std::forward<VarArgs>(vargs)...);
+        relabel([](ITensor & T, auto const&... a) { T.swapTags(a...); },
+                std::forward<VarArgs>(vargs)...);
         return *this;
         }
 
     MPS&
     prime(int plev, IndexSet const& is)
         {
-        if(do_write_)
-            Error("prime not supported if doWrite(true)");
-        for(int i = 1; i <= N_; ++i)
-            A_[i].prime(plev,is);
+        relabel([](ITensor & T, auto const&... a) { T.prime(a...); },
+                plev,is);
         return *this;
         }
 
     MPS&
     prime(IndexSet const& is)
         {
-        if(do_write_)
-            Error("prime not supported if doWrite(true)");
-        for(int i = 1; i <= N_; ++i)
-            A_[i].prime(is);
+        relabel([](ITensor & T, auto const&... a) { T.prime(a...); },
+                is);
         return *this;
         }
 
@@ -272,20 +364,16 @@ class MPS
     MPS&
     prime(VarArgs&&... vargs)
         {
-        if(do_write_)
-            Error("prime not supported if doWrite(true)");
-        for(int i = 1; i <= N_; ++i)
-            A_[i].prime(std::forward<VarArgs>(vargs)...);
+        relabel([](ITensor & T, auto const&... a) { T.prime(a...); },
+                std::forward<VarArgs>(vargs)...);
         return *this;
         }
 
     MPS&
     setPrime(int plev, IndexSet const& is)
         {
-        if(do_write_)
-            Error("setPrime not supported if doWrite(true)");
-        for(int i = 1; i <= N_; ++i)
-            A_[i].setPrime(plev,is);
+        relabel([](ITensor & T, auto const&... a) { T.setPrime(a...); },
+                plev,is);
         return *this;
         }
 
@@ -293,20 +381,16 @@ class MPS
     MPS&
     setPrime(VarArgs&&... vargs)
         {
-        if(do_write_)
-            Error("setPrime not supported if doWrite(true)");
-        for(int i = 1; i <= N_; ++i)
-            A_[i].setPrime(std::forward<VarArgs>(vargs)...);
+        relabel([](ITensor & T, auto const&... a) { T.setPrime(a...); },
+                std::forward<VarArgs>(vargs)...);
         return *this;
         }
 
     MPS&
     mapPrime(int plevold, int plevnew, IndexSet const& is)
         {
-        if(do_write_)
-            Error("mapPrime not supported if doWrite(true)");
-        for(int i = 1; i <= N_; ++i)
-            A_[i].mapPrime(plevold,plevnew,is);
+        relabel([](ITensor & T, auto const&... a) { T.mapPrime(a...); },
+                plevold,plevnew,is);
         return *this;
         }
 
@@ -314,20 +398,16 @@ class MPS
     MPS&
     mapPrime(VarArgs&&... vargs)
         {
-        if(do_write_)
-            Error("mapPrime not supported if doWrite(true)");
-        for(int i = 1; i <= N_; ++i)
-            A_[i].mapPrime(std::forward<VarArgs>(vargs)...);
+        relabel([](ITensor & T, auto const&... a) { T.mapPrime(a...); },
+                std::forward<VarArgs>(vargs)...);
         return *this;
         }
 
     MPS&
     swapPrime(int plevold, int plevnew, IndexSet const& is)
         {
-        if(do_write_)
-            Error("swapPrime not supported if doWrite(true)");
-        for(int i = 1; i <= N_; ++i)
-            A_[i].swapPrime(plevold,plevnew,is);
+        relabel([](ITensor & T, auto const&... a) { T.swapPrime(a...); },
+                plevold,plevnew,is);
         return *this;
         }
 
@@ -335,20 +415,16 @@ class MPS
     MPS&
     swapPrime(VarArgs&&... vargs)
         {
-        if(do_write_)
-            Error("swapPrime not supported if doWrite(true)");
-        for(int i = 1; i <= N_; ++i)
-            A_[i].swapPrime(std::forward<VarArgs>(vargs)...);
+        relabel([](ITensor & T, auto const&... a) { T.swapPrime(a...); },
+                std::forward<VarArgs>(vargs)...);
         return *this;
         }
 
     MPS&
     noPrime(IndexSet const& is)
         {
-        if(do_write_)
-            Error("noPrime not supported if doWrite(true)");
-        for(int i = 1; i <= N_; ++i)
-            A_[i].noPrime(is);
+        relabel([](ITensor & T, auto const&... a) { T.noPrime(a...); },
+                is);
         return *this;
         }
 
@@ -356,10 +432,8 @@ class MPS
     MPS&
     noPrime(VarArgs&&... vargs)
         {
-        if(do_write_)
-            Error("noPrime not supported if doWrite(true)");
-        for(int i = 1; i <= N_; ++i)
-            A_[i].noPrime(std::forward<VarArgs>(vargs)...);
+        relabel([](ITensor & T, auto const&... a) { T.noPrime(a...); },
+                std::forward<VarArgs>(vargs)...);
         return *this;
         }
 
@@ -384,9 +458,15 @@ class MPS
 
     //Move the orthogonality center to site i 
     //(leftLim() == i-1, rightLim() == i+1, orthoCenter() == i)
+    //using QR decompositions, or svds if the bonds are
+    //truncated (Cutoff or MaxDim given, or Truncate=true)
     MPS& 
     position(int i, Args args = Args::global());
 
+    //Orthogonalize all sites, leaving the orthogonality
+    //center at site 1, while compressing the bonds
+    //according to Cutoff (default 1E-13) and MaxDim.
+    //With Truncate=false only QR decompositions are done.
     MPS& 
     orthogonalize(Args args = Args::global());
 
@@ -402,6 +482,12 @@ class MPS
     std::string const&
     writeDir() const { return writedir_; }
 
+    //Returns tensor j without changing which tensors
+    //are kept in memory: if doWrite(true) and tensor
+    //j is not loaded, it is read from disk
+    ITensor
+    loadSite(int j) const;
+
     //Read from a directory containing individual tensors,
     //as created when doWrite(true) is called.
     void 
@@ -415,6 +501,34 @@ class MPS
 
     protected:
 
+    //Record the relabeling f(T,vargs...) of all tensors T
+    template<typename F, typename... VarArgs>
+    void
+    relabel(F f, VarArgs&&... vargs)
+        {
+        auto args = std::make_tuple(detail::relabelArg(std::forward<VarArgs>(vargs))...);
+        relabel_.push([f,args](ITensor & T)
+            {
+            std::apply([&f,&T](auto const&... a) { f(T,a...); },args);
+            });
+        }
+
+    //Carry out any pending relabelings of tensor i
+    //(deferred again if it is on disk and not loaded).
+    //Only the first caller changes A_[i], under the lock
+    //of tensor i, so concurrent const reads are safe
+    //unless doWrite is on (setSite then loads tensors)
+    void
+    applyRelabel(int i) const
+        {
+        if(!relabel_.pending(i)) return;
+        if(do_write_ && !A_[i]) return;
+        //Only sites 1..N are relabeled, not the
+        //extra tensors A_[0] and A_[N+1] used by idmrg
+        if(i < 1 || i > N_) relabel_.skip(i);
+        else                relabel_.apply(i,A_[i]);
+        }
+
     //
     //MPS methods for writing to disk
     //
@@ -526,6 +640,10 @@ class InitState
     InitState& 
     set(int i, String const& state);
 
+    //Set site i to its state number val (1..dim(sites(i)))
+    InitState& 
+    set(int i, int val);
+
     InitState& 
     setAll(String const& state);
 
@@ -839,6 +957,134 @@ inner(MPS const& x,
       MPS const& y, 
       Real& re, Real& im);
 
+//
+// Expectation values <psi|O_j|psi>/<psi|psi> of each of the
+// site operators named in opnames, at every site j.
+// Result is indexed as [op][j-1] (or [op][j-SiteStart] when
+// only the sites SiteStart..SiteEnd are requested).
+//
+// All values come from a single pass over psi (see
+// correlationMatrix for the args). expect requires a real
+// MPS (like inner); use expectC for complex ones.
+//
+std::vector<std::vector<Real>>
+expect(MPS const& psi,
+       SiteSet const& sites,
+       std::vector<std::string> const& opnames,
+       Args const& args = Args::global());
+
+std::vector<std::vector<Cplx>>
+expectC(MPS const& psi,
+        SiteSet const& sites,
+        std::vector<std::string> const& opnames,
+        Args const& args = Args::global());
+
+//
+// Matrix of correlations C(i,j) = <psi|A_i B_j|psi>/<psi|psi>
+// for all sites i,j (rows and columns 0-indexed).
+//
+// If A and B are fermionic (their names start with "C", as
+// in AutoMPO) the Jordan-Wigner string made of the "F"
+// operators of sites is inserted between them, so that for
+// example correlationMatrix(psi,sites,"Cdag","C") is the
+// single-particle density matrix.
+//
+// psi is brought into right-orthogonal form once, after which
+// the left environments of all sites are built in one sweep;
+// each row then costs one pass to the right end of psi.
+//
+// Args:
+// "SiteStart"/"SiteEnd" (default 1/length(psi)): only compute
+//     values for sites in this range
+// "NThread" (default 1): number of threads over which the
+//     sites (rows) are distributed
+//
+Matrix
+correlationMatrix(MPS const& psi,
+                  SiteSet const& sites,
+                  std::string const& Aname,
+                  std::string const& Bname,
+                  Args const& args = Args::global());
+
+CMatrix
+correlationMatrixC(MPS const& psi,
+                   SiteSet const& sites,
+                   std::string const& Aname,
+                   std::string const& Bname,
+                   Args const& args = Args::global());
+
+//
+// Schmidt spectra of psi across all of its bonds: element
+// b-1 holds the squared Schmidt values (normalized to sum
+// to one, largest first) of bond b, with their QNs if psi
+// has QNs.
+//
+// Costs about as much as two orthogonalization sweeps: psi
+// is made right-orthogonal and then swept once from the left
+// with QR decompositions, and only the bond matrices (the R
+// factors) are passed to svd.
+//
+// The spectra are never truncated: Cutoff or MaxDim in
+// args or in Args::global() are ignored.
+//
+std::vector<Spectrum>
+entanglementSpectra(MPS const& psi,
+                    Args const& args = Args::global());
+
+//
+// Entanglement entropies of psi across bonds 1..N-1
+// (element b-1 for bond b), computed from the spectra
+// returned by entanglementSpectra.
+//
+// Args:
+// "Alpha" (default 1.): order of the Renyi entropy,
+//     alpha = 1 being the von Neumann entropy
+//
+std::vector<Real>
+entanglementEntropies(MPS const& psi,
+                      Args const& args = Args::global());
+
+//
+// Draws nsample configurations from the probability
+// distribution |psi(s_1,...,s_N)|^2/<psi|psi>.
+// Result is indexed as [sample][j-1] and holds the drawn
+// state (1..dim) of each site j.
+//
+// psi is brought into right-orthogonal form once; samples
+// are then drawn in batches, each batch moving through the
+// sites from left to right with one matrix-matrix product
+// per nonzero block of each site. If psi has QNs, each
+// sample carries the QN sector of its current link, so
+// only the blocks of psi are ever stored (in the "X" basis,
+// which mixes the sectors, the QNs are dropped instead).
+//
+// Args:
+// "Basis" (default "Z"): "Z" samples the site states, "X"
+//     the states (|1>+|2>)/sqrt(2) (drawn as 1) and
+//     (|1>-|2>)/sqrt(2) (drawn as 2) of each site, which
+//     must then have dimension 2
+// "BatchSize" (default 256): number of samples drawn
+//     together in one pass over psi
+// "Seed": seed of the random number generator (by default
+//     taken from Global::random, so fixed by seedRNG)
+//
+std::vector<std::vector<int>>
+sample(MPS const& psi,
+       int nsample,
+       Args const& args = Args::global());
+
+//Same as above, drawing from the generator rng
+std::vector<std::vector<int>>
+sample(MPS const& psi,
+       int nsample,
+       std::mt19937 & rng,
+       Args const& args = Args::global());
+
+//Draws a single configuration
+std::vector<int>
+sample(MPS const& psi,
+       Args const& args = Args::global());
+
 //Computes an MPS which has the same overlap with x_basis as x_to_fit,
 //but which differs from x_basis only on the first site, and has same index
 //structure as x_basis. Result is stored to x_to_fit on return.
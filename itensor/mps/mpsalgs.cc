@@ -13,8 +13,12 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 //
+#include <future>
+#include <limits>
+#include <random>
 #include "itensor/mps/mps.h"
 #include "itensor/mps/mpo.h"
+#include "itensor/mps/autompo.h"
 #include "itensor/mps/localop.h"
 #include "itensor/util/print_macro.h"
 #include "itensor/tensor/slicemat.h"
@@ -238,6 +242,617 @@ checkQNs(MPS const& psi)
     return true;
     }
 
+namespace {
+
+//Tensors of psi (brought into right-orthogonal form)
+//used to measure site operators, gathered up front
+//so that worker threads only read them
+struct MeasureEnv
+    {
+    int N = 0;
+    std::vector<Index> s;
+    //A[j]: psi(j)
+    //D[j]: dag(psi(j)) with site and link indices primed
+    //Cl[j]: same as D[j] but with the right link not primed,
+    //       which closes a string at site j
+    //L[j]: sites 1..j contracted (L[0] is empty)
+    std::vector<ITensor> A,
+                         D,
+                         Cl,
+                         L;
+    Cplx nrm2 = 1.;
+    };
+
+//Extends the string T through site j, applying
+//operator O there (none if O is default-constructed)
+ITensor
+extend(ITensor T,
+       MeasureEnv const& E,
+       int j,
+       ITensor const& O,
+       bool close = false)
+    {
+    if(T) T *= E.A[j];
+    else  T = E.A[j];
+    if(O) T *= O;
+    else  T.prime(E.s[j]);
+    T *= (close ? E.Cl[j] : E.D[j]);
+    return T;
+    }
+
+MeasureEnv
+measureEnv(MPS const& psi, int last)
+    {
+    auto phi = psi;
+    phi.position(1);
+
+    auto E = MeasureEnv{};
+    auto N = length(phi);
+    E.N = N;
+    E.s.resize(N+1);
+    E.A.resize(N+1);
+    E.D.resize(N+1);
+    E.Cl.resize(N+1);
+    for(auto j : range1(N))
+        {
+        E.s[j] = siteIndex(phi,j);
+        E.A[j] = phi(j);
+        auto D = dag(prime(phi(j),E.s[j]));
+        if(j > 1) D.prime(linkIndex(phi,j-1));
+        E.Cl[j] = D;
+        if(j < N) D.prime(linkIndex(phi,j));
+        E.D[j] = D;
+        }
+
+    E.L.resize(last);
+    for(auto j : range1(last-1))
+        {
+        E.L[j] = extend(E.L[j-1],E,j,ITensor());
+        }
+    E.nrm2 = eltC(extend(ITensor(),E,1,ITensor(),true));
+    return E;
+    }
+
+//Calls f(n) for n = 0,...,ntask-1, dealing tasks
+//out round-robin to nthread threads
+void
+runTasks(int nthread,
+         int ntask,
+         std::function<void(int)> const& f)
+    {
+    if(nthread <= 1)
+        {
+        for(auto n : range(ntask)) f(n);
+        return;
+        }
+    auto futs = vector<std::future<void>>(nthread);
+    for(auto t : range(nthread))
+        {
+        futs[t] = std::async(std::launch::async,
+                  [&f,t,nthread,ntask]()
+                      {
+                      for(auto n = t; n < ntask; n += nthread) f(n);
+                      });
+        }
+    for(auto& ft : futs) ft.get();
+    }
+
+//Whether an operator name (possibly a product "A*B")
+//is fermionic, by the same rule as AutoMPO
+bool
+isFermionicOp(string const& opname)
+    {
+    auto isf = false;
+    size_t b = 0;
+    while(true)
+        {
+        auto e = opname.find('*',b);
+        if(isFermionic(SiteTerm(opname.substr(b,e-b),1))) isf = !isf;
+        if(e == string::npos) break;
+        b = e+1;
+        }
+    return isf;
+    }
+
+std::pair<int,int>
+siteRange(MPS const& psi, Args const& args)
+    {
+    auto start = args.getInt("SiteStart",1);
+    auto end = args.getInt("SiteEnd",length(psi));
+    if(start < 1 || end > length(psi) || start > end)
+        {
+        Error(format("Invalid site range %d..%d for MPS of length %d",start,end,length(psi)));
+        }
+    return std::make_pair(start,end);
+    }
+
+}
+
+vector<vector<Cplx>>
+expectC(MPS const& psi,
+        SiteSet const& sites,
+        vector<string> const& opnames,
+        Args const& args)
+    {
+    auto [start,end] = siteRange(psi,args);
+    auto nsite = end-start+1;
+    auto E = measureEnv(psi,end);
+
+    auto ops = vector<vector<ITensor>>(opnames.size(),vector<ITensor>(nsite));
+    for(auto n : range(opnames))
+    for(auto j : range1(start,end))
+        {
+        ops[n][j-start] = op(sites,opnames[n],j);
+        }
+
+    auto res = vector<vector<Cplx>>(opnames.size(),vector<Cplx>(nsite));
+    runTasks(args.getInt("NThread",1),nsite,
+             [&](int t)
+                 {
+                 auto j = start+t;
+                 for(auto n : range(opnames))
+                     {
+                     res[n][t] = eltC(extend(E.L[j-1],E,j,ops[n][t],true))/E.nrm2;
+                     }
+                 });
+    return res;
+    }
+
+vector<vector<Real>>
+expect(MPS const& psi,
+       SiteSet const& sites,
+       vector<string> const& opnames,
+       Args const& args)
+    {
+    if(isComplex(psi)) Error("Cannot use expect(...) with complex MPS, use expectC(...) instead");
+    auto resC = expectC(psi,sites,opnames,args);
+    auto res = vector<vector<Real>>(resC.size());
+    for(auto n : range(resC))
+        {
+        res[n].reserve(resC[n].size());
+        for(auto& z : resC[n]) res[n].push_back(z.real());
+        }
+    return res;
+    }
+
+CMatrix
+correlationMatrixC(MPS const& psi,
+                   SiteSet const& sites,
+                   string const& Aname,
+                   string const& Bname,
+                   Args const& args)
+    {
+    auto fermionic = isFermionicOp(Aname);
+    if(fermionic != isFermionicOp(Bname))
+        {
+        Error("correlationMatrix: operators must be both fermionic or both bosonic");
+        }
+    auto [start,end] = siteRange(psi,args);
+    auto nsite = end-start+1;
+    auto E = measureEnv(psi,end);
+
+    //For i < j, A_i B_j = (A_i F_i) F_{i+1} ... F_{j-1} B_j
+    //and B_i A_j = (F_i B_i) F_{i+1} ... F_{j-1} A_j
+    //when the operators are fermionic
+    auto AB = vector<ITensor>(nsite),
+         AF = vector<ITensor>(nsite),
+         FB = vector<ITensor>(nsite),
+         A = vector<ITensor>(nsite),
+         B = vector<ITensor>(nsite),
+         F = vector<ITensor>(nsite);
+    for(auto j : range1(start,end))
+        {
+        auto n = j-start;
+        AB[n] = op(sites,Aname+"*"+Bname,j);
+        A[n] = op(sites,Aname,j);
+        B[n] = op(sites,Bname,j);
+        if(fermionic)
+            {
+            AF[n] = op(sites,Aname+"*F",j);
+            FB[n] = op(sites,"F*"+Bname,j);
+            F[n] = op(sites,"F",j);
+            }
+        else
+            {
+            AF[n] = A[n];
+            FB[n] = B[n];
+            }
+        }
+
+    auto C = CMatrix(nsite,nsite);
+    runTasks(args.getInt("NThread",1),nsite,
+             [&](int i)
+                 {
+                 auto si = start+i;
+                 C(i,i) = eltC(extend(E.L[si-1],E,si,AB[i],true))/E.nrm2;
+
+                 auto TA = extend(E.L[si-1],E,si,AF[i]);
+                 auto TB = extend(E.L[si-1],E,si,FB[i]);
+                 for(auto j : range(i+1,nsite))
+                     {
+                     auto sj = start+j;
+                     C(i,j) = eltC(extend(TA,E,sj,B[j],true))/E.nrm2;
+                     C(j,i) = eltC(extend(TB,E,sj,A[j],true))/E.nrm2;
+                     if(j+1 < nsite)
+                         {
+                         TA = extend(TA,E,sj,F[j]);
+                         TB = extend(TB,E,sj,F[j]);
+                         }
+                     }
+                 });
+    return C;
+    }
+
+Matrix
+correlationMatrix(MPS const& psi,
+                  SiteSet const& sites,
+                  string const& Aname,
+                  string const& Bname,
+                  Args const& args)
+    {
+    if(isComplex(psi)) Error("Cannot use correlationMatrix(...) with complex MPS, use correlationMatrixC(...) instead");
+    auto CC = correlationMatrixC(psi,sites,Aname,Bname,args);
+    auto C = Matrix(nrows(CC),ncols(CC));
+    for(auto i : range(nrows(CC)))
+    for(auto j : range(ncols(CC)))
+        {
+        C(i,j) = CC(i,j).real();
+        }
+    return C;
+    }
+
+vector<Spectrum>
+entanglementSpectra(MPS const& psi,
+                    Args const& args)
+    {
+    //Nothing is truncated, whatever Cutoff or MaxDim
+    //args or Args::global() hold: the spectra are exact
+    auto noTrunc = Args("Truncate",false);
+
+    auto N = length(psi);
+    auto phi = psi;
+    phi.position(1,noTrunc);
+
+    auto specs = stdx::reserve_vector<Spectrum>(N-1);
+    auto C = phi(1);
+    for(auto b : range1(N-1))
+        {
+        //The Schmidt values across bond b are the singular
+        //values of R, since Q and the sites to the right
+        //of bond b are orthogonal
+        auto l = linkIndex(phi,b);
+        ITensor Q,
+                R(l);
+        rrqr(C,Q,R,noTrunc);
+
+        ITensor U(commonIndex(Q,R)),S,V;
+        auto spec = svd(R,U,S,V,{noTrunc,
+                                 "ComputeQNs=",true,
+                                 "LeftTags=","Link,U",
+                                 "RightTags=","Link,V"});
+        auto eigs = spec.eigs();
+        auto total = sumels(eigs);
+        if(total > 0) eigs /= total;
+        auto qns = spec.qns();
+        specs.emplace_back(move(eigs),move(qns),Args("Truncerr",0.));
+
+        C = R*phi(b+1);
+        }
+    return specs;
+    }
+
+vector<Real>
+entanglementEntropies(MPS const& psi,
+                      Args const& args)
+    {
+    auto alpha = args.getReal("Alpha",1.);
+    auto S = vector<Real>();
+    for(auto& spec : entanglementSpectra(psi,args))
+        {
+        S.push_back(entropy(spec,alpha));
+        }
+    return S;
+    }
+
+namespace {
+
+//A nonzero block of a site tensor, in site sector sb
+//and right link sector rb, stored at offset in the
+//data of the site
+struct SampleBlock
+    {
+    long sb = 0,
+         rb = 0,
+         offset = 0;
+    };
+
+//Site tensors of psi as lists of dense blocks, with the
+//left link running fastest and the right link slowest
+//in each block. A site without QNs is a single block.
+template<typename T>
+struct SampleSites
+    {
+    std::vector<std::vector<T>> A;
+    //blocks[j][lb]: blocks of site j whose left link
+    //sector is lb
+    std::vector<std::vector<std::vector<SampleBlock>>> blocks;
+    //dl[j][lb]: size of sector lb of the left link of
+    //site j (the right link of site j-1)
+    //d[j][sb], first[j][sb]: size and first state
+    //(counting from 0) of sector sb of site j
+    std::vector<std::vector<long>> dl,
+                                   d,
+                                   first;
+    };
+
+//Nonzero blocks and data of QN storage
+template<typename T>
+struct GetSampleBlocks { };
+
+template<typename T>
+struct SampleData
+    {
+    BlockOffsets offsets;
+    std::vector<T> data;
+    };
+
+template<typename T>
+SampleData<T>
+doTask(GetSampleBlocks<T> const&,
+       QDense<T> const& d)
+    {
+    return SampleData<T>{d.offsets,std::vector<T>(d.store.begin(),d.store.end())};
+    }
+
+//Real sites of a complex MPS
+SampleData<Cplx>
+doTask(GetSampleBlocks<Cplx> const&,
+       QDense<Real> const& d)
+    {
+    return SampleData<Cplx>{d.offsets,std::vector<Cplx>(d.store.begin(),d.store.end())};
+    }
+
+std::vector<long>
+blockSizes(Index const& i)
+    {
+    auto d = std::vector<long>();
+    for(auto b : range1(nblock(i))) d.push_back(blocksize(i,b));
+    return d;
+    }
+
+template<typename T>
+SampleSites<T>
+sampleSites(MPS const& psi,
+            string const& basis)
+    {
+    if(basis != "Z" && basis != "X") Error("sample: unrecognized basis " + basis);
+    //The X basis mixes the QN sectors of a site, so
+    //psi is then sampled without QNs
+    auto qns = hasQNs(psi) && basis == "Z";
+
+    auto N = length(psi);
+    auto phi = psi;
+    phi.position(1,{"Truncate=",false});
+
+    auto S = SampleSites<T>{};
+    S.A.resize(N+1);
+    S.blocks.resize(N+1);
+    S.dl.assign(N+2,{1});
+    S.d.assign(N+1,{1});
+    S.first.assign(N+1,{0});
+    for(auto j : range1(N))
+        {
+        auto s = siteIndex(phi,j);
+        auto A = phi(j);
+        auto order = vector<Index>();
+        if(j > 1) order.push_back(linkIndex(phi,j-1));
+        order.push_back(s);
+        if(j < N) order.push_back(linkIndex(phi,j));
+
+        if(qns)
+            {
+            A.permute(IndexSet(order));
+            auto D = doTask(GetSampleBlocks<T>{},A.store());
+            S.A[j] = move(D.data);
+            if(j > 1) S.dl[j] = blockSizes(order.front());
+            S.d[j] = blockSizes(s);
+            S.first[j].assign(1,0);
+            for(auto sb : range(S.d[j].size()-1))
+                {
+                S.first[j].push_back(S.first[j][sb]+S.d[j][sb]);
+                }
+            S.blocks[j].resize(S.dl[j].size());
+            for(auto const& bo : D.offsets)
+                {
+                auto n = 0;
+                auto lb = (j > 1) ? bo.block[n++] : 0l;
+                auto sb = bo.block[n++];
+                auto rb = (j < N) ? bo.block[n++] : 0l;
+                S.blocks[j][lb].push_back({sb,rb,long(bo.offset)});
+                }
+            continue;
+            }
+
+        A = removeQNs(A);
+        for(auto& i : order) i = removeQNs(i);
+        if(basis == "X")
+            {
+            if(dim(s) != 2) Error("sample: basis \"X\" requires sites of dimension 2");
+            auto sd = removeQNs(s);
+            auto x = sim(sd);
+            auto H = ITensor(dag(sd),x);
+            H.set(1,1,1./std::sqrt(2.));
+            H.set(1,2,1./std::sqrt(2.));
+            H.set(2,1,1./std::sqrt(2.));
+            H.set(2,2,-1./std::sqrt(2.));
+            A *= H;
+            order[j > 1 ? 1 : 0] = x;
+            }
+        if(j > 1) S.dl[j] = {dim(order.front())};
+        S.d[j] = {dim(s)};
+        A.permute(IndexSet(order));
+        auto& data = S.A[j];
+        data.reserve(dim(inds(A)));
+        A.visit([&data](T x) { data.push_back(x); });
+        S.blocks[j] = {{SampleBlock{}}};
+        }
+    return S;
+    }
+
+//Draws samples first..first+n-1 of res: each sample carries
+//the sector of the link to the left of the current site and
+//its conditional amplitudes V on that sector. Samples in the
+//same sector are advanced together, with one matrix-matrix
+//product per block of the site.
+template<typename T>
+void
+sampleBatch(SampleSites<T> const& S,
+            int first,
+            int n,
+            std::mt19937 & rng,
+            vector<vector<int>> & res)
+    {
+    auto N = long(S.A.size())-1;
+    auto uniform = std::uniform_real_distribution<Real>(0.,1.);
+    auto V = vector<vector<T>>(n,vector<T>(1,1.));
+    auto sec = vector<long>(n,0);
+    auto group = vector<int>();
+    auto Vg = vector<T>();
+    auto C = vector<T>();
+    auto coff = vector<long>();
+    auto p = vector<Real>();
+    for(auto j : range1(N))
+        {
+        auto& blocks = S.blocks[j];
+        for(auto lb : range(blocks.size()))
+            {
+            group.clear();
+            for(auto b : range(n)) if(sec[b] == long(lb)) group.push_back(b);
+            if(group.empty()) continue;
+            auto ng = long(group.size());
+            auto dl = S.dl[j][lb];
+
+            Vg.resize(ng*dl);
+            for(auto g : range(ng))
+            for(auto a : range(dl))
+                {
+                Vg[g+ng*a] = V[group[g]][a];
+                }
+            auto Vref = makeMatRefc(Vg.data(),Vg.size(),ng,dl);
+
+            //Amplitudes of the states of each block
+            coff.resize(blocks[lb].size()+1);
+            coff[0] = 0;
+            for(auto k : range(blocks[lb].size()))
+                {
+                auto& B = blocks[lb][k];
+                coff[k+1] = coff[k]+ng*S.d[j][B.sb]*S.dl[j+1][B.rb];
+                }
+            C.resize(coff.back());
+            for(auto k : range(blocks[lb].size()))
+                {
+                auto& B = blocks[lb][k];
+                auto dcol = S.d[j][B.sb]*S.dl[j+1][B.rb];
+                auto Aref = makeMatRefc(S.A[j].data()+B.offset,S.A[j].size()-B.offset,dl,dcol);
+                auto Cref = makeMatRef(C.data()+coff[k],C.size()-coff[k],ng,dcol);
+                gemm(Vref,Aref,Cref,1.,0.);
+                }
+
+            for(auto g : range(ng))
+                {
+                //Probabilities of the states of all blocks in turn
+                p.clear();
+                auto total = 0.;
+                for(auto k : range(blocks[lb].size()))
+                    {
+                    auto& B = blocks[lb][k];
+                    auto d = S.d[j][B.sb],
+                         dr = S.dl[j+1][B.rb];
+                    auto Ck = C.data()+coff[k];
+                    for(auto t : range(d))
+                        {
+                        auto pt = 0.;
+                        for(auto r : range(dr)) pt += std::norm(Ck[g+ng*(t+d*r)]);
+                        p.push_back(pt);
+                        total += pt;
+                        }
+                    }
+                auto u = total*uniform(rng);
+                auto q = 0l;
+                for(; q < long(p.size())-1; ++q)
+                    {
+                    if(u < p[q]) break;
+                    u -= p[q];
+                    }
+                //Guard against round-off drawing an impossible state
+                while(p[q] == 0. && q > 0) --q;
+                auto fac = 1./std::sqrt(p[q]);
+
+                //Find the block and state drawn
+                auto k = 0ul;
+                for(; q >= S.d[j][blocks[lb][k].sb]; ++k) q -= S.d[j][blocks[lb][k].sb];
+                auto& B = blocks[lb][k];
+                auto d = S.d[j][B.sb],
+                     dr = S.dl[j+1][B.rb];
+                auto Ck = C.data()+coff[k];
+                auto b = group[g];
+                res[first+b][j-1] = 1+S.first[j][B.sb]+q;
+                V[b].resize(dr);
+                for(auto r : range(dr)) V[b][r] = fac*Ck[g+ng*(q+d*r)];
+                sec[b] = B.rb;
+                }
+            }
+        }
+    }
+
+template<typename T>
+vector<vector<int>>
+sampleImpl(MPS const& psi,
+           int nsample,
+           std::mt19937 & rng,
+           Args const& args)
+    {
+    auto basis = args.getString("Basis","Z");
+    auto batch = std::max(1,int(args.getInt("BatchSize",256)));
+    auto S = sampleSites<T>(psi,basis);
+    auto res = vector<vector<int>>(nsample,vector<int>(length(psi)));
+    for(auto first = 0; first < nsample; first += batch)
+        {
+        sampleBatch(S,first,std::min(batch,nsample-first),rng,res);
+        }
+    return res;
+    }
+
+} //namespace
+
+vector<vector<int>>
+sample(MPS const& psi,
+       int nsample,
+       std::mt19937 & rng,
+       Args const& args)
+    {
+    if(isComplex(psi)) return sampleImpl<Cplx>(psi,nsample,rng,args);
+    return sampleImpl<Real>(psi,nsample,rng,args);
+    }
+
+vector<vector<int>>
+sample(MPS const& psi,
+       int nsample,
+       Args const& args)
+    {
+    auto seed = args.defined("Seed") ? args.getInt("Seed")
+                                     : int(Global::random()*std::numeric_limits<int>::max());
+    auto rng = std::mt19937(seed);
+    return sample(psi,nsample,rng,args);
+    }
+
+vector<int>
+sample(MPS const& psi,
+       Args const& args)
+    {
+    return sample(psi,1,args).front();
+    }
+
 QN
 totalQN(MPS const& psi)
     {
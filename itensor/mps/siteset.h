@@ -15,6 +15,10 @@
 //
 #ifndef __ITENSOR_SITESET_H
 #define __ITENSOR_SITESET_H
+#include <list>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
 #include "itensor/itensor.h"
 #include "itensor/util/str.h"
 
@@ -34,6 +38,15 @@ namespace itensor {
 // (assuming the tensor A is an ortho center 
 // of our MPS)
 //
+// Operators are cached: the first call to op for a given
+// operator name, site and Args builds the ITensor, later calls
+// return a copy sharing its (copy-on-write) storage. The cache
+// is shared by all copies of a SiteSet and holds the
+// SiteOpCache::max_size most recently used operators. Only
+// the Args passed to op are part of the key, so call
+// clearOpCache after changing Args::global() in a way that
+// changes operators.
+//
 
 class GenericSite;
 struct SiteStore;
@@ -87,6 +100,16 @@ class SiteSet
     op(String const& opname, int i,
        Args const& args = Args::global()) const;
 
+    //Operators "opname" at each of the given sites
+    std::vector<ITensor>
+    ops(String const& opname,
+        std::vector<int> const& sites,
+        Args const& args = Args::global()) const;
+
+    //Free all cached operators
+    void
+    clearOpCache() const;
+
     void 
     read(std::istream & s) { readType<GenericSite>(s); }
 
@@ -124,6 +147,10 @@ class SiteSet
     void
     init(SiteStore && sites);
 
+    ITensor
+    makeOp(String const& opname, int i,
+           Args const& args) const;
+
     template<typename SiteType>
     void
     readType(std::istream & s);
@@ -214,25 +241,75 @@ class GenericSite
     };
 
 
+//Operators already built by SiteSet::op, keyed by
+//opKey(opname,i,args), most recently used first
+struct SiteOpCache
+    {
+    static constexpr size_t max_size = 1024;
+    using entry = std::pair<std::string,ITensor>;
+
+    std::mutex mutex;
+    std::list<entry> ops;
+    std::unordered_map<std::string,std::list<entry>::iterator> index;
+
+    bool
+    find(std::string const& key, ITensor & op)
+        {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = index.find(key);
+        if(it == index.end()) return false;
+        ops.splice(ops.begin(),ops,it->second);
+        op = it->second->second;
+        return true;
+        }
+
+    void
+    insert(std::string const& key, ITensor const& op)
+        {
+        std::lock_guard<std::mutex> lock(mutex);
+        if(index.count(key)) return;
+        ops.emplace_front(key,op);
+        index.emplace(key,ops.begin());
+        if(ops.size() > max_size)
+            {
+            index.erase(ops.back().first);
+            ops.pop_back();
+            }
+        }
+
+    void
+    clear()
+        {
+        std::lock_guard<std::mutex> lock(mutex);
+        index.clear();
+        ops.clear();
+        }
+    };
+
 struct SiteStore
     {
     using sptr = std::unique_ptr<SiteBase>;
     using storage = std::vector<sptr>;
     private:
     storage sites_;
+    std::unique_ptr<SiteOpCache> cache_;
     public:
 
-    SiteStore() { }
+    SiteStore() : cache_(new SiteOpCache) { }
 
-    SiteStore(int N) : sites_(1+N) { }
+    SiteStore(int N) : sites_(1+N), cache_(new SiteOpCache) { }
 
     template<typename SiteType>
     void
     set(int i, SiteType && s) 
         {
         sites_.at(i) = sptr(new SiteHolder<SiteType>(std::move(s)));
+        cache_->clear();
         }
 
+    SiteOpCache&
+    cache() const { return *cache_; }
+
     int
     length() const { return sites_.empty() ? 0 : sites_.size()-1ul; }
 
@@ -359,12 +436,62 @@ hasQNs(SiteSet const& sites)
     return true;
     }
 
+//Besides the operator name and site, the key holds the
+//Args passed to op, if any (not Args::global(), which
+//would have to be serialized on every call)
+std::string inline
+opKey(std::string const& opname, 
+      int i, 
+      Args const& args)
+    {
+    auto key = opname;
+    key += '\0';
+    key += std::to_string(i);
+    if(args.isGlobal()) return key;
+    auto s = std::ostringstream();
+    args.write(s);
+    key += '\0';
+    key += s.str();
+    return key;
+    }
+
 ITensor inline SiteSet::
 op(String const& opname, 
    int i, 
    Args const& args) const
     { 
     if(not *this) Error("Cannot call .op(..) on default-initialized SiteSet");
+    auto& cache = sites_->cache();
+    auto key = opKey(opname,i,args);
+    auto res = ITensor();
+    if(cache.find(key,res)) return res;
+    res = makeOp(opname,i,args);
+    cache.insert(key,res);
+    return res;
+    }
+
+std::vector<ITensor> inline SiteSet::
+ops(String const& opname, 
+    std::vector<int> const& sites,
+    Args const& args) const
+    {
+    auto res = std::vector<ITensor>();
+    res.reserve(sites.size());
+    for(auto i : sites) res.push_back(op(opname,i,args));
+    return res;
+    }
+
+void inline SiteSet::
+clearOpCache() const
+    {
+    if(sites_) sites_->cache().clear();
+    }
+
+ITensor inline SiteSet::
+makeOp(String const& opname, 
+       int i, 
+       Args const& args) const
+    { 
     if(opname == "Id")
         {
         auto s = si(i);
@@ -427,6 +554,15 @@ op(SiteSet const& sites,
     return sites.op(opname,i,args);
     }
 
+std::vector<ITensor> inline
+ops(SiteSet const& sites,
+    std::string const& opname,
+    std::vector<int> const& sitelist,
+    Args const& args = Args::global())
+    {
+    return sites.ops(opname,sitelist,args);
+    }
+
 void inline SiteSet::
 init(SiteStore && store)
     { 
@@ -0,0 +1,227 @@
+//
+// Copyright 2018 The Simons Foundation, Inc. - All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "itensor/mps/sparsempo.h"
+
+namespace itensor {
+
+namespace {
+
+//Returns true, setting coef, if op is
+//a nonzero multiple of the identity
+bool
+isIdentityOp(ITensor const& op,
+             Cplx & coef)
+    {
+    if(order(op) != 2) return false;
+    auto s = op.inds()(1);
+    if(s.primeLevel() > 0) s = op.inds()(2);
+    if(s.primeLevel() != 0 || !hasIndex(op,prime(s))) return false;
+    coef = eltC(op,s=1,prime(s)=1);
+    if(std::abs(coef) == 0.) return false;
+    auto tol = 1E-12*std::abs(coef);
+    for(auto i : range1(dim(s)))
+    for(auto j : range1(dim(s)))
+        {
+        auto el = eltC(op,s=i,prime(s)=j);
+        if(i == j) el -= coef;
+        if(std::abs(el) > tol) return false;
+        }
+    return true;
+    }
+
+//Element of op of largest magnitude (the norm if
+//op is not a site operator), which op is divided
+//by to compare operators up to a factor
+Cplx
+scaleOf(ITensor const& op)
+    {
+    if(order(op) != 2) return norm(op);
+    auto s = op.inds()(1);
+    if(s.primeLevel() > 0) s = op.inds()(2);
+    if(s.primeLevel() != 0 || !hasIndex(op,prime(s))) return norm(op);
+    auto scale = Cplx(0.);
+    for(auto i : range1(dim(s)))
+    for(auto j : range1(dim(s)))
+        {
+        auto el = eltC(op,s=i,prime(s)=j);
+        if(std::abs(el) > 1.000001*std::abs(scale)) scale = el;
+        }
+    return scale;
+    }
+
+//Position of op/coef in ops, appending it if
+//it is not already there
+int
+findOp(std::vector<ITensor> & ops,
+       ITensor const& op,
+       Cplx coef)
+    {
+    auto O = (coef.imag() == 0.) ? op/coef.real() : op/coef;
+    for(auto n : range(ops))
+        {
+        if(hasQNs(O) && flux(O) != flux(ops[n])) continue;
+        if(norm(O-ops[n]) < 1E-12*norm(O)) return n;
+        }
+    ops.push_back(O);
+    return int(ops.size())-1;
+    }
+
+} //namespace
+
+SparseMPO::
+SparseMPO(MPO const& H,
+          Args const& args)
+  : terms_(H.length()+1),
+    ops_(H.length()+1),
+    linkdims_(H.length()+1,1)
+    {
+    auto N = H.length();
+    auto cutoff = args.getReal("Cutoff",0.);
+    for(auto b : range1(N-1)) linkdims_[b] = dim(linkIndex(H,b));
+
+    for(auto j : range1(N))
+        {
+        auto& W = H(j);
+        auto ll = leftLinkIndex(H,j),
+             rl = rightLinkIndex(H,j);
+        auto nrow = ll ? dim(ll) : 1;
+        auto ncol = rl ? dim(rl) : 1;
+        for(auto row : range1(nrow))
+            {
+            auto Wr = ll ? W*setElt(dag(ll)=row) : W;
+            if(norm(Wr) <= cutoff) continue;
+            for(auto col : range1(ncol))
+                {
+                auto op = rl ? Wr*setElt(dag(rl)=col) : Wr;
+                if(norm(op) <= cutoff) continue;
+                auto t = MPOTerm{};
+                t.row = row;
+                t.col = col;
+                if(!isIdentityOp(op,t.coef))
+                    {
+                    t.coef = scaleOf(op);
+                    t.op = findOp(ops_[j],op,t.coef);
+                    }
+                terms_[j].push_back(t);
+                }
+            }
+        }
+    }
+
+long SparseMPO::
+nnz() const
+    {
+    long n = 0;
+    for(auto& t : terms_) n += t.size();
+    return n;
+    }
+
+namespace detail {
+
+std::vector<ITensor>
+applyTerms(SparseMPO const& H,
+           int j,
+           std::vector<ITensor> const& X,
+           bool fromRight)
+    {
+    auto& ops = H.ops(j);
+    auto nops = ops.size();
+    auto nx = H.linkDim(fromRight ? j : j-1),
+         ny = H.linkDim(fromRight ? j-1 : j);
+    if(X.size() != size_t(nx)) Error("applyTerms: wrong number of tensors");
+    auto src = [fromRight](MPOTerm const& t) { return (fromRight ? t.col : t.row)-1; };
+    auto dst = [fromRight](MPOTerm const& t) { return (fromRight ? t.row : t.col)-1; };
+
+    //y += c*x
+    auto addTo = [](ITensor & y, Cplx c, ITensor const& x)
+        {
+        if(c.imag() != 0.)  y += c*x;
+        else if(!y)         y = c.real()*x;
+        else                daxpy(y,x,c.real());
+        };
+    auto apply = [&ops](size_t n, ITensor const& x)
+        {
+        auto z = ops[n]*x;
+        for(auto& i : ops[n].inds())
+            {
+            if(i.primeLevel() > 0) z.noPrime(i);
+            }
+        return z;
+        };
+
+    //An operator acting on one X[a] for several targets is applied
+    //once to X[a], and one reaching a target from several X[a]
+    //is applied once to their sum, whichever group is larger
+    auto nsrc = std::vector<int>(nx*nops,0),
+         ndst = std::vector<int>(ny*nops,0);
+    for(auto& t : H.terms(j))
+        {
+        if(t.isId()) continue;
+        ++nsrc[src(t)*nops+t.op];
+        ++ndst[dst(t)*nops+t.op];
+        }
+
+    auto Y = std::vector<ITensor>(ny);
+    //ops applied to X, and sums waiting to have an op applied
+    auto Z = std::vector<ITensor>(nx*nops),
+         S = std::vector<ITensor>(ny*nops);
+    for(auto& t : H.terms(j))
+        {
+        auto a = src(t),
+             b = dst(t);
+        auto& x = X[a];
+        if(!x) continue;
+        if(t.isId())
+            {
+            addTo(Y[b],t.coef,x);
+            continue;
+            }
+        auto ka = a*nops+t.op,
+             kb = b*nops+t.op;
+        if(nsrc[ka] >= ndst[kb])
+            {
+            if(!Z[ka]) Z[ka] = apply(t.op,x);
+            addTo(Y[b],t.coef,Z[ka]);
+            }
+        else
+            {
+            addTo(S[kb],t.coef,x);
+            }
+        }
+    for(auto kb : range(S))
+        {
+        if(S[kb]) addTo(Y[kb/nops],1.,apply(kb%nops,S[kb]));
+        }
+    return Y;
+    }
+
+} //namespace detail
+
+std::ostream&
+operator<<(std::ostream & s, SparseMPO const& H)
+    {
+    s << "SparseMPO\n";
+    for(auto j : range1(length(H)))
+        {
+        auto nid = 0;
+        for(auto& t : H.terms(j)) if(t.isId()) ++nid;
+        s << format("%d: %d x %d, %d nonzero (%d identity), %d distinct operators\n",
+                    j,H.linkDim(j-1),H.linkDim(j),H.terms(j).size(),nid,H.ops(j).size());
+        }
+    return s;
+    }
+
+} //namespace itensor
@@ -0,0 +1,128 @@
+//
+// Copyright 2018 The Simons Foundation, Inc. - All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef __ITENSOR_SPARSEMPO_H
+#define __ITENSOR_SPARSEMPO_H
+#include "itensor/mps/mpo.h"
+
+namespace itensor {
+
+//
+// The SparseMPO class stores each MPO tensor W[j]
+// as a sparse k x k matrix whose entries are site
+// operators:
+//
+//          s'
+//          |
+//   row - W[j] - col    =   sum   |row> coef*O <col|
+//          |             (nonzero)
+//          s
+//
+// Only the nonzero entries are kept. Each is a
+// coefficient times either the identity or one of
+// a short list of distinct operators of the site
+// (such as Sz, S+ and S-), so that applying W[j]
+// mostly needs scaled additions. The MPO link
+// indices themselves are dropped: the first site
+// has a single row and the last site a single
+// column.
+//
+// MPOs of long-range Hamiltonians made by AutoMPO
+// (with Exact=true) have a bond dimension k of
+// 50-200 but only of order k nonzero entries per
+// site, so that LocalSparseMPO (localsparsempo.h),
+// which loops over the entries, does far fewer
+// operations than LocalMPO contracting the
+// dense W[j].
+//
+
+struct MPOTerm
+    {
+    //Position in the k x k matrix (1-indexed)
+    int row = 1,
+        col = 1;
+    //Entry is coef times ops(j)[op], or
+    //coef times the identity if op < 0
+    int op = -1;
+    Cplx coef = 0.;
+
+    bool
+    isId() const { return op < 0; }
+    };
+
+class SparseMPO
+    {
+    std::vector<std::vector<MPOTerm>> terms_;
+    std::vector<std::vector<ITensor>> ops_;
+    std::vector<int> linkdims_;
+    public:
+
+    SparseMPO() { }
+
+    //Keep the entries of the site tensors of H
+    //having norm greater than Cutoff (default 0)
+    explicit
+    SparseMPO(MPO const& H,
+              Args const& args = Args::global());
+
+    explicit operator bool() const { return !terms_.empty(); }
+
+    int
+    length() const { return int(terms_.size())-1; }
+
+    //Nonzero entries of W[j]
+    std::vector<MPOTerm> const&
+    terms(int j) const { return terms_.at(j); }
+
+    //Distinct operators of W[j] other than the identity,
+    //with the unprimed site index acting on the ket
+    std::vector<ITensor> const&
+    ops(int j) const { return ops_.at(j); }
+
+    //Dimension of the MPO link between sites b and b+1
+    //(1 for b = 0 and b = length())
+    int
+    linkDim(int b) const { return linkdims_.at(b); }
+
+    //Number of nonzero entries of all site tensors
+    long
+    nnz() const;
+    };
+
+int inline
+length(SparseMPO const& H) { return H.length(); }
+
+namespace detail {
+
+//Applies W[j] of H to the tensors X, one per value of
+//the link on the left of site j (or the right, if
+//fromRight is true), returning one tensor per value of
+//the link on the other side. The site index of j is
+//left unprimed. Null entries of X are skipped; entries
+//of the result that no term reaches are null.
+std::vector<ITensor>
+applyTerms(SparseMPO const& H,
+           int j,
+           std::vector<ITensor> const& X,
+           bool fromRight = false);
+
+} //namespace detail
+
+std::ostream&
+operator<<(std::ostream & s, SparseMPO const& H);
+
+} //namespace itensor
+
+#endif
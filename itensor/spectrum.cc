@@ -14,6 +14,7 @@
 // limitations under the License.
 //
 #include <algorithm>
+#include <cmath>
 #include <utility>
 #include "itensor/spectrum.h"
 
@@ -92,6 +93,24 @@ write(std::ostream& s) const
     //    }
     }
 
+Real
+entropy(Spectrum const& spec, Real alpha)
+    {
+    auto& eigs = spec.eigs();
+    auto total = sumels(eigs);
+    if(total <= 0) return 0.;
+    Real S = 0;
+    for(auto eig : eigs)
+        {
+        auto p = eig/total;
+        if(p <= 0) continue;
+        if(alpha == 1.) S -= p*std::log(p);
+        else            S += std::pow(p,alpha);
+        }
+    if(alpha != 1.) S = std::log(S)/(1.-alpha);
+    return S;
+    }
+
 void Spectrum::
 computeTruncerr(Args const& args)
     {
@@ -90,6 +90,13 @@ class Spectrum
 std::ostream& 
 operator<<(std::ostream & s,Spectrum const& spec);
 
+//Entropy of the eigenvalues of spec, normalized
+//to sum to one: von Neumann entropy -sum_n p_n log(p_n)
+//for alpha == 1, otherwise the Renyi entropy
+//log(sum_n p_n^alpha)/(1-alpha)
+Real
+entropy(Spectrum const& spec, Real alpha = 1.);
+
 } //namespace itensor
 
 
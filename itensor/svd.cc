@@ -46,39 +46,39 @@ svdImpl(ITensor const& A,
         ITensor & V,
         Args args)
     {
-    if( args.defined("Minm") )
+    if( args.defined(keys::Minm) )
       {
-      if( args.defined("MinDim") )
+      if( args.defined(keys::MinDim) )
         {
         Global::warnDeprecated("Args Minm and MinDim are both defined. Minm is deprecated in favor of MinDim, MinDim will be used.");
         }
       else
         {
         Global::warnDeprecated("Arg Minm is deprecated in favor of MinDim.");
-        args.add("MinDim",args.getInt("Minm"));
+        args.add(keys::MinDim,args.getInt(keys::Minm));
         }
       }
 
-    if( args.defined("Maxm") )
+    if( args.defined(keys::Maxm) )
       {
-      if( args.defined("MaxDim") )
+      if( args.defined(keys::MaxDim) )
         {
         Global::warnDeprecated("Args Maxm and MaxDim are both defined. Maxm is deprecated in favor of MaxDim, MaxDim will be used.");
         }
       else
         {
         Global::warnDeprecated("Arg Maxm is deprecated in favor of MaxDim.");
-        args.add("MaxDim",args.getInt("Maxm"));
+        args.add(keys::MaxDim,args.getInt(keys::Maxm));
         }
       }
 
-    auto do_truncate = args.getBool("Truncate");
-    auto cutoff = args.getReal("Cutoff",MIN_CUT);
-    auto maxdim = args.getInt("MaxDim",MAX_DIM);
-    auto mindim = args.getInt("MinDim",1);
-    auto doRelCutoff = args.getBool("DoRelCutoff",true);
-    auto absoluteCutoff = args.getBool("AbsoluteCutoff",false);
-    auto show_eigs = args.getBool("ShowEigs",false);
+    auto do_truncate = args.getBool(keys::Truncate);
+    auto cutoff = args.getReal(keys::Cutoff,MIN_CUT);
+    auto maxdim = args.getInt(keys::MaxDim,MAX_DIM);
+    auto mindim = args.getInt(keys::MinDim,1);
+    auto doRelCutoff = args.getBool(keys::DoRelCutoff,true);
+    auto absoluteCutoff = args.getBool(keys::AbsoluteCutoff,false);
+    auto show_eigs = args.getBool(keys::ShowEigs,false);
     auto litagset = getTagSet(args,"LeftTags","Link,U");
     auto ritagset = getTagSet(args,"RightTags","Link,V");
     if(litagset == ritagset) 
@@ -434,22 +434,22 @@ svdOrd2(ITensor const& A,
         ITensor & V,
         Args args)
     {
-    if( args.defined("Maxm") )
+    if( args.defined(keys::Maxm) )
       {
-      if( args.defined("MaxDim") )
+      if( args.defined(keys::MaxDim) )
         {
         Global::warnDeprecated("Args Maxm and MaxDim are both defined. Maxm is deprecated in favor of MaxDim, MaxDim will be used.");
         }
       else
         {
         Global::warnDeprecated("Arg Maxm is deprecated in favor of MaxDim.");
-        args.add("MaxDim",args.getInt("Maxm"));
+        args.add(keys::MaxDim,args.getInt(keys::Maxm));
         }
       }
 
-    auto do_truncate = args.defined("Cutoff") || args.defined("MaxDim");
-    if(not args.defined("Truncate")) 
-        args.add("Truncate",do_truncate);
+    auto do_truncate = args.defined(keys::Cutoff) || args.defined(keys::MaxDim);
+    if(not args.defined(keys::Truncate)) 
+        args.add(keys::Truncate,do_truncate);
 
     if(A.order() != 2) 
         {
@@ -13,6 +13,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 //
+#include <mutex>
+#include <unordered_map>
 #include "itensor/tagset.h"
 #include "itensor/util/readwrite.h"
 #include "itensor/util/print_macro.h"
@@ -21,6 +23,63 @@ using std::string;
 
 namespace itensor {
 
+namespace {
+
+struct TagTable
+    {
+    std::mutex mutex;
+    std::unordered_map<int64_t,TagID> ids;
+    };
+
+//Never destroyed, so that tags can still be
+//interned by destructors running after main returns
+TagTable&
+tagTable()
+    {
+    static auto* T = new TagTable;
+    return *T;
+    }
+
+} //namespace
+
+TagID
+internTag(Tag const& t)
+    {
+    auto key = int64_t(t);
+    if(key == 0) return 0;
+    //Tags already seen by this thread are found
+    //without taking the lock of the global table
+    thread_local std::unordered_map<int64_t,TagID> cache;
+    auto it = cache.find(key);
+    if(it != cache.end()) return it->second;
+
+    auto& T = tagTable();
+    auto id = OverflowTagID;
+        {
+        std::lock_guard<std::mutex> lock(T.mutex);
+        auto f = T.ids.find(key);
+        if(f != T.ids.end())
+            {
+            id = f->second;
+            }
+        else if(T.ids.size()+1 < OverflowTagID)
+            {
+            id = TagID(T.ids.size()+1);
+            T.ids.emplace(key,id);
+            }
+        }
+    if(id != OverflowTagID) cache.emplace(key,id);
+    return id;
+    }
+
+size_t
+internedTagCount()
+    {
+    auto& T = tagTable();
+    std::lock_guard<std::mutex> lock(T.mutex);
+    return T.ids.size();
+    }
+
 size_t
 size(TagSet const& ts)
     {
@@ -40,10 +99,11 @@ setPrime(TagSet ts, int plev)
     return ts;
     }
 
+namespace detail {
+
 bool
-operator==(TagSet const& t1, TagSet const& t2)
+sameTagStrings(TagSet const& t1, TagSet const& t2)
     {
-    if(primeLevel(t1) != primeLevel(t2)) return false;
     if(size(t1) != size(t2)) return false;
     for(auto i : range(size(t1)))
         {
@@ -52,11 +112,7 @@ operator==(TagSet const& t1, TagSet const& t2)
     return true;
     }
 
-bool
-operator!=(TagSet const& t1, TagSet const& t2)
-    {
-    return !(t1==t2);
-    }
+} //namespace detail
 
 TagSet::
 TagSet(const char* ts)
@@ -97,12 +153,24 @@ tagPosition(Tag const& t) const
     return -1;
     }
 
+//Same as tagPosition(t), given the ID of t
+int TagSet::
+tagPosition(Tag const& t, TagID id) const
+    {
+    if(id == OverflowTagID) return tagPosition(t);
+    for(auto i : range(size_))
+        {
+        if(id == ids_[i]) return i;
+        }
+    return -1;
+    }
+
 bool TagSet::
 hasTags(TagSet const& ts) const
     {
     if(ts.primeLevel() >= 0 && this->primeLevel() != ts.primeLevel()) return false;
     for(auto i : range(ts.size()))
-        if(this->tagPosition(ts[i]) == -1) return false;
+        if(this->tagPosition(ts[i],ts.ids_[i]) == -1) return false;
     return true;
     }
 
@@ -125,27 +193,36 @@ addTag(Tag const& t)
       }
     else
       {
-      if(size_ == MAX_TAGS) error("Too many tags already, cannot add more. If you want more, consider raising MAX_TAGS.");
-      if(this->tagPosition(t) == -1 && t != Tag())  // If Tag is not found and is not empty, add it
-          {
-          auto i = size_;
-          for(; i>0; --i)
-              {
-              if(t > tags_[i-1]) break;   // Tag comparison uses a cast to a long int
-              else               tags_[i] = tags_[i-1];
-              }
-          tags_[i] = t;
-          size_++;
-          }
+      this->addTag(t,internTag(t));
       }
     }
 
+// Adds a non-integer Tag with ID id
+void TagSet::
+addTag(Tag const& t, TagID id)
+    {
+    if(size_ == MAX_TAGS) error("Too many tags already, cannot add more. If you want more, consider raising MAX_TAGS.");
+    if(this->tagPosition(t,id) == -1 && t != Tag())  // If Tag is not found and is not empty, add it
+        {
+        auto i = size_;
+        for(; i>0; --i)
+            {
+            if(t > tags_[i-1]) break;   // Tag comparison uses a cast to a long int
+            tags_[i] = tags_[i-1];
+            ids_[i] = ids_[i-1];
+            }
+        tags_[i] = t;
+        ids_[i] = id;
+        size_++;
+        }
+    }
+
 void TagSet::
 addTags(TagSet const& ts)
     {
     if(ts.primeLevel() >= 0) throw std::runtime_error("Cannot add integer tag to a TagSet");
     for(auto i : range(ts.size()))
-        this->addTag(ts[i]);
+        this->addTag(ts[i],ts.ids_[i]);
     }
 
 TagSet
@@ -156,15 +233,23 @@ addTags(TagSet T, TagSet const& ts)
     }
 
 void TagSet::
-removeTag(Tag const& t)
+removeTagAt(size_t loc)
     {
-    auto loc = this->tagPosition(t);
-    if(loc > -1)
+    for(size_t i = loc; i+1 < size_; ++i)
         {
-        for(size_t i = loc; i<size_; ++i)
-            tags_[i] = tags_[i+1];
-        size_--;
+        tags_[i] = tags_[i+1];
+        ids_[i] = ids_[i+1];
         }
+    size_--;
+    tags_[size_] = Tag();
+    ids_[size_] = 0;
+    }
+
+void TagSet::
+removeTag(Tag const& t)
+    {
+    auto loc = this->tagPosition(t);
+    if(loc > -1) removeTagAt(loc);
     }
 
 void TagSet::
@@ -172,15 +257,17 @@ removeTags(TagSet const& ts)
     {
     if(ts.primeLevel() >= 0) throw std::runtime_error("Cannot remove integer tag from a TagSet");
     for(auto i : range(ts.size()))
-        this->removeTag(ts[i]);
+        {
+        auto loc = this->tagPosition(ts[i],ts.ids_[i]);
+        if(loc > -1) removeTagAt(loc);
+        }
     }
 
 void TagSet::
 setTags(TagSet const& ts)
     {
-    auto maxtags = std::max(size_,ts.size());
-    for(auto i : range(maxtags))
-      tags_[i] = ts[i];
+    tags_ = ts.tags_;
+    ids_ = ts.ids_;
     size_ = ts.size();
     if(ts.primeLevel() < 0) primelevel_ = 0;
     else primelevel_ = ts.primeLevel();
@@ -189,6 +276,8 @@ setTags(TagSet const& ts)
 void TagSet::
 noTags()
     {
+    tags_.fill(Tag());
+    ids_.fill(0);
     size_ = 0;
     primelevel_ = 0;
     }
@@ -213,9 +302,12 @@ replaceTags(TagSet const& tsremove, TagSet const& tsadd)
     if(plremove >= 0) primelevel_ = pladd;
     // Remove and add the tags
     for(auto i : range(tsremove.size()))
-        this->removeTag(tsremove[i]);
+        {
+        auto loc = this->tagPosition(tsremove[i],tsremove.ids_[i]);
+        if(loc > -1) removeTagAt(loc);
+        }
     for(auto i : range(tsadd.size()))
-        this->addTag(tsadd[i]);
+        this->addTag(tsadd[i],tsadd.ids_[i]);
     }
 
 std::string
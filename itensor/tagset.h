@@ -15,6 +15,7 @@
 //
 #ifndef __ITENSOR_TAGSET_H
 #define __ITENSOR_TAGSET_H
+#include <cstdint>
 #include "itensor/smallstring.h"
 #include "itensor/global.h"
 #include "itensor/util/h5/wrap_h5.hpp"
@@ -23,19 +24,49 @@ namespace itensor {
 
 using Tag = SmallString;
 
+//
+// Tag interning
+//
+// Every distinct tag is assigned a small integer ID
+// from a global table the first time it is seen (the
+// empty tag has ID 0). IDs are only meaningful within
+// one run of a program; files store the tag strings.
+//
+// Should the table ever fill up, further tags all share
+// the ID OverflowTagID and are told apart by their strings.
+//
+
+using TagID = std::uint16_t;
+
+TagID const OverflowTagID = 0xFFFF;
+
+TagID
+internTag(Tag const& t);
+
+// Number of distinct tags interned so far
+size_t
+internedTagCount();
+
 class TagSet;
 
 //
 // TagSet
 //
+// Holds its tags sorted, both as strings and as interned
+// IDs, so that two TagSets can be compared or hashed by
+// looking only at their (MAX_TAGS*2 bytes of) IDs.
+//
 
 class TagSet
     {
     public:
     using tags_type = std::array<Tag,MAX_TAGS>;
+    using ids_type = std::array<TagID,MAX_TAGS>;
     using prime_type = int;
     private:
     tags_type tags_;
+    //ids_[i] is the ID of tags_[i]; unused entries are 0
+    ids_type ids_ = {};
     prime_type primelevel_ = -1;
     size_t size_ = 0;
     public:
@@ -54,8 +85,17 @@ class TagSet
     Tag const&
     operator[](int i) const { return tags_[i]; }
 
-    Tag &
-    operator[](int i) { return tags_[i]; }
+    ids_type const&
+    ids() const { return ids_; }
+
+    // True if two distinct tags of this TagSet
+    // could share an ID (see OverflowTagID)
+    bool
+    hasOverflowIDs() const
+        {
+        for(auto id : ids_) if(id == OverflowTagID) return true;
+        return false;
+        }
 
     int
     primeLevel() const { return primelevel_;}
@@ -108,6 +148,16 @@ class TagSet
     void
     replaceTags(TagSet const& tsremove, TagSet const& tsadd);
 
+    private:
+
+    int
+    tagPosition(Tag const& t, TagID id) const;
+
+    void
+    addTag(Tag const& t, TagID id);
+
+    void
+    removeTagAt(size_t loc);
     };
 
 // Get the number of tags in the TagSet
@@ -120,11 +170,24 @@ primeLevel(TagSet const& ts);
 TagSet
 setPrime(TagSet ts, int plev);
 
-bool
-operator==(TagSet const& t1, TagSet const& t2);
+namespace detail {
 
 bool
-operator!=(TagSet const& t1, TagSet const& t2);
+sameTagStrings(TagSet const& t1, TagSet const& t2);
+
+} //namespace detail
+
+// Equal IDs mean equal tags unless an ID is shared
+// by overflow tags, which are then compared as strings
+bool inline
+operator==(TagSet const& t1, TagSet const& t2)
+    {
+    if(t1.primeLevel() != t2.primeLevel() || t1.ids() != t2.ids()) return false;
+    return !t1.hasOverflowIDs() || detail::sameTagStrings(t1,t2);
+    }
+
+bool inline
+operator!=(TagSet const& t1, TagSet const& t2) { return !(t1==t2); }
     
 bool
 hasTags(TagSet const& T, TagSet const& ts);
@@ -80,6 +80,54 @@ namespace detail {
         return info;
         }
 
+    template<typename T>
+    void
+    unpivotR(int M, int N, T const* Adata, std::vector<LAPACK_INT> const& jpvt, T *Rdata)
+        {
+        //Row i of the pivoted R holds elements j >= i;
+        //put element j back into column jpvt[j]-1
+        auto K = std::min(M,N);
+        std::fill(Rdata,Rdata+K*N,T(0));
+        for(int j = 0; j < N; ++j)
+            {
+            auto c = jpvt[j]-1;
+            for(int i = 0; i <= std::min(j,K-1); ++i)
+                {
+                Rdata[i + c*K] = Adata[i+j*M];
+                }
+            }
+        }
+
+    int
+    QRPivot(int M, int N, Real *Qdata, Real *Rdata)
+        {
+        LAPACK_INT _M = M, _N = N;
+        LAPACK_INT K = std::min(_M,_N);
+        LAPACK_INT info = 0;
+        std::vector<LAPACK_INT> jpvt(_N,0);
+        std::vector<LAPACK_REAL> tau(K);
+        dgeqp3_wrapper(&_M, &_N, Qdata, &_M, jpvt.data(), tau.data(), &info);
+        if(info != 0) return info;
+        unpivotR(M,N,Qdata,jpvt,Rdata);
+        dorgqr_wrapper(&_M, &K, &K, Qdata, &_M, tau.data(), &info);
+        return info;
+        }
+
+    int
+    QRPivot(int M, int N, Cplx *Qdata, Cplx *Rdata)
+        {
+        LAPACK_INT _M = M, _N = N;
+        LAPACK_INT K = std::min(_M,_N);
+        LAPACK_INT info = 0;
+        std::vector<LAPACK_INT> jpvt(_N,0);
+        std::vector<LAPACK_COMPLEX> tau(K);
+        zgeqp3_wrapper(&_M, &_N, Qdata, &_M, jpvt.data(), tau.data(), &info);
+        if(info != 0) return info;
+        unpivotR(M,N,Qdata,jpvt,Rdata);
+        zungqr_wrapper(&_M, &K, &K, Qdata, &_M, tau.data(), &info);
+        return info;
+        }
+
 
   int
   SVD_gesdd(int M, int N, Cplx * Adata, Cplx * Udata, Real * Ddata, Cplx * Vdata)
@@ -135,6 +135,25 @@ QR(MatA && A,
    MatR && R,
    const Args & args = Args::global());
 
+//
+// Compute the QR decomposition with column pivoting
+// of an MxN matrix A, A = Q*R, where Q is M x min(M,N)
+// with orthonormal columns and the columns of R are
+// ordered like those of A (so R is upper triangular
+// only up to a permutation of its columns).
+// Pivoting makes the rows of R come out in order of
+// roughly decreasing norm, such that discarding the
+// last rows of R gives a good low-rank approximation
+// of A whose error is the norm of the discarded rows.
+//
+template<class MatA, 
+         class MatQ,
+         class MatR>
+void
+pivotedQR(MatA && A,
+          MatQ && Q,
+          MatR && R);
+
 //
 // Hermitian Matrix exponentiate
 // by diagHermitian
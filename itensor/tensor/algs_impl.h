@@ -73,6 +73,11 @@ copyNegElts(Iter mre,
   int
   QR(int M, int N, int Rrows, Cplx *Qdata,Cplx *Rdata);
 
+  int
+  QRPivot(int M, int N, Real *Qdata, Real *Rdata);
+  int
+  QRPivot(int M, int N, Cplx *Qdata, Cplx *Rdata);
+
   int
   SVD_gesdd(int M, int N, Cplx * Adata, Cplx * Udata, Real * Ddata, Cplx * Vdata);
 
@@ -350,6 +355,40 @@ QR( MatA&& A,
       }
    }
 
+template<class MatA, 
+         class MatQ,
+         class MatR>
+void
+pivotedQR(MatA && A,
+          MatQ && Q,
+          MatR && R)
+    {
+    using Aval = typename stdx::decay_t<MatA>::value_type;
+    using Qval = typename stdx::decay_t<MatQ>::value_type;
+    static_assert((isReal<Aval>() && isReal<Qval>()) || (isCplx<Aval>() && isCplx<Qval>()),
+                  "A and Q must be both real or both complex in pivotedQR");
+    int M = nrows(A);
+    int N = ncols(A);
+    if(M < 1 or N < 1) throw std::runtime_error("pivotedQR: 0 dimensional matrix");
+    auto K = std::min(M,N);
+    //Q holds a copy of A, overwritten by the factorization
+    resize(Q,M,N);
+    resize(R,K,N);
+#ifdef DEBUG
+    if(!isContiguous(Q))
+        throw std::runtime_error("pivotedQR: Q must be contiguous");
+    if(!isContiguous(R))
+        throw std::runtime_error("pivotedQR: R must be contiguous");
+#endif
+    makeRef(Q) &= A;
+    auto info = detail::QRPivot(M,N,Q.data(),R.data());
+    if(info != 0) 
+        {
+        throw std::runtime_error("Error condition in pivotedQR");
+        }
+    reduceCols(Q,K);
+    }
+
 
   template<typename T>
   void
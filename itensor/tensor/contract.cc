@@ -14,11 +14,14 @@
 // limitations under the License.
 //
 //TODO: replace unordered_map with a simpler container (small_map? or jump directly to location?)
+#include <array>
 #include <unordered_map>
 #include <future>
 
 #include "itensor/util/multalloc.h"
 #include "itensor/util/cputime.h"
+#include "itensor/util/contracttrace.h"
+#include "itensor/util/scratch.h"
 #include "itensor/detail/algs.h"
 #include "itensor/detail/gcounter.h"
 #include "itensor/tensor/mat.h"
@@ -740,6 +743,8 @@ contract(CProps const& p,
          Real beta = 0.)
     {
     using VC = common_type<VA,VB>;
+    auto trace = ContractTrace::enabled();
+    auto t0 = trace ? ContractTrace::now() : ContractTrace::time_point{};
     auto Apsize = p.permuteA() ? dim(p.newArange) : 0ul;
     auto Bpsize = p.permuteB() ? dim(p.newBrange) : 0ul;
     auto Cpsize = p.permuteC() ? dim(p.newCrange) : 0ul;
@@ -747,7 +752,7 @@ contract(CProps const& p,
     auto Bbufsize = isCplx(B) ? 2ul*Bpsize : Bpsize;
     auto Cbufsize = isCplx(C) ? 2ul*Cpsize : Cpsize;
 
-    auto d = vector_no_init<Real>(Abufsize+Bbufsize+Cbufsize);
+    auto d = scratchBuffer<Real>(Abufsize+Bbufsize+Cbufsize);
     auto ab = MAKE_SAFE_PTR(d.data(),d.size());
     auto bb = ab+Abufsize;
     auto cb = bb+Bbufsize;
@@ -812,8 +817,12 @@ contract(CProps const& p,
             }
         }
 
+    auto t1 = trace ? ContractTrace::now() : t0;
+
     gemm(aref,bref,cref,alpha,beta);
 
+    auto t2 = trace ? ContractTrace::now() : t0;
+
     if(p.permuteC())
         {
 #ifdef DEBUG
@@ -821,6 +830,38 @@ contract(CProps const& p,
 #endif
         C &= permute(newC,p.PC);
         }
+
+    if(trace)
+        {
+        auto t3 = ContractTrace::now();
+        auto r = ContractRecord{};
+        r.kind = ContractRecord::Contract;
+        for(auto j : range(A.order())) r.Adims.push_back(A.extent(j));
+        for(auto j : range(B.order())) r.Bdims.push_back(B.extent(j));
+        for(auto j : range(C.order())) r.Cdims.push_back(C.extent(j));
+        r.m = p.dleft;
+        r.k = p.dmid;
+        r.n = p.dright;
+        r.Acplx = isCplx(A);
+        r.Bcplx = isCplx(B);
+        r.permA = p.permuteA();
+        r.permB = p.permuteB();
+        r.permC = p.permuteC();
+        r.flops = gemmFlops(r.m,r.k,r.n,r.Acplx,r.Bcplx);
+        //Each permuted tensor is read once and written once
+        //into its buffer before the gemm reads it again
+        auto sA = sizeof(VA)*double(p.dleft*p.dmid),
+             sB = sizeof(VB)*double(p.dmid*p.dright),
+             sC = sizeof(VC)*double(p.dleft*p.dright);
+        r.bytes = sA+sB+sC*(beta != 0. ? 2 : 1);
+        if(p.permuteA()) r.bytes += 2*sA;
+        if(p.permuteB()) r.bytes += 2*sB;
+        if(p.permuteC()) r.bytes += 2*sC;
+        r.tpermute = ContractTrace::seconds(t0,t1)+ContractTrace::seconds(t2,t3);
+        r.tgemm = ContractTrace::seconds(t1,t2);
+        r.ttotal = ContractTrace::seconds(t0,t3);
+        ContractTrace::record(r);
+        }
     }
 
 template<typename R, typename T1, typename T2>
@@ -840,6 +881,221 @@ contractScalar(T1 a,
         transform(PB,C,[fac,beta](T2 b, T3& c){ c = fac*b+beta*c; });
     }
 
+//
+// Contraction of small tensors by direct loops
+//
+// For tensors such as site operators and gates the
+// multiply-adds take far less time than computing the
+// CProps, permuting and calling gemm. Contractions of
+// tensors with at most SmallMaxOrder indices each, and
+// at most SmallMaxWork multiply-adds, instead loop over
+// the indices of C (outer) and the contracted indices
+// (inner) with the number of each fixed at compile time,
+// so that the index arithmetic is unrolled and nothing
+// is allocated.
+//
+
+namespace {
+
+int const SmallMaxOrder = 4;
+long const SmallMaxWork = 1024;
+
+//Extents of the indices of C and of the contracted
+//indices, with their strides in each tensor
+//(zero for tensors not having that index)
+template<int NC, int NK>
+struct SmallPlan
+    {
+    std::array<long,NC> cext = {},
+                        castr = {},
+                        cbstr = {},
+                        ccstr = {};
+    std::array<long,NK> kext = {},
+                        kastr = {},
+                        kbstr = {};
+    };
+
+template<int NC, int NK, typename VA, typename VB, typename VC>
+void
+smallContract(SmallPlan<NC,NK> const& P,
+              VA const* pa,
+              VB const* pb,
+              VC * pc,
+              Real alpha,
+              Real beta)
+    {
+    auto ci = std::array<long,NC>{};
+    long aoff = 0,
+         boff = 0,
+         coff = 0;
+    while(true)
+        {
+        auto sum = VC(0);
+        if constexpr(NK == 0)
+            {
+            sum = pa[aoff]*pb[boff];
+            }
+        else if constexpr(NK == 1)
+            {
+            for(long k = 0; k < P.kext[0]; ++k)
+                {
+                sum += pa[aoff+k*P.kastr[0]]*pb[boff+k*P.kbstr[0]];
+                }
+            }
+        else
+            {
+            auto ki = std::array<long,NK>{};
+            long ka = aoff,
+                 kb = boff;
+            while(true)
+                {
+                sum += pa[ka]*pb[kb];
+                int j = 0;
+                for(; j < NK; ++j)
+                    {
+                    ++ki[j];
+                    ka += P.kastr[j];
+                    kb += P.kbstr[j];
+                    if(ki[j] < P.kext[j]) break;
+                    ka -= ki[j]*P.kastr[j];
+                    kb -= ki[j]*P.kbstr[j];
+                    ki[j] = 0;
+                    }
+                if(j == NK) break;
+                }
+            }
+        auto& c = pc[coff];
+        if(beta == 0.) c = alpha*sum;
+        else           c = alpha*sum+beta*c;
+
+        int i = 0;
+        for(; i < NC; ++i)
+            {
+            ++ci[i];
+            aoff += P.castr[i];
+            boff += P.cbstr[i];
+            coff += P.ccstr[i];
+            if(ci[i] < P.cext[i]) break;
+            aoff -= ci[i]*P.castr[i];
+            boff -= ci[i]*P.cbstr[i];
+            coff -= ci[i]*P.ccstr[i];
+            ci[i] = 0;
+            }
+        if(i == NC) break;
+        }
+    }
+
+template<int NC, int NK, typename RangeT, typename VA, typename VB, typename VC>
+void
+smallContract(TenRefc<RangeT,VA> const& A, Labels const& ai,
+              TenRefc<RangeT,VB> const& B, Labels const& bi,
+              TenRef<RangeT,VC>  const& C, Labels const& ci,
+              Real alpha,
+              Real beta)
+    {
+    auto P = SmallPlan<NC,NK>{};
+    for(auto ic : range(NC))
+        {
+        P.cext[ic] = C.extent(ic);
+        P.ccstr[ic] = C.stride(ic);
+        auto ia = find_index(ai,ci[ic]);
+        if(ia >= 0) P.castr[ic] = A.stride(ia);
+        auto ib = find_index(bi,ci[ic]);
+        if(ib >= 0) P.cbstr[ic] = B.stride(ib);
+        }
+    int k = 0;
+    for(auto ia : range(ai))
+        {
+        auto ib = find_index(bi,ai[ia]);
+        if(ib < 0) continue;
+        P.kext[k] = A.extent(ia);
+        P.kastr[k] = A.stride(ia);
+        P.kbstr[k] = B.stride(ib);
+        ++k;
+        }
+    smallContract<NC,NK>(P,A.data(),B.data(),C.data(),alpha,beta);
+    }
+
+//Returns false, doing nothing, if the
+//contraction is too large for smallContract
+template<typename RangeT, typename VA, typename VB, typename VC>
+bool
+trySmallContract(TenRefc<RangeT,VA> const& A, Labels const& ai,
+                 TenRefc<RangeT,VB> const& B, Labels const& bi,
+                 TenRef<RangeT,VC>  const& C, Labels const& ci,
+                 Real alpha,
+                 Real beta)
+    {
+    int rA = ai.size(),
+        rB = bi.size(),
+        rC = ci.size();
+    if(rA > SmallMaxOrder || rB > SmallMaxOrder || rC > SmallMaxOrder) return false;
+    //Sizes of the equivalent matrix product
+    long m = 1,
+         k = 1,
+         n = 1;
+    int nk = 0;
+    for(auto ia : range(rA))
+        {
+        if(find_index(bi,ai[ia]) < 0)
+            {
+            m *= A.extent(ia);
+            continue;
+            }
+        k *= A.extent(ia);
+        ++nk;
+        }
+    for(auto ib : range(rB))
+        {
+        if(find_index(ai,bi[ib]) < 0) n *= B.extent(ib);
+        }
+    if(m*k*n > SmallMaxWork) return false;
+    //Labels repeated within A or B (traces) or
+    //missing from C are left to the general case
+    if(rA+rB != rC+2*nk) return false;
+
+    auto trace = ContractTrace::enabled();
+    auto t0 = trace ? ContractTrace::now() : ContractTrace::time_point{};
+
+    using Call = void (*)(TenRefc<RangeT,VA> const&, Labels const&,
+                          TenRefc<RangeT,VB> const&, Labels const&,
+                          TenRef<RangeT,VC>  const&, Labels const&,
+                          Real, Real);
+    using Row = std::array<Call,SmallMaxOrder+1>;
+    //Indexed by the order of C, then the number of contracted indices
+    static std::array<Row,SmallMaxOrder+1> const calls =
+        {{
+        Row{{&smallContract<0,0>,&smallContract<0,1>,&smallContract<0,2>,&smallContract<0,3>,&smallContract<0,4>}},
+        Row{{&smallContract<1,0>,&smallContract<1,1>,&smallContract<1,2>,&smallContract<1,3>,&smallContract<1,4>}},
+        Row{{&smallContract<2,0>,&smallContract<2,1>,&smallContract<2,2>,&smallContract<2,3>,&smallContract<2,4>}},
+        Row{{&smallContract<3,0>,&smallContract<3,1>,&smallContract<3,2>,&smallContract<3,3>,&smallContract<3,4>}},
+        Row{{&smallContract<4,0>,&smallContract<4,1>,&smallContract<4,2>,&smallContract<4,3>,&smallContract<4,4>}}
+        }};
+    calls[rC][nk](A,ai,B,bi,C,ci,alpha,beta);
+
+    if(trace)
+        {
+        auto r = ContractRecord{};
+        r.kind = ContractRecord::Contract;
+        for(auto j : range(rA)) r.Adims.push_back(A.extent(j));
+        for(auto j : range(rB)) r.Bdims.push_back(B.extent(j));
+        for(auto j : range(rC)) r.Cdims.push_back(C.extent(j));
+        r.m = m;
+        r.k = k;
+        r.n = n;
+        r.Acplx = isCplx(A);
+        r.Bcplx = isCplx(B);
+        r.flops = gemmFlops(m,k,n,r.Acplx,r.Bcplx);
+        r.bytes = sizeof(VA)*double(dim(A.range()))+sizeof(VB)*double(dim(B.range()))
+                 +sizeof(VC)*double(dim(C.range()));
+        r.ttotal = ContractTrace::seconds(t0,ContractTrace::now());
+        ContractTrace::record(r);
+        }
+    return true;
+    }
+
+} //namespace
+
 template<typename RangeT, typename VA, typename VB>
 void 
 contract(TenRefc<RangeT,VA> A, Labels const& ai, 
@@ -857,7 +1113,7 @@ contract(TenRefc<RangeT,VA> A, Labels const& ai,
         {
         contractScalar(*B.data(),A,ai,C,ci,alpha,beta);
         }
-    else
+    else if(!trySmallContract(A,ai,B,bi,C,ci,alpha,beta))
         {
         CProps props(ai,bi,ci);
         props.compute(A,B,C);
@@ -263,9 +263,11 @@ contractDiagPartial(DiagElsA           const& A, Labels const& al,
             }
         }
 
+    //Uncontracted indices of B, in order, with their
+    //extents and their strides in B and C
+    auto uext = IntArray(nbu,0);
     auto bustride = IntArray(nbu,0);
     auto custride = IntArray(nbu,0);
-    auto GC = detail::GCounter(nbu);
     int n = 0;
     for(auto ib : range(bl))
         {
@@ -274,7 +276,7 @@ contractDiagPartial(DiagElsA           const& A, Labels const& al,
 #ifdef DEBUG
             if(n >= nbu) Error("n out of range");
 #endif
-            GC.setRange(n,0,B.extent(ib)-1);
+            uext[n] = B.extent(ib);
             bustride[n] = B.stride(ib);
             auto ic = find_index(cl,bl[ib]);
 #ifdef DEBUG
@@ -284,22 +286,62 @@ contractDiagPartial(DiagElsA           const& A, Labels const& al,
             ++n;
             }
         }
-    auto pb = MAKE_SAFE_PTR(B.data(),B.size());
-    auto pc = MAKE_SAFE_PTR(C.data(),C.size());
-    for(;GC.notDone();++GC)
+
+    //Leading uncontracted indices of B which are also the
+    //leading indices of C, laid out contiguously in both,
+    //are run over as a single unit-stride inner loop. For a
+    //matrix times singular values, or any other scaling along
+    //one axis, each element of B and C is then visited once.
+    long inner = 1;
+    int nlead = 0;
+    for(auto ib : range(bl))
+        {
+        if(bl[ib] <= 0 || ib >= cl.size() || cl[ib] != bl[ib]) break;
+        if(long(B.stride(ib)) != inner || long(C.stride(ib)) != inner) break;
+        inner *= B.extent(ib);
+        ++nlead;
+        }
+
+    long nouter = 1;
+    for(auto i : range(nlead,nbu)) nouter *= uext[i];
+    long nJ = A.size();
+
+    auto pb = B.data()+bstart;
+    auto pc = C.data()+cstart;
+    auto scaleAdd = [&](long o, long J0, long J1)
         {
-        size_t coffset = 0;
         size_t boffset = 0;
-        for(auto i : range(nbu))
+        size_t coffset = 0;
+        for(auto i : range(nlead,nbu))
             {
-            auto ii = GC[i];
+            auto ii = o%uext[i];
+            o /= uext[i];
             boffset += ii*bustride[i];
             coffset += ii*custride[i];
             }
-        for(auto J : range(A))
+        for(auto J = J0; J < J1; ++J)
             {
-            pc[cstart+J*c_cstride+coffset] += A(J)*pb[bstart+J*b_cstride+boffset];
+            auto a = A(J);
+            auto* b = pb+J*b_cstride+boffset;
+            auto* c = pc+J*c_cstride+coffset;
+            for(long i = 0; i < inner; ++i) c[i] += a*b[i];
             }
+        };
+
+    //Different outer indices write to different elements
+    //of C, as do different diagonal elements unless C
+    //does not carry an index of A (a partial trace)
+    auto parallel = (nouter*nJ*inner >= (1l << 16));
+    (void) parallel;
+    if(nouter == 1 && c_cstride != 0)
+        {
+#pragma omp parallel for schedule(static) if(parallel)
+        for(long J = 0; J < nJ; ++J) scaleAdd(0,J,J+1);
+        }
+    else
+        {
+#pragma omp parallel for schedule(static) if(parallel)
+        for(long o = 0; o < nouter; ++o) scaleAdd(o,0,nJ);
         }
     }
 
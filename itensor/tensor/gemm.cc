@@ -16,6 +16,8 @@
 #include "itensor/tensor/lapack_wrap.h"
 #include "itensor/tensor/slicemat.h"
 #include "itensor/util/safe_ptr.h"
+#include "itensor/util/contracttrace.h"
+#include "itensor/util/scratch.h"
 
 namespace itensor {
 
@@ -98,7 +100,7 @@ gemm_emulator(MatRefc<VA> A,
     auto Brd = SAFE_REINTERPRET(const Real,Bd);
     auto Crd = SAFE_REINTERPRET(Real,Cd);
 
-    auto d = vector_no_init<Real>(Abufsize+Bbufsize+Cbufsize);
+    auto d = scratchBuffer<Real>(Abufsize+Bbufsize+Cbufsize);
     auto pd = MAKE_SAFE_PTR(d.data(),d.size());
     auto ab = pd;
     auto ae = ab+Abufsize;
@@ -274,6 +276,9 @@ gemm(MatRefc<VA> A,
         throw std::runtime_error("mult(_add) AxB -> C: matrix C incompatible");
         }
 #endif
+    auto trace = ContractTrace::enabled();
+    auto t0 = trace ? ContractTrace::now() : ContractTrace::time_point{};
+
     if(isTransposed(C))
         {
         //Do C = Bt*At instead of Ct=A*B
@@ -285,6 +290,27 @@ gemm(MatRefc<VA> A,
         {
         gemm_impl(A,B,C,alpha,beta);
         }
+
+    if(trace)
+        {
+        auto t1 = ContractTrace::now();
+        auto r = ContractRecord{};
+        r.kind = ContractRecord::Gemm;
+        r.m = nrows(A);
+        r.k = ncols(A);
+        r.n = ncols(B);
+        r.Adims = {r.m,r.k};
+        r.Bdims = {r.k,r.n};
+        r.Cdims = {r.m,r.n};
+        r.Acplx = isCplx(A);
+        r.Bcplx = isCplx(B);
+        r.flops = gemmFlops(r.m,r.k,r.n,r.Acplx,r.Bcplx);
+        r.bytes = sizeof(VA)*double(A.size())+sizeof(VB)*double(B.size())
+                 +sizeof(common_type<VA,VB>)*double(C.size())*(beta != 0. ? 2 : 1);
+        r.tgemm = ContractTrace::seconds(t0,t1);
+        r.ttotal = r.tgemm;
+        ContractTrace::record(r);
+        }
     }
 template void gemm(MatRefc<Real>, MatRefc<Real>, MatRef<Real>,Real,Real);
 template void gemm(MatRefc<Real>, MatRefc<Cplx>, MatRef<Cplx>,Real,Real);
@@ -582,6 +582,57 @@ zungqr_wrapper(LAPACK_INT* m,     //number of rows of A
     #endif
     }
 
+//
+// dgeqp3
+//
+// QR factorization with column pivoting of a real matrix A
+//
+void 
+dgeqp3_wrapper(LAPACK_INT* m,     //number of rows of A
+               LAPACK_INT* n,     //number of cols of A
+               LAPACK_REAL* A,    //matrix A
+                                  //on return upper triangle contains R
+               LAPACK_INT* lda,   //size of A (usually same as m)
+               LAPACK_INT* jpvt,  //on return, column j of A*P is column jpvt[j]-1 of A
+               LAPACK_REAL* tau,  //scalar factors of elementary reflectors
+               LAPACK_INT* info)  //error info
+    {
+    //Workspace query
+    LAPACK_INT lwork = -1;
+    LAPACK_REAL wkopt = 0;
+    F77NAME(dgeqp3)(m,n,A,lda,jpvt,tau,&wkopt,&lwork,info);
+    lwork = std::max(LAPACK_INT(wkopt),3*(*n)+1);
+    std::vector<LAPACK_REAL> work(lwork);
+    F77NAME(dgeqp3)(m,n,A,lda,jpvt,tau,work.data(),&lwork,info);
+    }
+
+//
+// zgeqp3
+//
+// QR factorization with column pivoting of a complex matrix A
+//
+void 
+zgeqp3_wrapper(LAPACK_INT* m,     //number of rows of A
+               LAPACK_INT* n,     //number of cols of A
+               Cplx* A,           //matrix A
+                                  //on return upper triangle contains R
+               LAPACK_INT* lda,   //size of A (usually same as m)
+               LAPACK_INT* jpvt,  //on return, column j of A*P is column jpvt[j]-1 of A
+               LAPACK_COMPLEX* tau,  //scalar factors of elementary reflectors
+               LAPACK_INT* info)  //error info
+    {
+    static_assert(sizeof(LAPACK_COMPLEX)==sizeof(Cplx),"LAPACK_COMPLEX and itensor::Cplx have different size");
+    auto pA = reinterpret_cast<LAPACK_COMPLEX*>(A);
+    std::vector<LAPACK_REAL> rwork(2*(*n));
+    //Workspace query
+    LAPACK_INT lwork = -1;
+    LAPACK_COMPLEX wkopt;
+    F77NAME(zgeqp3)(m,n,pA,lda,jpvt,tau,&wkopt,&lwork,rwork.data(),info);
+    lwork = std::max(LAPACK_INT(realRef(wkopt)),*n+1);
+    std::vector<LAPACK_COMPLEX> work(lwork);
+    F77NAME(zgeqp3)(m,n,pA,lda,jpvt,tau,work.data(),&lwork,rwork.data(),info);
+    }
+
 //
 // dgesv
 //
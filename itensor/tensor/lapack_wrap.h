@@ -41,6 +41,12 @@ namespace itensor {
     {
     LAPACK_REAL real, imag;
     } LAPACK_COMPLEX;
+
+    inline LAPACK_REAL& 
+    realRef(LAPACK_COMPLEX & z) { return z.real; }
+
+    inline LAPACK_REAL& 
+    imagRef(LAPACK_COMPLEX & z) { return z.imag; }
 }
 #elif defined PLATFORM_openblas
 
@@ -352,6 +358,13 @@ void F77NAME(dorgqr)(LAPACK_INT *m, LAPACK_INT *n, LAPACK_INT *k, double *a,
 void F77NAME(zgeqrf)(LAPACK_INT *m, LAPACK_INT *n, LAPACK_COMPLEX *a, LAPACK_INT *lda, 
                      LAPACK_COMPLEX *tau, LAPACK_COMPLEX *work, LAPACK_INT *lwork, LAPACK_INT *info);
 
+void F77NAME(dgeqp3)(LAPACK_INT *m, LAPACK_INT *n, double *a, LAPACK_INT *lda, LAPACK_INT *jpvt,
+                     double *tau, double *work, LAPACK_INT *lwork, LAPACK_INT *info);
+
+void F77NAME(zgeqp3)(LAPACK_INT *m, LAPACK_INT *n, LAPACK_COMPLEX *a, LAPACK_INT *lda, LAPACK_INT *jpvt,
+                     LAPACK_COMPLEX *tau, LAPACK_COMPLEX *work, LAPACK_INT *lwork, double *rwork,
+                     LAPACK_INT *info);
+
 #ifdef PLATFORM_lapacke
 void LAPACKE_zungqr(int matrix_layout, LAPACK_INT *m, LAPACK_INT *n, LAPACK_INT *k, LAPACK_COMPLEX *a, 
                      LAPACK_INT *lda, LAPACK_COMPLEX *tau, LAPACK_COMPLEX *work, LAPACK_INT *lwork, 
@@ -668,6 +681,40 @@ zungqr_wrapper(LAPACK_INT* m,     //number of rows of A
                LAPACK_COMPLEX* tau,  //scalar factors as returned by zgeqrf
                LAPACK_INT* info);  //error info
 
+//
+// dgeqp3
+//
+// QR factorization with column pivoting of a real matrix A,
+// A*P = Q*R, where the diagonal of R is non-increasing in magnitude
+//
+void
+dgeqp3_wrapper(LAPACK_INT* m,     //number of rows of A
+               LAPACK_INT* n,     //number of cols of A
+               LAPACK_REAL* A,    //matrix A
+                                  //on return upper triangle contains R
+               LAPACK_INT* lda,   //size of A (usually same as m)
+               LAPACK_INT* jpvt,  //on return, column j of A*P is column jpvt[j]-1 of A
+                                  //(set to zero on input to let all columns be pivoted)
+               LAPACK_REAL* tau,  //scalar factors of elementary reflectors
+                                  //length should be min(m,n)
+               LAPACK_INT* info);  //error info
+
+//
+// zgeqp3
+//
+// QR factorization with column pivoting of a complex matrix A
+//
+void
+zgeqp3_wrapper(LAPACK_INT* m,     //number of rows of A
+               LAPACK_INT* n,     //number of cols of A
+               Cplx* A,           //matrix A
+                                  //on return upper triangle contains R
+               LAPACK_INT* lda,   //size of A (usually same as m)
+               LAPACK_INT* jpvt,  //on return, column j of A*P is column jpvt[j]-1 of A
+               LAPACK_COMPLEX* tau,  //scalar factors of elementary reflectors
+                                  //length should be min(m,n)
+               LAPACK_INT* info);  //error info
+
 // dgesv
 //
 // computes the solution to system of linear equations A*X = B
@@ -15,10 +15,13 @@
 //
 #include <cerrno>
 #include <algorithm>
+#include <chrono>
+#include <cstdlib>
 #include <iostream>
 #include "itensor/util/args.h"
 #include "itensor/util/error.h"
 #include "itensor/util/readwrite.h"
+#include "itensor/util/print.h"
 
 namespace itensor {
 
@@ -26,6 +29,79 @@ using std::string;
 using std::ostream;
 using std::istream;
 
+namespace {
+
+struct ArgsProfileData
+    {
+    std::atomic<long> lookups{0},
+                      keyed{0},
+                      slotHits{0},
+                      nanoseconds{0};
+    };
+
+ArgsProfileData&
+profileData()
+    {
+    static ArgsProfileData pd;
+    return pd;
+    }
+
+void
+printAtExit()
+    {
+    println(argsStats());
+    }
+
+//Reads ITENSOR_ARGS_PROFILE once, at startup
+bool
+initFromEnv()
+    {
+    auto* val = std::getenv("ITENSOR_ARGS_PROFILE");
+    if(!val || val[0] == '\0') return false;
+    std::atexit(printAtExit);
+    return true;
+    }
+
+std::atomic<bool>&
+enabledFlag()
+    {
+    static std::atomic<bool> enabled_(initFromEnv());
+    return enabled_;
+    }
+
+bool
+enabled() { return enabledFlag().load(std::memory_order_relaxed); }
+
+//Times one public lookup when profiling is on
+class LookupTimer
+    {
+    using clock_type = std::chrono::steady_clock;
+    bool on_ = false,
+         keyed_ = false;
+    clock_type::time_point t0_;
+    public:
+
+    explicit
+    LookupTimer(bool keyed)
+      : on_(enabled()),
+        keyed_(keyed)
+        {
+        if(on_) t0_ = clock_type::now();
+        }
+
+    ~LookupTimer()
+        {
+        if(!on_) return;
+        auto dt = std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now()-t0_);
+        auto& pd = profileData();
+        pd.nanoseconds += dt.count();
+        if(keyed_) pd.keyed += 1;
+        else       pd.lookups += 1;
+        }
+    };
+
+} //namespace
+
 std::string
 chopSpaceEq(std::string name)
     {
@@ -50,6 +126,7 @@ Args::Val::
 Val()
     :
     name_("Null"),
+    hash_(argNameHash(name_)),
     type_(None),
     rval_(NAN)
     { }
@@ -58,6 +135,7 @@ Args::Val::
 Val(const char* name)
     :
     name_(chopSpaceEq(name)),
+    hash_(argNameHash(name_)),
     type_(Boolean),
     rval_(1.0)
     { }
@@ -66,6 +144,7 @@ Args::Val::
 Val(Name const& name)
     :
     name_(chopSpaceEq(name)),
+    hash_(argNameHash(name_)),
     type_(Boolean),
     rval_(1.0)
     { }
@@ -74,6 +153,7 @@ Args::Val::
 Val(Name const& name, bool bval)
     :
     name_(chopSpaceEq(name)),
+    hash_(argNameHash(name_)),
     type_(Boolean),
     rval_((bval ? 1.0 : 0.0))
     { }
@@ -82,6 +162,7 @@ Args::Val::
 Val(Name const& name, const char* sval)
     :
     name_(chopSpaceEq(name)),
+    hash_(argNameHash(name_)),
     type_(String),
     sval_(sval),
     rval_(NAN)
@@ -91,6 +172,7 @@ Args::Val::
 Val(Name const& name, const string& sval)
     :
     name_(chopSpaceEq(name)),
+    hash_(argNameHash(name_)),
     type_(String),
     sval_(sval),
     rval_(NAN)
@@ -100,6 +182,7 @@ Args::Val::
 Val(Name const& name, long ival)
     :
     name_(chopSpaceEq(name)),
+    hash_(argNameHash(name_)),
     type_(Numeric),
     rval_(ival)
     { }
@@ -109,6 +192,7 @@ Args::Val::
 Val(Name const& name, int ival)
     :
     name_(chopSpaceEq(name)),
+    hash_(argNameHash(name_)),
     type_(Numeric),
     rval_(ival)
     { }
@@ -117,6 +201,7 @@ Args::Val::
 Val(Name const& name, unsigned long ival)
     :
     name_(chopSpaceEq(name)),
+    hash_(argNameHash(name_)),
     type_(Numeric),
     rval_(ival)
     { }
@@ -125,6 +210,7 @@ Args::Val::
 Val(Name const& name, unsigned int ival)
     :
     name_(chopSpaceEq(name)),
+    hash_(argNameHash(name_)),
     type_(Numeric),
     rval_(ival)
     { }
@@ -133,6 +219,7 @@ Args::Val::
 Val(Name const& name, Real rval)
     :
     name_(chopSpaceEq(name)),
+    hash_(argNameHash(name_)),
     type_(Numeric),
     rval_(rval)
     { }
@@ -141,6 +228,7 @@ void Args::Val::
 read(std::istream& s)
     { 
     itensor::read(s, name_);
+    hash_ = argNameHash(name_);
     itensor::read(s, type_);
     if(type_ == String)
         itensor::read(s, sval_);
@@ -252,18 +340,31 @@ add(Name const& name, const std::string& sval) { add({name,sval}); }
 void Args::
 add(Name const& name, Real rval) { add({name,rval}); }
 
+void Args::
+add(ArgKey const& key, bool bval) { addKeyed(key,bval); }
+void Args::
+add(ArgKey const& key, long ival) { addKeyed(key,ival); }
+void Args::
+add(ArgKey const& key, int ival) { addKeyed(key,ival); }
+void Args::
+add(ArgKey const& key, const char* sval) { addKeyed(key,std::string(sval)); }
+void Args::
+add(ArgKey const& key, const std::string& sval) { addKeyed(key,sval); }
+void Args::
+add(ArgKey const& key, Real rval) { addKeyed(key,rval); }
+
 bool Args::
 defined(Name const& name) const
     {
-    for(auto& x : vals_)
-        {
-        if(x.name() == name) return true;
-        }
-
-    if(isGlobal()) return false;
+    LookupTimer t(false);
+    return find(name) != nullptr;
+    }
 
-    //otherwise see if global Args contains it
-    return global().defined(name);
+bool Args::
+defined(ArgKey const& key) const
+    {
+    LookupTimer t(true);
+    return find(key) != nullptr;
     }
 
 // Remove an arg from the set - always succeeds
@@ -285,7 +386,7 @@ add(Val const& val)
     if(!val) return;
     for(auto& x : vals_)
         //If already defined, replace
-        if(x.name() == val.name()) 
+        if(x.hash() == val.hash() && x.name() == val.name()) 
             {
             x = val;
             return;
@@ -300,86 +401,214 @@ add(const char* ostring)
     processString(std::string(ostring));
     }
 
- 
-const Args::Val& Args::
-get(Name const& name) const
+size_t Args::
+position(ArgKey const& key) const
     {
-    for(auto& x : vals_)
+    auto n = key.slot();
+    if(n < vals_.size() && vals_[n].matches(key))
         {
-        if(x.name() == name) return x;
+        if(enabled()) profileData().slotHits += 1;
+        return n;
         }
-    //couldn't find the Val in this Args
-    if(isGlobal())
+    for(n = 0; n < vals_.size(); ++n)
         {
-        throw ITError("Requested option " + name + " not found");
+        if(vals_[n].matches(key))
+            {
+            key.slot(n);
+            return n;
+            }
+        }
+    return n;
+    }
+
+Args::Val const* Args::
+find(Name const& name) const
+    {
+    auto h = argNameHash(name);
+    for(auto& x : vals_)
+        {
+        if(x.hash() == h && x.name() == name) return &x;
         }
-    return global().get(name);
+    if(isGlobal()) return nullptr;
+    //otherwise see if global Args contains it
+    return global().find(name);
+    }
+
+Args::Val const* Args::
+find(ArgKey const& key) const
+    {
+    auto n = position(key);
+    if(n < vals_.size()) return &vals_[n];
+    if(isGlobal()) return nullptr;
+    return global().find(key);
+    }
+ 
+const Args::Val& Args::
+get(Name const& name) const
+    {
+    auto* v = find(name);
+    //couldn't find the Val in this Args or the global Args
+    if(!v) throw ITError("Requested option " + name + " not found");
+    return *v;
+    }
+
+const Args::Val& Args::
+get(ArgKey const& key) const
+    {
+    auto* v = find(key);
+    if(!v) throw ITError("Requested option " + Name(key.name()) + " not found");
+    return *v;
     }
 
 bool Args::
 getBool(Name const& name) const
     {
+    LookupTimer t(false);
     return get(name).boolVal();
     }
 
 bool Args::
 getBool(Name const& name, bool default_value) const
     {
-    if(defined(name)) return get(name).boolVal();
-    return default_value;
+    LookupTimer t(false);
+    auto* v = find(name);
+    return v ? v->boolVal() : default_value;
     }
 
  
 string const& Args::
 getString(Name const& name) const
     {
+    LookupTimer t(false);
     return get(name).stringVal();
     }
 
 string const& Args::
 getString(Name const& name, string const& default_value) const
     {
-    if(defined(name)) return get(name).stringVal();
-    return default_value;
+    LookupTimer t(false);
+    auto* v = find(name);
+    return v ? v->stringVal() : default_value;
     }
 
 long Args::
 getInt(Name const& name) const
     {
+    LookupTimer t(false);
     return get(name).intVal();
     }
 
 long Args::
 getInt(Name const& name, long default_value) const
     {
-    if(defined(name)) return get(name).intVal();
-    return default_value;
+    LookupTimer t(false);
+    auto* v = find(name);
+    return v ? v->intVal() : default_value;
     }
 
 size_t Args::
 getSizeT(Name const& name) const
     {
+    LookupTimer t(false);
     return get(name).size_tVal();
     }
 
 size_t Args::
 getSizeT(Name const& name, long default_value) const
     {
-    if(defined(name)) return get(name).size_tVal();
-    return default_value;
+    LookupTimer t(false);
+    auto* v = find(name);
+    return v ? v->size_tVal() : default_value;
     }
 
 Real Args::
 getReal(Name const& name) const
     {
+    LookupTimer t(false);
     return get(name).realVal();
     }
 
 Real Args::
 getReal(Name const& name, Real default_value) const
     {
-    if(defined(name)) return get(name).realVal();
-    return default_value;
+    LookupTimer t(false);
+    auto* v = find(name);
+    return v ? v->realVal() : default_value;
+    }
+
+bool Args::
+getBool(ArgKey const& key) const
+    {
+    LookupTimer t(true);
+    return get(key).boolVal();
+    }
+
+bool Args::
+getBool(ArgKey const& key, bool default_value) const
+    {
+    LookupTimer t(true);
+    auto* v = find(key);
+    return v ? v->boolVal() : default_value;
+    }
+
+string const& Args::
+getString(ArgKey const& key) const
+    {
+    LookupTimer t(true);
+    return get(key).stringVal();
+    }
+
+string const& Args::
+getString(ArgKey const& key, string const& default_value) const
+    {
+    LookupTimer t(true);
+    auto* v = find(key);
+    return v ? v->stringVal() : default_value;
+    }
+
+long Args::
+getInt(ArgKey const& key) const
+    {
+    LookupTimer t(true);
+    return get(key).intVal();
+    }
+
+long Args::
+getInt(ArgKey const& key, long default_value) const
+    {
+    LookupTimer t(true);
+    auto* v = find(key);
+    return v ? v->intVal() : default_value;
+    }
+
+size_t Args::
+getSizeT(ArgKey const& key) const
+    {
+    LookupTimer t(true);
+    return get(key).size_tVal();
+    }
+
+size_t Args::
+getSizeT(ArgKey const& key, long default_value) const
+    {
+    LookupTimer t(true);
+    auto* v = find(key);
+    return v ? v->size_tVal() : default_value;
+    }
+
+Real Args::
+getReal(ArgKey const& key) const
+    {
+    LookupTimer t(true);
+    return get(key).realVal();
+    }
+
+Real Args::
+getReal(ArgKey const& key, Real default_value) const
+    {
+    LookupTimer t(true);
+    auto* v = find(key);
+    return v ? v->realVal() : default_value;
     }
 
 void Args::
@@ -499,4 +728,41 @@ operator<<(ostream & s, Args const& args)
     return s;
     }
 
+void
+argsProfile(bool on) { enabledFlag().store(on); }
+
+bool
+argsProfiling() { return enabled(); }
+
+ArgsStats
+argsStats()
+    {
+    auto& pd = profileData();
+    auto S = ArgsStats{};
+    S.lookups = pd.lookups;
+    S.keyed = pd.keyed;
+    S.slotHits = pd.slotHits;
+    S.seconds = 1E-9*pd.nanoseconds;
+    return S;
+    }
+
+void
+argsResetStats()
+    {
+    auto& pd = profileData();
+    pd.lookups = 0;
+    pd.keyed = 0;
+    pd.slotHits = 0;
+    pd.nanoseconds = 0;
+    }
+
+ostream&
+operator<<(ostream & s, ArgsStats const& S)
+    {
+    auto n = S.lookups+S.keyed;
+    s << format("Args: %d lookups (%d by name, %d keyed, %d slot hits), time = %.4f s (%.1f ns/lookup)",
+                n,S.lookups,S.keyed,S.slotHits,S.seconds,(n > 0 ? 1E9*S.seconds/n : 0.));
+    return s;
+    }
+
 } //namespace itensor
@@ -16,8 +16,12 @@
 #ifndef __ITENSOR_OPTION_H
 #define __ITENSOR_OPTION_H
 
-#include <vector>
+#include <atomic>
+#include <cstdint>
+#include <iostream>
 #include <string>
+#include <string_view>
+#include <vector>
 #include "math.h"
 #include "itensor/types.h"
 #include "itensor/util/infarray.h"
@@ -45,7 +49,76 @@ namespace itensor {
 //   func(T1 t1, T2 t2, ..., const Args& args = Args::global());
 //   which will incur essentially no overhead.
 //   If you intend to add or modify the args set, take it by value.
+// o In code called many times with the same Args (for
+//   example once per bond of a DMRG sweep) look values up
+//   through an ArgKey, see below.
+//
+
+//FNV-1a hash of an option name
+constexpr std::uint64_t
+argNameHash(std::string_view name)
+    {
+    std::uint64_t h = 14695981039346656037ull;
+    for(auto c : name)
+        {
+        h ^= static_cast<unsigned char>(c);
+        h *= 1099511628211ull;
+        }
+    return h;
+    }
+
+//
+// ArgKey - an option name resolved once
+//
+// Looking a value up by Name compares the name against each
+// stored value. An ArgKey hashes its name when constructed and
+// remembers the slot at which the value was last found, so
+// that reading an Args with the same layout again, as when
+// DMRGWorker hands the same Args to davidson and svd at every
+// bond, takes a single comparison:
 //
+//   static ArgKey const MaxDim("MaxDim");
+//   auto maxdim = args.getInt(MaxDim,MAX_DIM);
+//
+// The constructor is constexpr, so keys declared at namespace
+// scope or as function-local statics are initialized at
+// compile time.
+//
+class ArgKey
+    {
+    std::string_view name_;
+    std::uint64_t hash_ = 0;
+    mutable std::atomic<size_t> slot_;
+    public:
+
+    explicit constexpr
+    ArgKey(char const* name)
+      : name_(name),
+        hash_(argNameHash(name_)),
+        slot_(0)
+        { }
+
+    ArgKey(ArgKey const&) = delete;
+
+    ArgKey&
+    operator=(ArgKey const&) = delete;
+
+    std::string_view
+    name() const { return name_; }
+
+    std::uint64_t
+    hash() const { return hash_; }
+
+    private:
+
+    friend class Args;
+
+    size_t
+    slot() const { return slot_.load(std::memory_order_relaxed); }
+
+    void
+    slot(size_t n) const { slot_.store(n,std::memory_order_relaxed); }
+    };
 
 class Args
     {
@@ -111,9 +184,28 @@ class Args
     void
     add(const char* ostring);
 
+    //
+    // Add or overwrite a value through a key;
+    // overwriting does not copy the name
+    //
+    void
+    add(ArgKey const& key, bool bval);
+    void
+    add(ArgKey const& key, long ival);
+    void
+    add(ArgKey const& key, int ival);
+    void
+    add(ArgKey const& key, const char* sval);
+    void
+    add(ArgKey const& key, std::string const& sval);
+    void
+    add(ArgKey const& key, Real rval);
+
     // Check if a specific name is defined in this Args instance
     bool
     defined(Name const& name) const;
+    bool
+    defined(ArgKey const& key) const;
 
     // Remove an arg from the set - always succeeds
     void
@@ -158,6 +250,30 @@ class Args
     Real
     getReal(Name const& name, Real default_val) const;
 
+    //
+    // Same as above, looking values up through a key
+    //
+    bool
+    getBool(ArgKey const& key) const;
+    bool
+    getBool(ArgKey const& key, bool default_val) const;
+    std::string const&
+    getString(ArgKey const& key) const;
+    std::string const&
+    getString(ArgKey const& key, std::string const& default_val) const;
+    long
+    getInt(ArgKey const& key) const;
+    long
+    getInt(ArgKey const& key, long default_val) const;
+    size_t
+    getSizeT(ArgKey const& key) const;
+    size_t
+    getSizeT(ArgKey const& key, long default_val) const;
+    Real
+    getReal(ArgKey const& key) const;
+    Real
+    getReal(ArgKey const& key, Real default_val) const;
+
     // Add contents of other to this
     Args&
     operator+=(Args const& other);
@@ -215,8 +331,26 @@ class Args
     void
     add(Val const& v);
 
+    template<typename T>
+    void
+    addKeyed(ArgKey const& key, T const& val);
+
+    //Position of key in vals_, or vals_.size()
+    //if not defined in this instance
+    size_t
+    position(ArgKey const& key) const;
+
+    //Search this instance, then the global Args;
+    //return nullptr if not found
+    Val const*
+    find(Name const& name) const;
+    Val const*
+    find(ArgKey const& key) const;
+
     Val const&
     get(Name const& name) const;
+    Val const&
+    get(ArgKey const& key) const;
 
     friend std::ostream& 
     operator<<(std::ostream & s, Val const& v);
@@ -230,6 +364,7 @@ class Args
         enum Type { Boolean, Numeric, String, None };
         private:
         Name name_;
+        std::uint64_t hash_ = 0;
         Type type_;
         std::string sval_;
         Real rval_;
@@ -261,6 +396,28 @@ class Args
         Name const&
         name() const { return name_; }
 
+        std::uint64_t
+        hash() const { return hash_; }
+
+        bool
+        matches(ArgKey const& key) const { return hash_ == key.hash() && name_ == key.name(); }
+
+        //
+        // Overwrite the value, keeping the name
+        //
+        void
+        set(bool bval) { type_ = Boolean; sval_.clear(); rval_ = (bval ? 1.0 : 0.0); }
+        void
+        set(long ival) { type_ = Numeric; sval_.clear(); rval_ = ival; }
+        void
+        set(int ival) { type_ = Numeric; sval_.clear(); rval_ = ival; }
+        void
+        set(const char* sval) { type_ = String; sval_ = sval; rval_ = NAN; }
+        void
+        set(std::string const& sval) { type_ = String; sval_ = sval; rval_ = NAN; }
+        void
+        set(Real rval) { type_ = Numeric; sval_.clear(); rval_ = rval; }
+
         bool
         boolVal() const { assertType(Boolean); return bool(rval_); }
 
@@ -319,6 +476,20 @@ Args(Args const& other,
     initialize(other,rest...);
     }
 
+template<typename T>
+void Args::
+addKeyed(ArgKey const& key, T const& val)
+    {
+    auto n = position(key);
+    if(n < vals_.size())
+        {
+        vals_[n].set(val);
+        return;
+        }
+    vals_.push_back(Val(Name(key.name()),val));
+    key.slot(n);
+    }
+
 Args
 operator+(Args args, Args const& other);
 
@@ -328,6 +499,45 @@ operator+(Args args, const char* ostring);
 Args
 operator+(const char* ostring, Args args);
 
+//
+// Profiling of Args lookups
+//
+// Counts the calls to the get and defined methods and the
+// time spent in them, including the cost of reading the
+// clock (comparable to a lookup itself, so the time is an
+// upper bound). Off by default, in which case the cost per
+// lookup is one relaxed atomic load. Turned on by
+// argsProfile(true) or by setting the environment variable
+// ITENSOR_ARGS_PROFILE, which also prints the totals at exit.
+//
+
+struct ArgsStats
+    {
+    //Lookups by Name and through an ArgKey
+    long lookups = 0,
+         keyed = 0;
+    //Keyed lookups resolved by the remembered slot
+    long slotHits = 0;
+    //Wall time spent in lookups, in seconds
+    double seconds = 0.;
+    };
+
+void
+argsProfile(bool on);
+
+bool
+argsProfiling();
+
+//Totals over all threads
+ArgsStats
+argsStats();
+
+void
+argsResetStats();
+
+std::ostream&
+operator<<(std::ostream & s, ArgsStats const& S);
+
 } //namespace itensor
 
 #endif
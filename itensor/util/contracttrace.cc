@@ -0,0 +1,294 @@
+//
+// Copyright 2018 The Simons Foundation, Inc. - All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include "itensor/util/contracttrace.h"
+#include "itensor/util/error.h"
+#include "itensor/util/print.h"
+
+namespace itensor {
+
+using std::string;
+using std::ostream;
+
+namespace {
+
+struct TraceData
+    {
+    std::mutex mutex;
+    std::vector<ContractRecord> records;
+    size_t maxRecords = 1000000;
+    ContractTraceSummary summary;
+    string exitFile;
+    };
+
+TraceData&
+traceData()
+    {
+    static TraceData td;
+    return td;
+    }
+
+int
+histBin(double flops)
+    {
+    if(flops < 1.) return 0;
+    auto b = 1+int(std::log2(flops));
+    if(b >= ContractTraceSummary::NBin) return ContractTraceSummary::NBin-1;
+    return b;
+    }
+
+void
+accumulate(ContractHistBin & B, ContractRecord const& r)
+    {
+    B.count += 1;
+    B.flops += r.flops;
+    B.bytes += r.bytes;
+    B.tpermute += r.tpermute;
+    B.tgemm += r.tgemm;
+    B.ttotal += r.ttotal;
+    }
+
+void
+writeAtExit()
+    {
+    auto& td = traceData();
+    if(td.exitFile.empty()) return;
+    ContractTrace::write(td.exitFile);
+    }
+
+//Reads ITENSOR_CONTRACT_TRACE once, at startup
+bool
+initFromEnv()
+    {
+    auto* fname = std::getenv("ITENSOR_CONTRACT_TRACE");
+    if(!fname || fname[0] == '\0') return false;
+    traceData().exitFile = fname;
+    std::atexit(writeAtExit);
+    return true;
+    }
+
+void
+printDims(ostream & s, std::vector<long> const& dims, char sep)
+    {
+    for(auto j = 0ul; j < dims.size(); ++j)
+        {
+        if(j > 0) s << sep;
+        s << dims[j];
+        }
+    }
+
+void
+printBin(ostream & s, ContractHistBin const& B)
+    {
+    s << "\"count\":" << B.count
+      << ",\"flops\":" << B.flops
+      << ",\"bytes\":" << B.bytes
+      << ",\"tpermute\":" << B.tpermute
+      << ",\"tgemm\":" << B.tgemm
+      << ",\"ttotal\":" << B.ttotal;
+    }
+
+} //namespace
+
+char const*
+kindName(ContractRecord::Kind k)
+    {
+    switch(k)
+        {
+        case ContractRecord::Contract: return "contract";
+        case ContractRecord::Gemm: return "gemm";
+        case ContractRecord::Blocks: return "blocks";
+        }
+    return "unknown";
+    }
+
+std::atomic<bool>& ContractTrace::
+enabledFlag()
+    {
+    static std::atomic<bool> enabled_(initFromEnv());
+    return enabled_;
+    }
+
+void ContractTrace::
+start() { enabledFlag().store(true); }
+
+void ContractTrace::
+stop() { enabledFlag().store(false); }
+
+void ContractTrace::
+reset()
+    {
+    auto& td = traceData();
+    std::lock_guard<std::mutex> lock(td.mutex);
+    td.records.clear();
+    td.summary = ContractTraceSummary{};
+    }
+
+void ContractTrace::
+setMaxRecords(size_t n)
+    {
+    auto& td = traceData();
+    std::lock_guard<std::mutex> lock(td.mutex);
+    td.maxRecords = n;
+    }
+
+void ContractTrace::
+record(ContractRecord const& r)
+    {
+    auto& td = traceData();
+    std::lock_guard<std::mutex> lock(td.mutex);
+    accumulate(td.summary.hist[r.kind][histBin(r.flops)],r);
+    accumulate(td.summary.total[r.kind],r);
+    if(td.records.size() < td.maxRecords) td.records.push_back(r);
+    else                                  td.summary.dropped += 1;
+    }
+
+std::vector<ContractRecord> ContractTrace::
+records()
+    {
+    auto& td = traceData();
+    std::lock_guard<std::mutex> lock(td.mutex);
+    return td.records;
+    }
+
+ContractTraceSummary ContractTrace::
+summary()
+    {
+    auto& td = traceData();
+    std::lock_guard<std::mutex> lock(td.mutex);
+    return td.summary;
+    }
+
+void ContractTrace::
+write(string const& fname)
+    {
+    std::ofstream f(fname);
+    if(!f.is_open()) Error("ContractTrace: could not open file " + fname);
+    auto n = fname.size();
+    if(n >= 4 && fname.substr(n-4) == ".csv") writeCSV(f);
+    else                                      writeJSON(f);
+    }
+
+void ContractTrace::
+writeJSON(ostream & s)
+    {
+    auto recs = records();
+    auto S = summary();
+
+    s << "{\n\"records\":[";
+    for(auto j = 0ul; j < recs.size(); ++j)
+        {
+        auto& r = recs[j];
+        s << (j > 0 ? ",\n" : "\n");
+        s << "{\"kind\":\"" << kindName(r.kind) << "\",\"A\":[";
+        printDims(s,r.Adims,',');
+        s << "],\"B\":[";
+        printDims(s,r.Bdims,',');
+        s << "],\"C\":[";
+        printDims(s,r.Cdims,',');
+        s << "],\"m\":" << r.m << ",\"k\":" << r.k << ",\"n\":" << r.n
+          << ",\"cplx\":[" << r.Acplx << "," << r.Bcplx << "]"
+          << ",\"perm\":[" << r.permA << "," << r.permB << "," << r.permC << "]"
+          << ",\"flops\":" << r.flops
+          << ",\"bytes\":" << r.bytes
+          << ",\"tpermute\":" << r.tpermute
+          << ",\"tgemm\":" << r.tgemm
+          << ",\"ttotal\":" << r.ttotal
+          << ",\"nblocks\":" << r.nblocks
+          << ",\"nCblocks\":" << r.nCblocks << "}";
+        }
+    s << "\n],\n\"histogram\":[";
+    bool first = true;
+    for(auto kind : {ContractRecord::Contract,ContractRecord::Gemm,ContractRecord::Blocks})
+    for(auto b = 0; b < ContractTraceSummary::NBin; ++b)
+        {
+        auto& B = S.hist[kind][b];
+        if(B.count == 0) continue;
+        s << (first ? "\n" : ",\n");
+        first = false;
+        s << "{\"kind\":\"" << kindName(kind) << "\",\"log2flops\":" << b << ",";
+        printBin(s,B);
+        s << "}";
+        }
+    s << "\n],\n\"totals\":{";
+    for(auto kind : {ContractRecord::Contract,ContractRecord::Gemm,ContractRecord::Blocks})
+        {
+        if(kind != ContractRecord::Contract) s << ",";
+        s << "\n\"" << kindName(kind) << "\":{";
+        printBin(s,S.total[kind]);
+        s << "}";
+        }
+    s << "\n},\n\"dropped\":" << S.dropped << "\n}\n";
+    }
+
+void ContractTrace::
+writeCSV(ostream & s)
+    {
+    auto recs = records();
+    auto S = summary();
+
+    s << "kind,A,B,C,m,k,n,Acplx,Bcplx,permA,permB,permC,"
+         "flops,bytes,tpermute,tgemm,ttotal,nblocks,nCblocks\n";
+    for(auto& r : recs)
+        {
+        s << kindName(r.kind) << ",";
+        printDims(s,r.Adims,'x');
+        s << ",";
+        printDims(s,r.Bdims,'x');
+        s << ",";
+        printDims(s,r.Cdims,'x');
+        s << "," << r.m << "," << r.k << "," << r.n
+          << "," << r.Acplx << "," << r.Bcplx
+          << "," << r.permA << "," << r.permB << "," << r.permC
+          << "," << r.flops << "," << r.bytes
+          << "," << r.tpermute << "," << r.tgemm << "," << r.ttotal
+          << "," << r.nblocks << "," << r.nCblocks << "\n";
+        }
+
+    //Histogram as a second table after a blank line
+    s << "\nkind,log2flops,count,flops,bytes,tpermute,tgemm,ttotal\n";
+    for(auto kind : {ContractRecord::Contract,ContractRecord::Gemm,ContractRecord::Blocks})
+    for(auto b = 0; b < ContractTraceSummary::NBin; ++b)
+        {
+        auto& B = S.hist[kind][b];
+        if(B.count == 0) continue;
+        s << kindName(kind) << "," << b << "," << B.count
+          << "," << B.flops << "," << B.bytes
+          << "," << B.tpermute << "," << B.tgemm << "," << B.ttotal << "\n";
+        }
+    }
+
+ostream&
+operator<<(ostream & s, ContractTraceSummary const& S)
+    {
+    s << "Contraction trace summary:\n";
+    for(auto kind : {ContractRecord::Contract,ContractRecord::Gemm,ContractRecord::Blocks})
+        {
+        auto& T = S.total[kind];
+        if(T.count == 0) continue;
+        auto gflops = T.ttotal > 0 ? 1E-9*T.flops/T.ttotal : 0.;
+        s << format("  %-8s calls = %d, time = %.4f (permute %.4f, gemm %.4f), GFlop = %.4f (%.2f GFlop/s), GB = %.4f\n",
+                    kindName(kind),T.count,T.ttotal,T.tpermute,T.tgemm,
+                    1E-9*T.flops,gflops,1E-9*T.bytes);
+        }
+    if(S.dropped > 0) s << format("  (%d records dropped)\n",S.dropped);
+    return s;
+    }
+
+} //namespace itensor
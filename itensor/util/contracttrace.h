@@ -0,0 +1,190 @@
+//
+// Copyright 2018 The Simons Foundation, Inc. - All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef __ITENSOR_CONTRACTTRACE_H
+#define __ITENSOR_CONTRACTTRACE_H
+
+#include <atomic>
+#include <array>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <iostream>
+
+//
+// Runtime-toggleable tracing of tensor contractions.
+//
+// Unlike COLLECT_TSTATS (util/tensorstats.h) and COLLECT_TIMES
+// (util/timers.h) no recompilation is needed: tracing is turned
+// on either by calling ContractTrace::start() or by setting the
+// environment variable ITENSOR_CONTRACT_TRACE to a file name,
+// in which case the trace is written to that file at exit
+// (CSV if the name ends in ".csv", JSON otherwise).
+//
+// When tracing is off, the cost at each instrumented site
+// is a single relaxed atomic load.
+//
+// Usage:
+//
+//   ContractTrace::start();
+//   ... run sweeps ...
+//   ContractTrace::stop();
+//   ContractTrace::write("trace.json");
+//   println(ContractTrace::summary());
+//
+
+namespace itensor {
+
+struct ContractRecord
+    {
+    enum Kind { Contract = 0, Gemm = 1, Blocks = 2 };
+
+    Kind kind = Contract;
+    //Extents of A, B and C
+    //(for Gemm: A is m x k, B is k x n, C is m x n)
+    std::vector<long> Adims,
+                      Bdims,
+                      Cdims;
+    //Matrix shape of the underlying gemm
+    //(m = dleft, k = dmid, n = dright)
+    long m = 0,
+         k = 0,
+         n = 0;
+    bool Acplx = false,
+         Bcplx = false;
+    //Which of A, B, C had to be permuted
+    bool permA = false,
+         permB = false,
+         permC = false;
+    double flops = 0.;
+    //Bytes read and written, including permutation buffers
+    double bytes = 0.;
+    //Wall times in seconds
+    double tpermute = 0.,
+           tgemm = 0.,
+           ttotal = 0.;
+    //For Blocks: number of block-block contractions
+    //and number of non-zero blocks of the result
+    long nblocks = 0,
+         nCblocks = 0;
+    };
+
+char const*
+kindName(ContractRecord::Kind k);
+
+//One bucket of the log2(flops) histogram
+struct ContractHistBin
+    {
+    long count = 0;
+    double flops = 0.,
+           bytes = 0.,
+           tpermute = 0.,
+           tgemm = 0.,
+           ttotal = 0.;
+    };
+
+struct ContractTraceSummary
+    {
+    static constexpr int NBin = 64;
+    using Hist = std::array<ContractHistBin,NBin>;
+
+    //Histograms indexed by kind
+    std::array<Hist,3> hist;
+    //Totals indexed by kind
+    std::array<ContractHistBin,3> total;
+    //Number of records dropped because
+    //maxRecords was exceeded
+    long dropped = 0;
+    };
+
+std::ostream&
+operator<<(std::ostream & s, ContractTraceSummary const& S);
+
+class ContractTrace
+    {
+    public:
+    using clock_type = std::chrono::steady_clock;
+    using time_point = clock_type::time_point;
+
+    static bool
+    enabled() { return enabledFlag().load(std::memory_order_relaxed); }
+
+    //Begin recording (does not clear earlier records)
+    static void
+    start();
+
+    //Stop recording, keeping what has been recorded
+    static void
+    stop();
+
+    //Discard all records and histograms
+    static void
+    reset();
+
+    //Maximum number of per-call records kept;
+    //histograms keep accumulating beyond this
+    static void
+    setMaxRecords(size_t n);
+
+    static void
+    record(ContractRecord const& r);
+
+    static std::vector<ContractRecord>
+    records();
+
+    static ContractTraceSummary
+    summary();
+
+    //Format chosen from the file extension:
+    //".csv" for CSV, anything else for JSON
+    static void
+    write(std::string const& fname);
+
+    static void
+    writeJSON(std::ostream & s);
+
+    static void
+    writeCSV(std::ostream & s);
+
+    static time_point
+    now() { return clock_type::now(); }
+
+    static double
+    seconds(time_point t0, time_point t1)
+        {
+        return std::chrono::duration<double>(t1-t0).count();
+        }
+
+    private:
+
+    static std::atomic<bool>&
+    enabledFlag();
+    };
+
+//Floating-point operations of a gemm of shape
+//(m x k) * (k x n), counting a complex multiply-add
+//as 8 operations and a real*complex one as 4
+double inline
+gemmFlops(long m, long k, long n, bool Acplx, bool Bcplx)
+    {
+    auto f = 2.*m*k*n;
+    if(Acplx && Bcplx) return 4.*f;
+    if(Acplx || Bcplx) return 2.*f;
+    return f;
+    }
+
+} //namespace itensor
+
+#endif
@@ -0,0 +1,242 @@
+//
+// Copyright 2018 The Simons Foundation, Inc. - All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <vector>
+#include "itensor/util/scratch.h"
+#include "itensor/util/print.h"
+
+namespace itensor {
+
+namespace {
+
+int const LogMinBytes = 12;
+size_t const MinBytes = 1ul << LogMinBytes;
+size_t const Alignment = 64;
+
+struct Arena
+    {
+    std::mutex mutex;
+    //Free blocks indexed by size class
+    std::vector<std::vector<void*>> free;
+    size_t cached = 0;
+    };
+
+struct Registry
+    {
+    std::mutex mutex;
+    std::vector<Arena*> arenas;
+    std::atomic<size_t> inuse{0},
+                        peak{0},
+                        cached{0},
+                        nalloc{0},
+                        nreuse{0};
+    size_t maxCached = 1ul << 31;
+    };
+
+//Never destroyed, so that arenas of threads
+//exiting after main returns can still unregister
+Registry&
+registry()
+    {
+    static auto* R = new Registry;
+    return *R;
+    }
+
+//Frees the cached blocks of A;
+//caller must hold A.mutex
+void
+freeCached(Arena & A)
+    {
+    for(auto& blocks : A.free)
+        {
+        for(auto* p : blocks) std::free(p);
+        blocks.clear();
+        }
+    registry().cached -= A.cached;
+    A.cached = 0;
+    }
+
+struct ArenaHolder
+    {
+    Arena* arena = nullptr;
+
+    ArenaHolder()
+      : arena(new Arena)
+        {
+        auto& R = registry();
+        std::lock_guard<std::mutex> lock(R.mutex);
+        R.arenas.push_back(arena);
+        }
+
+    ~ArenaHolder()
+        {
+        auto& R = registry();
+            {
+            std::lock_guard<std::mutex> lock(R.mutex);
+            R.arenas.erase(std::find(R.arenas.begin(),R.arenas.end(),arena));
+            }
+            {
+            std::lock_guard<std::mutex> lock(arena->mutex);
+            freeCached(*arena);
+            }
+        delete arena;
+        }
+    };
+
+Arena&
+localArena()
+    {
+    thread_local ArenaHolder holder;
+    return *holder.arena;
+    }
+
+//Rounds bytes up to the next of the sizes 2^k*{1,5/4,3/2,7/4}
+//(and at least MinBytes), returning the index of that size
+int
+sizeClass(size_t bytes, size_t & capacity)
+    {
+    if(bytes <= MinBytes)
+        {
+        capacity = MinBytes;
+        return 0;
+        }
+    int k = 8*sizeof(size_t)-1-__builtin_clzl(bytes-1);
+    auto base = 1ul << k;
+    auto step = base/4;
+    auto m = (bytes-base+step-1)/step;
+    capacity = base+m*step;
+    return 4*(k-LogMinBytes)+int(m);
+    }
+
+void
+updatePeak(size_t inuse)
+    {
+    auto& peak = registry().peak;
+    auto p = peak.load();
+    while(inuse > p && !peak.compare_exchange_weak(p,inuse)) { }
+    }
+
+} //namespace
+
+namespace detail {
+
+void*
+scratchAcquire(size_t bytes, size_t & capacity)
+    {
+    auto& R = registry();
+    auto& A = localArena();
+    auto cls = sizeClass(bytes,capacity);
+    void* p = nullptr;
+        {
+        std::lock_guard<std::mutex> lock(A.mutex);
+        if(size_t(cls) < A.free.size() && !A.free[cls].empty())
+            {
+            p = A.free[cls].back();
+            A.free[cls].pop_back();
+            A.cached -= capacity;
+            R.cached -= capacity;
+            }
+        }
+    if(p)
+        {
+        R.nreuse += 1;
+        }
+    else
+        {
+        p = std::aligned_alloc(Alignment,capacity);
+        if(!p) throw std::bad_alloc();
+        R.nalloc += 1;
+        }
+    updatePeak(R.inuse += capacity);
+    return p;
+    }
+
+void
+scratchReturn(void* p, size_t capacity)
+    {
+    auto& R = registry();
+    auto& A = localArena();
+    R.inuse -= capacity;
+    size_t dummy = 0;
+    auto cls = sizeClass(capacity,dummy);
+        {
+        std::lock_guard<std::mutex> lock(A.mutex);
+        if(A.cached+capacity <= R.maxCached)
+            {
+            if(A.free.size() <= size_t(cls)) A.free.resize(cls+1);
+            A.free[cls].push_back(p);
+            A.cached += capacity;
+            R.cached += capacity;
+            return;
+            }
+        }
+    std::free(p);
+    }
+
+} //namespace detail
+
+ScratchStats
+scratchStats()
+    {
+    auto& R = registry();
+    auto S = ScratchStats{};
+    S.inuse = R.inuse;
+    S.peak = R.peak;
+    S.cached = R.cached;
+    S.nalloc = R.nalloc;
+    S.nreuse = R.nreuse;
+    return S;
+    }
+
+void
+scratchResetPeak()
+    {
+    auto& R = registry();
+    R.peak = R.inuse.load();
+    }
+
+void
+scratchRelease()
+    {
+    auto& R = registry();
+    std::lock_guard<std::mutex> lock(R.mutex);
+    for(auto* A : R.arenas)
+        {
+        std::lock_guard<std::mutex> alock(A->mutex);
+        freeCached(*A);
+        }
+    }
+
+size_t&
+scratchMaxCached()
+    {
+    return registry().maxCached;
+    }
+
+std::ostream&
+operator<<(std::ostream & s, ScratchStats const& S)
+    {
+    auto MB = [](size_t b) { return b/(1024.*1024.); };
+    s << format("Scratch: in use %.2f MB, peak %.2f MB, cached %.2f MB, %d allocations, %d reuses",
+                MB(S.inuse),MB(S.peak),MB(S.cached),S.nalloc,S.nreuse);
+    return s;
+    }
+
+} //namespace itensor
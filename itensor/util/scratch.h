@@ -0,0 +1,158 @@
+//
+// Copyright 2018 The Simons Foundation, Inc. - All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef __ITENSOR_SCRATCH_H
+#define __ITENSOR_SCRATCH_H
+
+#include <cstddef>
+#include <iostream>
+#include <utility>
+
+//
+// Thread-local, size-classed arena for short-lived scratch
+// buffers, such as the permutation buffers of contract() and
+// the real/imaginary buffers of the complex gemm emulator.
+//
+// Buffers are taken with scratchBuffer<T>(n) and handed back to
+// the calling thread's arena when the returned object goes out
+// of scope. Released blocks are kept in free lists keyed by size
+// class (four classes per power of two, so at most 25% of a
+// block is unused) and reused by later requests, avoiding the
+// malloc and page-fault cost of allocating large buffers anew.
+//
+// Cached blocks are returned to the operating system by
+// scratchRelease() (for example between DMRG sweeps), or as
+// soon as the cache of a thread grows past scratchMaxCached().
+//
+
+namespace itensor {
+
+namespace detail {
+
+void*
+scratchAcquire(size_t bytes, size_t & capacity);
+
+void
+scratchReturn(void* p, size_t capacity);
+
+} //namespace detail
+
+template<typename T>
+class ScratchBuffer
+    {
+    T* p_ = nullptr;
+    size_t size_ = 0,
+           capacity_ = 0;
+    public:
+
+    ScratchBuffer() { }
+
+    explicit
+    ScratchBuffer(size_t size)
+      : size_(size)
+        {
+        if(size_ > 0)
+            {
+            p_ = static_cast<T*>(detail::scratchAcquire(size_*sizeof(T),capacity_));
+            }
+        }
+
+    ScratchBuffer(ScratchBuffer const&) = delete;
+
+    ScratchBuffer&
+    operator=(ScratchBuffer const&) = delete;
+
+    ScratchBuffer(ScratchBuffer && o)
+      : p_(o.p_),
+        size_(o.size_),
+        capacity_(o.capacity_)
+        {
+        o.p_ = nullptr;
+        o.size_ = 0;
+        o.capacity_ = 0;
+        }
+
+    ScratchBuffer&
+    operator=(ScratchBuffer && o)
+        {
+        std::swap(p_,o.p_);
+        std::swap(size_,o.size_);
+        std::swap(capacity_,o.capacity_);
+        return *this;
+        }
+
+    ~ScratchBuffer()
+        {
+        if(p_) detail::scratchReturn(p_,capacity_);
+        }
+
+    T*
+    data() { return p_; }
+
+    T const*
+    data() const { return p_; }
+
+    size_t
+    size() const { return size_; }
+
+    T&
+    operator[](size_t n) { return p_[n]; }
+
+    T const&
+    operator[](size_t n) const { return p_[n]; }
+    };
+
+//Uninitialized buffer of n elements of type T
+template<typename T>
+ScratchBuffer<T>
+scratchBuffer(size_t n) { return ScratchBuffer<T>(n); }
+
+struct ScratchStats
+    {
+    //Bytes currently handed out to ScratchBuffers
+    size_t inuse = 0;
+    //Largest value of inuse since the last scratchResetPeak()
+    size_t peak = 0;
+    //Bytes held in free lists, ready for reuse
+    size_t cached = 0;
+    //Number of requests served by a new allocation
+    //and by reusing a cached block
+    size_t nalloc = 0,
+           nreuse = 0;
+    };
+
+//Totals over all threads
+ScratchStats
+scratchStats();
+
+void
+scratchResetPeak();
+
+//Free all cached (currently unused) blocks
+//of all threads, returning them to the OS
+void
+scratchRelease();
+
+//Largest number of bytes a thread keeps cached
+//before freeing blocks instead of caching them
+size_t&
+scratchMaxCached();
+
+std::ostream&
+operator<<(std::ostream & s, ScratchStats const& S);
+
+} //namespace itensor
+
+#endif
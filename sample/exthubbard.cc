@@ -92,27 +92,23 @@ int main(int argc, char* argv[])
     //
     // Measure spin densities
     //
-    Vector upd(N),dnd(N);
-    for(int j = 1; j <= N; ++j)
-        {
-        psi.position(j);
-        upd(j-1) = elt(dag(prime(psi(j),"Site"))*op(sites,"Nup",j)*psi(j));
-        dnd(j-1) = elt(dag(prime(psi(j),"Site"))*op(sites,"Ndn",j)*psi(j));
-        }
+    auto dens = expect(psi,sites,{"Nup","Ndn"});
+    auto& upd = dens[0];
+    auto& dnd = dens[1];
 
     println("Up Density:");
     for(int j = 0; j < N; ++j)
-        printfln("%d %.10f",1+j,upd(j));
+        printfln("%d %.10f",1+j,upd[j]);
     println();
 
     println("Dn Density:");
     for(int j = 0; j < N; ++j)
-        printfln("%d %.10f",1+j,dnd(j));
+        printfln("%d %.10f",1+j,dnd[j]);
     println();
 
     println("Total Density:");
     for(int j = 0; j < N; ++j)
-        printfln("%d %.10f",1+j,(upd(j)+dnd(j)));
+        printfln("%d %.10f",1+j,(upd[j]+dnd[j]));
     println();
 
     //
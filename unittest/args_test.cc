@@ -160,5 +160,81 @@ SECTION("Read/Write")
     CHECK(o2.getString("Name") == "name");
     }
 
+SECTION("ArgKey")
+    {
+    static ArgKey const Cutoff("Cutoff");
+    static ArgKey const MaxDim("MaxDim");
+    static ArgKey const Name("Name");
+    static ArgKey const Missing("Missing");
+
+    auto args = Args("Name","name","MaxDim=",100,"Cutoff",1E-8);
+    CHECK(args.defined(MaxDim));
+    CHECK(args.getInt(MaxDim) == 100);
+    CHECK(args.getReal(Cutoff) == 1E-8);
+    CHECK(args.getString(Name) == "name");
+    CHECK(!args.defined(Missing));
+    CHECK(args.getInt(Missing,7) == 7);
+    CHECK_THROWS_AS(args.getInt(Missing),ITError);
+    CHECK_THROWS_AS(args.getString(MaxDim),ITError);
+
+    //Overwriting through a key keeps one entry per name
+    args.add(MaxDim,200);
+    args.add(Cutoff,true);
+    args.add(Missing,"here");
+    CHECK(args.getInt("MaxDim") == 200);
+    CHECK(args.getBool(Cutoff) == true);
+    CHECK(args.getString("Missing") == "here");
+    args.remove("MaxDim");
+    CHECK(!args.defined(MaxDim));
+    CHECK(args.getInt(MaxDim,3) == 3);
+
+    //A key remembers its slot across Args with
+    //different layouts, and is checked against the name
+    auto a1 = Args("A",1,"MaxDim",10);
+    auto a2 = Args("MaxDim",20,"B",2,"C",3);
+    for(auto n = 0; n < 3; ++n)
+        {
+        CHECK(a1.getInt(MaxDim) == 10);
+        CHECK(a2.getInt(MaxDim) == 20);
+        CHECK(a1.getInt(MaxDim,n) == 10);
+        }
+
+    //Values not given are looked up in the global Args
+    Args::global().add("GlobalOnly",5);
+    static ArgKey const GlobalOnly("GlobalOnly");
+    CHECK(a1.getInt(GlobalOnly) == 5);
+    Args::global().remove("GlobalOnly");
+    CHECK(!a1.defined(GlobalOnly));
+
+    //Names read from a stream are hashed again
+    std::stringstream data;
+    a2.write(data);
+    Args a3;
+    a3.read(data);
+    CHECK(a3.getInt(MaxDim) == 20);
+    }
+
+SECTION("Profiling")
+    {
+    static ArgKey const Sz("Sz");
+    auto args = Args("Sz",1,"Nf",2);
+    argsResetStats();
+    argsProfile(true);
+    for(auto n = 0; n < 10; ++n)
+        {
+        CHECK(args.getInt("Nf") == 2);
+        CHECK(args.getInt(Sz,n) == 1);
+        }
+    argsProfile(false);
+    args.getInt("Nf");
+    auto S = argsStats();
+    CHECK(S.lookups == 10);
+    CHECK(S.keyed == 10);
+    CHECK(S.slotHits >= 9);
+    CHECK(S.seconds > 0.);
+    argsResetStats();
+    CHECK(argsStats().lookups == 0);
+    }
+
 }
 
@@ -284,6 +284,40 @@ SECTION("No QN MPO")
         }
     }
 
+SECTION("Write To Disk")
+    {
+    auto N = 10;
+    auto sites = SpinHalf(N,{"ConserveQNs=",true});
+    auto ampo = AutoMPO(sites);
+    for(auto j : range1(N-1))
+    for(auto k : range1(j+1,std::min(j+2,N)))
+        {
+        ampo += 0.5/(k-j),"S+",j,"S-",k;
+        ampo += 0.5/(k-j),"S-",j,"S+",k;
+        ampo +=     1./(k-j),"Sz",j,"Sz",k;
+        }
+    auto neel1 = InitState(sites),
+         neel2 = InitState(sites);
+    for(auto j : range1(N))
+        {
+        neel1.set(j,j%2==1 ? "Up" : "Dn");
+        neel2.set(j,j%2==1 ? "Dn" : "Up");
+        }
+    auto psi = sum(randomMPS(neel1),randomMPS(neel2));
+
+    for(auto exact : {false,true})
+        {
+        auto H = toMPO(ampo,{"Exact=",exact});
+        auto Hd = toMPO(ampo,{"Exact=",exact,"WriteToDisk=",true});
+        CHECK(Hd.doWrite());
+        CHECK_CLOSE(inner(psi,Hd,psi),inner(psi,H,psi));
+        //Reading a site tensor leaves the loaded ones in place
+        auto W1 = Hd.loadSite(1);
+        CHECK(norm(W1) > 0.);
+        CHECK_CLOSE(inner(psi,Hd,psi),inner(psi,H,psi));
+        }
+    }
+
 SECTION("Single Site Ops")
     {
     int L = 10;
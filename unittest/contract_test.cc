@@ -4,6 +4,7 @@
 #include "itensor/tensor/contract.h"
 #include "itensor/util/set_scoped.h"
 #include "itensor/util/args.h"
+#include "itensor/util/contracttrace.h"
 #include "itensor/global.h"
 
 using namespace itensor;
@@ -792,4 +793,194 @@ TEST_CASE("Contract Test")
 #endif
     
         } // Contract Loop
+
+    SECTION("Small Tensors")
+        {
+        SECTION("Permuted Indices")
+            {
+            //Same as contractloop Case 8, but small
+            //enough for the unrolled loops
+            Tensor A(3,2,2,2),
+                   B(2,4,2,3),
+                   C(3,4,2,3);
+            randomize(A);
+            randomize(B);
+            contract(A,{2,1,4,5},B,{1,3,4,6},C,{2,3,5,6});
+            for(auto i2 : range(3))
+            for(auto i3 : range(4))
+            for(auto i5 : range(2))
+            for(auto i6 : range(3))
+                {
+                Real val = 0;
+                for(auto i1 : range(2))
+                for(auto i4 : range(2))
+                    {
+                    val += A(i2,i1,i4,i5)*B(i1,i3,i4,i6);
+                    }
+                CHECK_CLOSE(C(i2,i3,i5,i6),val);
+                }
+            }
+
+        SECTION("Outer Product")
+            {
+            Tensor A(2,3),
+                   B(4),
+                   C(3,4,2);
+            randomize(A);
+            randomize(B);
+            contract(A,{1,2},B,{3},C,{2,3,1});
+            for(auto i1 : range(2))
+            for(auto i2 : range(3))
+            for(auto i3 : range(4))
+                {
+                CHECK_CLOSE(C(i2,i3,i1),A(i1,i2)*B(i3));
+                }
+            }
+
+        SECTION("Alpha and Beta")
+            {
+            Tensor A(4,4),
+                   B(4,4),
+                   C(4,4);
+            randomize(A);
+            randomize(B);
+            randomize(C);
+            auto C0 = C;
+            contract(A,{1,2},B,{3,2},C,{3,1},0.5,2.);
+            for(auto i1 : range(4))
+            for(auto i3 : range(4))
+                {
+                Real val = 0;
+                for(auto i2 : range(4)) val += A(i1,i2)*B(i3,i2);
+                CHECK_CLOSE(C(i3,i1),0.5*val+2.*C0(i3,i1));
+                }
+            }
+        }
+
+    SECTION("Contract Diag Partial")
+        {
+        int n = 7,
+            m1 = 4,
+            m2 = 5;
+        auto d = Vector(n);
+        for(auto& el : d) el = Global::random();
+        auto dref = makeRef(d);
+
+        SECTION("Scale Last Index")
+            {
+            Tensor B(m1,m2,n),
+                   C(m1,m2,n);
+            randomize(B);
+            contractDiagPartial(dref,{-1,3},makeRef(B),{1,2,-1},makeRef(C),{1,2,3});
+            for(auto i : range(m1))
+            for(auto j : range(m2))
+            for(auto k : range(n))
+                {
+                CHECK_CLOSE(C(i,j,k),d(k)*B(i,j,k));
+                }
+            }
+
+        SECTION("Scale First Index")
+            {
+            Tensor B(n,m1,m2),
+                   C(n,m1,m2);
+            randomize(B);
+            contractDiagPartial(dref,{-1,3},makeRef(B),{-1,1,2},makeRef(C),{3,1,2});
+            for(auto i : range(m1))
+            for(auto j : range(m2))
+            for(auto k : range(n))
+                {
+                CHECK_CLOSE(C(k,i,j),d(k)*B(k,i,j));
+                }
+            }
+
+        SECTION("Scale Middle Index, Permuted Output")
+            {
+            Tensor B(m1,n,m2),
+                   C1(m1,n,m2),
+                   C2(n,m2,m1);
+            randomize(B);
+            contractDiagPartial(dref,{-1,3},makeRef(B),{1,-1,2},makeRef(C1),{1,3,2});
+            contractDiagPartial(dref,{-1,3},makeRef(B),{1,-1,2},makeRef(C2),{3,2,1});
+            for(auto i : range(m1))
+            for(auto j : range(m2))
+            for(auto k : range(n))
+                {
+                CHECK_CLOSE(C1(i,k,j),d(k)*B(i,k,j));
+                CHECK_CLOSE(C2(k,j,i),d(k)*B(i,k,j));
+                }
+            }
+
+        SECTION("Partial Trace")
+            {
+            Tensor B(n,m1,n),
+                   C(m1);
+            randomize(B);
+            contractDiagPartial(dref,{-1,-2},makeRef(B),{-1,1,-2},makeRef(C),{1});
+            for(auto i : range(m1))
+                {
+                Real val = 0;
+                for(auto k : range(n)) val += d(k)*B(k,i,k);
+                CHECK_CLOSE(C(i),val);
+                }
+            }
+
+        SECTION("Diagonal Starting Off Corner")
+            {
+            //As for a block of QDiag storage
+            Tensor B(m1,n+1),
+                   C(m1,n+2);
+            randomize(B);
+            contractDiagPartial(dref,{-1,2},makeRef(B),{1,-1},makeRef(C),{1,2},IntArray{1,2});
+            for(auto i : range(m1))
+                {
+                CHECK(C(i,0) == 0.);
+                CHECK(C(i,1) == 0.);
+                for(auto k : range(n)) CHECK_CLOSE(C(i,k+2),d(k)*B(i,k+1));
+                }
+            }
+        }
+
+    SECTION("Contraction Trace")
+        {
+        //Large enough to go through gemm
+        //rather than the small-tensor loops
+        Tensor A(3,4,50),
+               B(50,2,4),
+               C(3,2);
+        randomize(A);
+        randomize(B);
+
+        ContractTrace::reset();
+        contract(A,{1,2,3},B,{3,4,2},C,{1,4});
+        CHECK(ContractTrace::records().empty());
+
+        ContractTrace::start();
+        contract(A,{1,2,3},B,{3,4,2},C,{1,4});
+        ContractTrace::stop();
+
+        auto recs = ContractTrace::records();
+        auto nc = 0, ng = 0;
+        for(auto& r : recs)
+            {
+            if(r.kind == ContractRecord::Contract)
+                {
+                ++nc;
+                CHECK(r.m*r.k*r.n == 3*4*50*2);
+                CHECK(r.Adims == std::vector<long>{3,4,50});
+                CHECK(r.Cdims == std::vector<long>{3,2});
+                CHECK(r.flops == 2.*3*4*50*2);
+                }
+            if(r.kind == ContractRecord::Gemm) ++ng;
+            }
+        CHECK(nc == 1);
+        CHECK(ng == 1);
+        auto S = ContractTrace::summary();
+        CHECK(S.total[ContractRecord::Contract].count == 1);
+
+        auto json = std::ostringstream{};
+        ContractTrace::writeJSON(json);
+        CHECK(json.str().find("\"kind\":\"contract\"") != std::string::npos);
+        ContractTrace::reset();
+        }
     }
@@ -536,6 +536,96 @@ SECTION("QN ITensor SVD")
        }
    }
 
+SECTION("Rank-revealing QR")
+    {
+    auto checkOrthonormal = [](ITensor const& Q, Index const& l)
+        {
+        auto QQ = dag(Q)*prime(Q,l);
+        for(auto r : range1(dim(l)))
+        for(auto c : range1(dim(l)))
+            {
+            CHECK_CLOSE(eltC(QQ,r,c),r==c ? 1.0 : 0.0);
+            }
+        };
+
+    SECTION("Dense")
+        {
+        auto i = Index(4,"i"),
+             j = Index(3,"j"),
+             k = Index(5,"k");
+        auto T = randomITensorC(i,j,k);
+
+        ITensor Q(i,j),R;
+        auto spec = rrqr(T,Q,R);
+        CHECK(norm(T-Q*R) < 1E-12);
+        auto l = commonIndex(Q,R);
+        CHECK(hasTags(l,"Link,QR"));
+        CHECK_EQUAL(dim(l),5);
+        CHECK_CLOSE(spec.truncerr(),0.);
+        checkOrthonormal(Q,l);
+
+        //Wide case: new index has the smaller dimension
+        ITensor Q2(i),R2;
+        rrqr(T,Q2,R2,{"Tags=","Link,X"});
+        CHECK(norm(T-Q2*R2) < 1E-12);
+        CHECK_EQUAL(dim(commonIndex(Q2,R2)),4);
+        CHECK(hasTags(commonIndex(Q2,R2),"Link,X"));
+        }
+
+    SECTION("Truncation")
+        {
+        //Rank 3 matrix plus a small perturbation
+        auto i = Index(10,"i"),
+             j = Index(8,"j");
+        auto T = ITensor(i,j);
+        for([[maybe_unused]] auto n : range1(3))
+            {
+            auto a = randomITensor(i);
+            auto b = randomITensor(j);
+            T += a*b;
+            }
+        auto E = randomITensor(i,j);
+        T += 1E-6*E;
+
+        ITensor Q(i),R;
+        auto spec = rrqr(T,Q,R,{"Cutoff=",1E-8});
+        CHECK_EQUAL(dim(commonIndex(Q,R)),3);
+        auto err = sqr(norm(T-Q*R)/norm(T));
+        CHECK(err < 1E-8);
+        CHECK_CLOSE(spec.truncerr(),err);
+
+        ITensor Q2(i),R2;
+        auto spec2 = rrqr(T,Q2,R2,{"MaxDim=",2});
+        CHECK_EQUAL(dim(commonIndex(Q2,R2)),2);
+        CHECK_CLOSE(spec2.truncerr(),sqr(norm(T-Q2*R2)/norm(T)));
+        }
+
+    SECTION("QNs")
+        {
+        auto u = Index(QN(+2),3,
+                       QN( 0),2,
+                       QN(-1),2);
+        auto v = Index(QN(+2),2,
+                       QN( 0),4,
+                       QN(-1),1);
+        auto T = randomITensor(QN(1),u,v);
+
+        ITensor Q(u),R;
+        rrqr(T,Q,R);
+        CHECK(norm(T-Q*R) < 1E-12);
+        CHECK(hasQNs(Q));
+        CHECK(div(Q) == QN());
+        CHECK(div(R) == QN(1));
+        checkOrthonormal(Q,commonIndex(Q,R));
+
+        ITensor Q2(u),R2;
+        auto spec = rrqr(T,Q2,R2,{"MaxDim=",2});
+        CHECK_EQUAL(dim(commonIndex(Q2,R2)),2);
+        CHECK_CLOSE(spec.truncerr(),sqr(norm(T-Q2*R2)/norm(T)));
+        checkOrthonormal(Q2,commonIndex(Q2,R2));
+        }
+    }
+
 SECTION("Polar")
   {
   auto i = Index(2,"i");
@@ -1,6 +1,9 @@
 #include "test.h"
 #include "itensor/index.h"
 #include "itensor/util/print_macro.h"
+#include <future>
+#include <sstream>
+#include <unordered_set>
 
 using namespace itensor;
 using namespace std;
@@ -152,4 +155,87 @@ TEST_CASE("IndexTest")
 
       }
 
+    SECTION("Hash")
+      {
+      auto i = Index(3,"i,x");
+      auto j = Index(3,"i,x");
+      CHECK(i.hash() != j.hash());
+      CHECK(i.hash() != prime(i).hash());
+      CHECK(i.hash() != addTags(i,"y").hash());
+
+      //Hashes updated in place agree with freshly computed ones
+      auto fresh = [](Index const& I)
+          {
+          return Index(id(I),dim(I),dir(I),tags(I));
+          };
+      auto ip = prime(i,3);
+      CHECK(ip.hash() == fresh(ip).hash());
+      ip.setPrime(1);
+      CHECK(ip.hash() == fresh(ip).hash());
+      CHECK(ip.hash() == prime(i).hash());
+      CHECK(noPrime(ip).hash() == i.hash());
+      auto ir = replaceTags(addTags(i,"y"),"y,x","z");
+      CHECK(ir.hash() == fresh(ir).hash());
+      CHECK(ir == fresh(ir));
+      auto is = sim(i);
+      CHECK(is.hash() == fresh(is).hash());
+      }
+
+    SECTION("Unique IDs from many threads")
+      {
+      auto nthread = 8;
+      auto nid = 20000;
+      auto futs = std::vector<std::future<std::vector<Index::id_type>>>();
+      for(auto t = 0; t < nthread; ++t)
+          {
+          futs.push_back(std::async(std::launch::async,[nid]()
+              {
+              auto ids = std::vector<Index::id_type>();
+              for(auto n : range(nid)) ids.push_back(id(Index(n%3+1)));
+              return ids;
+              }));
+          }
+      auto all = std::unordered_set<Index::id_type>();
+      for(auto& f : futs)
+          for(auto id : f.get()) all.insert(id);
+      CHECK(all.size() == size_t(nthread*nid));
+      CHECK(all.count(0) == 0);
+      }
+
+    SECTION("Interned Tags")
+      {
+      CHECK(internTag(Tag()) == 0);
+      CHECK(internTag(Tag("Link")) == internTag(Tag("Link")));
+      CHECK(internTag(Tag("Link")) != internTag(Tag("Site")));
+
+      //IDs agree between threads
+      auto fut = std::async(std::launch::async,[]() { return internTag(Tag("xyz1")); });
+      CHECK(fut.get() == internTag(Tag("xyz1")));
+
+      auto ts = TagSet("b,a,c");
+      CHECK(ts.ids() == TagSet("c,b,a").ids());
+      CHECK(ts.ids()[0] == internTag(Tag("a")));
+      CHECK(ts.ids()[3] == 0);
+      CHECK(ts == TagSet("a,b,c"));
+      CHECK(ts != TagSet("a,b"));
+      CHECK(ts != TagSet("a,b,c,1"));
+
+      //Removing and replacing tags keeps the IDs in step
+      ts.removeTags("b");
+      CHECK(ts.ids() == TagSet("a,c").ids());
+      ts.replaceTags("a","d");
+      CHECK(ts.ids() == TagSet("c,d").ids());
+      ts.noTags();
+      CHECK(ts.ids() == TagSet().ids());
+
+      //Tags read back from a stream get the same IDs
+      auto ss = std::stringstream();
+      auto tw = TagSet("Link,l=3,2");
+      write(ss,tw);
+      auto tr = TagSet();
+      read(ss,tr);
+      CHECK(tr == tw);
+      CHECK(tr.ids() == tw.ids());
+      }
+
     }
@@ -413,4 +413,38 @@ SECTION("IndexSet Iterator")
     CHECK((c+4) == i.end());
     }
 
+SECTION("Index Matching")
+    {
+    auto i = std::vector<Index>();
+    for(auto n : range(70)) i.push_back(Index(2,format("Link,l=%d",n)));
+    auto is1 = IndexSet(std::vector<Index>(i.begin(),i.begin()+40));
+    auto is2 = IndexSet(std::vector<Index>(i.begin()+30,i.end()));
+
+    auto H = detail::IndexHashes(is2);
+    CHECK(H.find(i[30]) == 0);
+    CHECK(H.find(i[69]) == 39);
+    CHECK(H.find(i[0]) == -1);
+    CHECK(H.find(prime(i[30])) == -1);
+    CHECK(H.find(addTags(i[30],"x")) == -1);
+
+    CHECK(order(commonInds(is1,is2)) == 10);
+    CHECK(order(uniqueInds(is1,is2)) == 30);
+    CHECK(order(unionInds(is1,is2)) == 70);
+    CHECK(indexPositions(is2,is1) == std::vector<int>({0,1,2,3,4,5,6,7,8,9}));
+    CHECK(hasInds(is1,commonInds(is1,is2)));
+    CHECK(!hasInds(is1,is2));
+
+    Labels Lind,
+           Rind;
+    auto ncont = computeLabels(is1,order(is1),is2,order(is2),Lind,Rind);
+    CHECK(ncont == 10);
+    for(auto n : range(10))
+        {
+        CHECK(Lind[30+n] == -(1+n));
+        CHECK(Rind[n] == -(1+n));
+        }
+    CHECK(Lind[0] == 11);
+    CHECK(Rind[10] == 41);
+    }
+
 } //IndexSetTest
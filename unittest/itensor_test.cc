@@ -365,6 +365,61 @@ SECTION("QDense Real Storage")
 std::system(format("rm -f %s",fname).c_str());
 }
 
+SECTION("Combiner Reshape Shares Storage")
+    {
+    auto a = Index(2,"a"),
+         b = Index(3,"b"),
+         c = Index(4,"c"),
+         t = Index(1,"t");
+    auto T = randomITensor(a,b,c,t);
+    auto sameStore = [](ITensor const& A, ITensor const& B)
+        {
+        return &(*A.store()) == &(*B.store());
+        };
+
+    //Adjacent, in order
+    auto [Cbc,bc] = combiner(b,c);
+    auto R = T*Cbc;
+    CHECK(sameStore(R,T));
+    CHECK(order(R) == 3);
+    CHECK(hasIndex(R,bc));
+
+    //Uncombining a leading, middle or trailing index
+    auto [Cab,ab] = combiner(a,b);
+    auto [Cct,ct] = combiner(c,t);
+    for(auto& C : {Cab,Cbc,Cct})
+        {
+        auto Rc = C*T;
+        auto U = dag(C)*Rc;
+        CHECK(sameStore(U,T));
+        CHECK(norm(U-T) < 1E-12);
+        }
+
+    //Only indices of dimension 1 out of place
+    auto [Cta,ta] = combiner(t,a);
+    auto [Cc,cc] = combiner(c);
+    for(auto& C : {Cct,Cta,Cc})
+        {
+        auto Rc = T*C;
+        CHECK(sameStore(Rc,T));
+        }
+    auto [Cat,at] = combiner(a,t);
+    auto Rat = T*Cat;
+    CHECK(sameStore(Rat,T));
+    for(auto ia : range1(a))
+    for(auto ib : range1(b))
+    for(auto ic : range1(c))
+        {
+        CHECK(elt(Rat,at(ia),b(ib),c(ic)) == elt(T,a(ia),b(ib),c(ic),t(1)));
+        }
+
+    //Indices of larger dimension out of order are moved
+    auto [Cca,ca] = combiner(c,a);
+    auto Rca = T*Cca;
+    CHECK(!sameStore(Rca,T));
+    CHECK(norm(dag(Cca)*Rca-T) < 1E-12);
+    }
+
 SECTION("Set and Get Elements")
 {
 auto T = ITensor(s1,s2);
@@ -2192,6 +2247,32 @@ SECTION("Combiner")
                 }
             }
 
+         SECTION("Combine / Uncombine - Scattered Indices (QN)")
+            {
+            //Combined indices interleaved with uncombined
+            //ones and listed out of order
+            auto T = randomITensorC(QN(),L1,S1,S2,L2,S3);
+            auto [C,ci] = combiner(S3,L1,S2);
+            auto R = T*C;
+
+            CHECK(order(R) == 3);
+            CHECK(hasIndex(R,ci));
+            CHECK_CLOSE(norm(T),norm(R));
+            CHECK(div(T) == div(R));
+
+            //Inner products are preserved
+            auto T2 = randomITensorC(QN(),L1,S1,S2,L2,S3);
+            auto R2 = C*T2;
+            CHECK_CLOSE(eltC(dag(R2)*R),eltC(dag(T2)*T));
+
+            auto U = dag(C)*R;
+            CHECK(norm(U-T) < 1E-12);
+
+            auto Tr = realPart(T);
+            auto Ur = dag(C)*(Tr*C);
+            CHECK(norm(Ur-Tr) < 1E-12);
+            }
+
         //Uncombine back:
         //auto TT = C * R;
 
@@ -2731,6 +2812,58 @@ SECTION("removeQNs")
       CHECK(elt(Aqn,ivs)==elt(A,ivs));
   }
 
+SECTION("QDense times Dense")
+  {
+  auto i = Index(QN(-1),1,
+                 QN(0),2,
+                 QN(+1),3,"i");
+  auto j = Index(QN(-1),2,
+                 QN(0),1,
+                 QN(+1),2,"j");
+  auto k = Index(QN(-2),1,
+                 QN(0),2,
+                 QN(+2),3,"k");
+  auto di = removeQNs(i);
+  auto dj = removeQNs(j);
+  auto dk = removeQNs(k);
+  auto l = Index(4,"l");
+
+  auto Aqn = randomITensor(QN(0),i,j,dag(k));
+  auto A = removeQNs(Aqn);
+
+  auto check = [](ITensor const& C, ITensor const& Cref)
+    {
+    CHECK(not hasQNs(C));
+    CHECK((typeOf(C) == Type::DenseReal || typeOf(C) == Type::DenseCplx));
+    CHECK(hasInds(C,inds(Cref)));
+    CHECK(norm(C-Cref) < 1E-12*norm(Cref));
+    };
+
+  for(auto B : {randomITensor(dj,l),
+                randomITensor(l,dk,di),
+                randomITensor(dk,dj,l,di),
+                randomITensor(dj,dk),
+                randomITensor(dj,di,dk),
+                randomITensorC(l,dj)})
+    {
+    check(Aqn*B,A*B);
+    check(B*Aqn,B*A);
+    auto Bc = B*1_i;
+    check(Aqn*Bc,A*Bc);
+    check((Aqn*1_i)*B,(A*1_i)*B);
+    }
+
+  //QDiag times Dense
+  auto D = delta(dag(i),prime(i));
+  auto B = randomITensor(dj,di);
+  check(D*B,removeQNs(D)*B);
+  check(B*D,B*removeQNs(D));
+  auto [U,S,V] = svd(Aqn,{i,j});
+  auto s = commonIndex(S,V);
+  auto Bs = randomITensor(removeQNs(s),l);
+  check(S*Bs,removeQNs(S)*Bs);
+  }
+
 SECTION("Block deficient ITensor tests")
   {
   auto i = Index(QN(0),2,QN(1),3,QN(2),4,QN(1),5,QN(3),6,"i");
@@ -2884,6 +3017,162 @@ SECTION("Test setting elements of QN ITensor")
   CHECK(elt(A,l=1,s=1) == 0.0);
   }
 
+SECTION("QDense Block Index")
+  {
+  auto sectors = [](int n)
+    {
+    auto qs = stdx::reserve_vector<QNInt>(n);
+    for(auto q : range(n)) qs.emplace_back(QN(q-n/2),1+q%2);
+    return Index(std::move(qs));
+    };
+  //Checks the BlockIndex lookups against a
+  //binary search over every possible block
+  auto checkIndex = [](QDenseReal const& d, IndexSet const& is)
+    {
+    auto r = order(is);
+    long nblocks = 1;
+    for(auto i : range(r)) nblocks *= is[i].nblock();
+    auto block = Block(r);
+    auto nfound = 0;
+    for(auto n : range(nblocks))
+      {
+      auto m = n;
+      for(auto i : range(r))
+        {
+        block[i] = m%is[i].nblock();
+        m /= is[i].nblock();
+        }
+      auto off = offsetOf(d,is,block);
+      CHECK(off == offsetOf(d.offsets,block));
+      CHECK(offsetOfLoc(d,is,block) == offsetOfLoc(d.offsets,block));
+      if(off >= 0) ++nfound;
+      }
+    CHECK(nfound == long(d.offsets.size()));
+    };
+
+  //Few possible blocks: dense lookup table
+  auto a = sectors(3),
+       b = sectors(3);
+  auto is2 = IndexSet(a,dag(b));
+  auto d2 = QDenseReal(is2,QN());
+  checkIndex(d2,is2);
+
+  //Many possible blocks: hashed lookup
+  auto c = sectors(7),
+       e = sectors(7),
+       f = sectors(7),
+       g = sectors(7);
+  auto is4 = IndexSet(c,e,dag(f),dag(g));
+  auto d4 = QDenseReal(is4,QN(1));
+  checkIndex(d4,is4);
+  CHECK(d4.blockIndex(is4) == d4.blockIndex(is4));
+
+  //The index follows changes to the offsets
+  auto nb = d2.offsets.size();
+  d2.insertBlock(is2,Block({0,1}),1.);
+  CHECK(d2.offsets.size() == nb+1);
+  checkIndex(d2,is2);
+  d4.updateOffsets(is4,QN(0));
+  checkIndex(d4,is4);
+
+  //Copies build their own index
+  auto d4c = d4;
+  CHECK(d4c.blockIndex(is4) != d4.blockIndex(is4));
+  checkIndex(d4c,is4);
+
+  //Index sets with other numbers of blocks
+  //fall back to searching the offsets
+  CHECK(d2.blockIndex(IndexSet(a,dag(sectors(4)))) == nullptr);
+
+  //Contraction and element access use the index
+  auto A = randomITensor(QN(),c,e,dag(f),dag(g));
+  auto B = randomITensor(QN(),f,g,dag(prime(c)));
+  auto AB = A*B;
+  auto ABd = removeQNs(A)*removeQNs(B);
+  CHECK(norm(removeQNs(AB)-ABd) < 1E-11);
+  }
+
+SECTION("QDiag Block Contraction")
+  {
+  auto a = Index(QN(0),2,QN(1),3,QN(-1),1,"a"),
+       s = Index(QN(1),1,QN(-1),1,"s"),
+       l = Index(QN(0),3,QN(1),2,QN(2),2,"l");
+  auto Dis = IndexSet(dag(a),prime(a));
+  auto D = ITensor(Dis,QDiagReal(Dis));
+  auto n = 0;
+  D.generate([&n]() { return 1.+(n++); });
+  auto T = randomITensor(QN(1),a,s,l);
+  auto Dd = removeQNs(D);
+  auto Td = removeQNs(T);
+
+  //Uncontracted indices of T give QDense storage
+  auto R = D*T;
+  CHECK(typeOf(R) == Type::QDenseReal);
+  CHECK(norm(removeQNs(R)-Dd*Td) < 1E-11);
+  R = T*D;
+  CHECK(norm(removeQNs(R)-Td*Dd) < 1E-11);
+
+  //Permuting D relabels its blocks
+  auto Dp = permute(D,prime(a),dag(a));
+  CHECK(norm(removeQNs(Dp*T)-Dd*Td) < 1E-11);
+
+  //Singular values from svd
+  auto [U,S,W] = svd(T,{a,s});
+  CHECK(norm(U*S*W-T) < 1E-11);
+
+  //Non-contracting product
+  auto A = randomITensor(QN(),a,dag(l));
+  auto B = randomITensor(QN(-1),dag(l),s);
+  auto AB = A/B;
+  CHECK(norm(removeQNs(AB)-removeQNs(A)/removeQNs(B)) < 1E-11);
+  }
+
+SECTION("Copy On Write")
+  {
+  auto i = Index(QN(0),2,QN(1),2,"i");
+  auto j = Index(QN(0),3,QN(1),3,"j");
+  auto Ad = randomITensor(Index(4),Index(5));
+  auto Aq = randomITensor(QN(),i,dag(j));
+  auto Cd = randomITensor(Ad.inds());
+  auto Cc = randomITensorC(Ad.inds());
+
+  resetStoreCloneStats();
+
+  //Scaling a shared tensor leaves the original unchanged
+  for(auto& A : {Ad,Aq,Cc})
+    {
+    auto nA = norm(A);
+    auto B = 2*A;
+    CHECK_CLOSE(norm(B),2*nA);
+    CHECK_CLOSE(norm(A),nA);
+    auto D = A;
+    D *= 1_i;
+    CHECK_CLOSE(norm(D),nA);
+    CHECK_CLOSE(norm(A),nA);
+    }
+
+  auto B = Ad;
+  B += Cd;
+  CHECK_CLOSE(norm(B-Ad-Cd),0.);
+  CHECK_CLOSE(norm(B-Cd-Ad),0.);
+
+  //None of the above copies shared storage before modifying it
+  CHECK(storeCloneStats().count == 0);
+
+  //Unique storage is modified in place
+  auto p = Ad.store().get();
+  Ad *= 3.;
+  CHECK(Ad.store().get() == p);
+
+  //Modifying an element of a shared tensor must copy it
+  auto E = Ad;
+  E.set(1,1,0.);
+  auto S = storeCloneStats();
+  CHECK(S.count == 1);
+  CHECK(S.bytes >= 4*5*sizeof(Real));
+  CHECK(elt(Ad,1,1) != 0.);
+  }
+
 } //TEST_CASE("ITensor")
 
 
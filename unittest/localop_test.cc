@@ -2,6 +2,8 @@
 #include "itensor/mps/localop.h"
 #include "itensor/mps/localmpo.h"
 #include "itensor/mps/localmposet.h"
+#include "itensor/mps/localsparsempo.h"
+#include "itensor/mps/dmrg.h"
 #include "itensor/mps/autompo.h"
 #include "itensor/mps/sites/spinhalf.h"
 #include "itensor/util/print_macro.h"
@@ -143,6 +145,52 @@ SECTION("LocalOp: check product")
   CHECK_CLOSE(norm(Hpsi2-noPrime(psi2*L0*Op1*Op2*R2)),0.);
   }
 
+SECTION("Fused Product")
+    {
+    auto s1 = Index(2,"Site");
+    auto s2 = Index(2,"Site");
+    auto h0 = Index(20,"Link");
+    auto h1 = Index(20,"Link");
+    auto h2 = Index(20,"Link");
+    auto l0 = Index(6,"Link");
+    auto l2 = Index(6,"Link");
+    auto Op1 = randomITensor(s1,prime(s1),h0,h1);
+    auto Op2 = randomITensor(s2,prime(s2),h1,h2);
+    auto L = randomITensor(l0,prime(l0),h0);
+    auto R = randomITensor(l2,prime(l2),h2);
+    auto phi = randomITensor(l0,s1,s2,l2);
+    auto exact = noPrime(phi*L*Op1*Op2*R);
+
+    //Small m and large k: fusing saves work
+    auto lop = LocalOp(Op1,Op2,L,R,{"FuseOps=",true});
+    CHECK(lop.fusion() == LocalOp::NotPlanned);
+    auto Hphi = ITensor();
+    lop.product(phi,Hphi);
+    CHECK(lop.fusion() != LocalOp::NoFusion);
+    CHECK(norm(Hphi-exact) < 1E-12*norm(exact));
+    //Fused tensors are reused by later products
+    lop.product(2*phi,Hphi);
+    CHECK(norm(Hphi-2*exact) < 1E-12*norm(exact));
+
+    //Updating clears the fused tensors
+    auto L2 = randomITensor(l0,prime(l0),h0);
+    lop.update(Op1,Op2,L2,R);
+    CHECK(lop.fusion() == LocalOp::NotPlanned);
+    lop.product(phi,Hphi);
+    CHECK(norm(Hphi-noPrime(phi*L2*Op1*Op2*R)) < 1E-12*norm(Hphi));
+
+    //Fused tensors too large to keep
+    auto lopm = LocalOp(Op1,Op2,L,R,{"FuseOps=",true,"FuseMaxSize=",0.});
+    lopm.product(phi,Hphi);
+    CHECK(lopm.fusion() == LocalOp::NoFusion);
+    CHECK(norm(Hphi-exact) < 1E-12*norm(exact));
+
+    //Not requested
+    auto lopn = LocalOp(Op1,Op2,L,R);
+    lopn.product(phi,Hphi);
+    CHECK(lopn.fusion() == LocalOp::NoFusion);
+    }
+
 SECTION("Diag")
     {
     SECTION("Bulk Case - ITensor")
@@ -275,6 +323,96 @@ SECTION("Test product")
 
   }
 
+SECTION("Fused Product With QNs")
+  {
+  int N = 10;
+  auto sites = SpinHalf(N,{"ConserveQNs=",true});
+  auto ampo = AutoMPO(sites);
+  for(auto i : range1(N))
+  for(auto j : range1(i+1,N))
+      {
+      auto J = 1./((j-i)*(j-i));
+      ampo += 0.5*J,"S+",i,"S-",j;
+      ampo += 0.5*J,"S-",i,"S+",j;
+      ampo +=     J,"Sz",i,"Sz",j;
+      }
+  auto H = toMPO(ampo,{"Exact=",true});
+  auto state = InitState(sites);
+  for(auto j : range1(N)) state.set(j,j%2==1 ? "Up" : "Dn");
+  auto psi = randomMPS(state,{"MaxDim=",2});
+
+  auto PH = LocalMPO(H),
+       PF = LocalMPO(H,{"FuseOps=",true});
+  for(auto b : {1,N/2,N-1})
+      {
+      psi.position(b);
+      PH.position(b,psi);
+      PF.position(b,psi);
+      auto phi = psi(b)*psi(b+1);
+      ITensor Hphi,Fphi;
+      PH.product(phi,Hphi);
+      PF.product(phi,Fphi);
+      CHECK(norm(Hphi-Fphi) < 1E-12*norm(Hphi));
+      }
+
+  //Replacing an edge tensor drops the fused
+  //tensors computed from the old one
+  auto b = N/2;
+  psi.position(b);
+  PH.position(b,psi);
+  PF.position(b,psi);
+  auto phi = psi(b)*psi(b+1);
+  ITensor Hphi,Fphi;
+  PF.product(phi,Fphi);
+  PH.L(2.*PH.L());
+  PF.L(2.*PF.L());
+  PH.R(b+1,3.*PH.R());
+  PF.R(b+1,3.*PF.R());
+  PH.product(phi,Hphi);
+  PF.product(phi,Fphi);
+  CHECK(norm(Hphi-Fphi) < 1E-12*norm(Hphi));
+  }
+
+SECTION("MPO On Disk")
+  {
+  int N = 10;
+  auto sites = SpinHalf(N,{"ConserveQNs=",true});
+  auto ampo = AutoMPO(sites);
+  for(auto j : range1(N-1))
+      {
+      ampo += 0.5,"S+",j,"S-",j+1;
+      ampo += 0.5,"S-",j,"S+",j+1;
+      ampo +=     "Sz",j,"Sz",j+1;
+      }
+  auto H = toMPO(ampo);
+  auto Hd = toMPO(ampo,{"WriteToDisk=",true});
+  auto state = InitState(sites);
+  for(auto j : range1(N)) state.set(j,j%2==1 ? "Up" : "Dn");
+  auto psi = randomMPS(state);
+
+  auto sweeps = Sweeps(3);
+  sweeps.maxdim() = 10,20;
+  sweeps.cutoff() = 1E-10;
+  auto psi1 = psi;
+  auto E = dmrg(psi,H,sweeps,{"Silent=",true});
+  auto Ed = dmrg(psi1,Hd,sweeps,{"Silent=",true,"MPOCacheSize=",2});
+  CHECK_CLOSE(E,Ed);
+
+  auto PH = LocalMPO(H),
+       PD = LocalMPO(Hd,{"MPOCacheSize=",2});
+  for(auto b : {1,N/2,N-1,2})
+      {
+      psi.position(b);
+      PH.position(b,psi);
+      PD.position(b,psi);
+      auto phi = psi(b)*psi(b+1);
+      ITensor Hphi,Dphi;
+      PH.product(phi,Hphi);
+      PD.product(phi,Dphi);
+      CHECK(norm(Hphi-Dphi) < 1E-12*norm(Hphi));
+      }
+  }
+
 SECTION("LocalMPOSet")
   {
   int N = 10;
@@ -354,4 +492,203 @@ SECTION("LocalMPOSet")
   }
 }
 
+TEST_CASE("LocalMPO_MPS")
+{
+auto N = 8;
+auto sites = SpinHalf(N,{"ConserveQNs=",true});
+auto ampo = AutoMPO(sites);
+for(auto j : range1(N-1))
+    {
+    ampo += 0.5,"S+",j,"S-",j+1;
+    ampo += 0.5,"S-",j,"S+",j+1;
+    ampo +=     "Sz",j,"Sz",j+1;
+    }
+auto H = toMPO(ampo);
+auto neel = InitState(sites);
+for(auto j : range1(N)) neel.set(j,j%2==1 ? "Up" : "Dn");
+
+SECTION("Product")
+    {
+    //The last state has a different total Sz than psi
+    auto psis = std::vector<MPS>({randomMPS(neel,{"MaxDim=",3}),
+                                  randomMPS(neel,{"MaxDim=",2}),
+                                  MPS(InitState(sites,"Up"))});
+    auto psi = randomMPS(neel,{"MaxDim=",4});
+    auto w = 3.;
+    auto PH = LocalMPO_MPS(H,psis,{"Weight=",w});
+    auto PT = LocalMPO_MPS(H,psis,{"Weight=",w,"NThread=",2});
+    auto lmpo = LocalMPO(H);
+    auto proj = 0.;
+    for(auto& p : psis) proj += w*std::norm(innerC(p,psi));
+    for(auto b : {1,N/2,N-1})
+        {
+        psi.position(b);
+        PH.position(b,psi);
+        PT.position(b,psi);
+        lmpo.position(b,psi);
+        auto phi = psi(b)*psi(b+1);
+        ITensor Pphi,Tphi,Hphi;
+        PH.product(phi,Pphi);
+        PT.product(phi,Tphi);
+        lmpo.product(phi,Hphi);
+        //<phi|sum_j w|psi_j><psi_j||phi> for phi the center of psi
+        CHECK_CLOSE(real(eltC(dag(phi)*(Pphi-Hphi))),proj);
+        CHECK(norm(Tphi-Pphi) < 1E-12*norm(Pphi));
+        }
+
+    //The threads only read tensors of psi gathered
+    //beforehand, so psi may be kept on disk
+    auto psid = psi;
+    psid.doWrite(true);
+    for(auto b : {N/2,1})
+        {
+        psi.position(b);
+        psid.position(b);
+        PH.position(b,psi);
+        PT.position(b,psid);
+        auto phi = psi(b)*psi(b+1);
+        auto phid = psid(b)*psid(b+1);
+        ITensor Pphi,Tphi;
+        PH.product(phi,Pphi);
+        PT.product(phid,Tphi);
+        CHECK_CLOSE(real(eltC(dag(phid)*Tphi)),real(eltC(dag(phi)*Pphi)));
+        }
+    psid.doWrite(false);
+    }
+
+SECTION("Excited State")
+    {
+    auto sweeps = Sweeps(5);
+    sweeps.maxdim() = 10,20,40;
+    sweeps.cutoff() = 1E-10;
+    auto psi0 = randomMPS(neel);
+    auto E0 = dmrg(psi0,H,sweeps,{"Silent=",true});
+    auto psi1 = randomMPS(neel);
+    auto psi1t = psi1;
+    auto E1 = dmrg(psi1,H,{psi0},sweeps,{"Silent=",true,"Weight=",20.});
+    auto E1t = dmrg(psi1t,H,{psi0},sweeps,{"Silent=",true,"Weight=",20.,"NThread=",2});
+    CHECK(E1 > E0+1E-4);
+    CHECK(std::abs(innerC(psi0,psi1)) < 1E-4);
+    CHECK_CLOSE(E1,E1t);
+    }
+}
+
+TEST_CASE("LocalSparseMPO")
+{
+auto N = 8;
 
+//Heisenberg chain with 1/r^2 Ising interactions
+auto makeH = [N](SpinHalf const& sites, bool exact)
+    {
+    auto ampo = AutoMPO(sites);
+    for(auto i : range1(N))
+    for(auto j : range1(i+1,N))
+        {
+        if(j == i+1)
+            {
+            ampo += 0.5,"S+",i,"S-",j;
+            ampo += 0.5,"S-",i,"S+",j;
+            }
+        ampo += 1./((j-i)*(j-i)),"Sz",i,"Sz",j;
+        }
+    ampo += 0.3,"Sz",1;
+    return toMPO(ampo,{"Exact=",exact});
+    };
+
+//Compressed MPO without QNs, and uncompressed
+//MPO (whose entries are mostly zero) with QNs
+for(auto conserve : {false,true})
+    {
+    auto sites = SpinHalf(N,{"ConserveQNs=",conserve});
+    auto H = makeH(sites,conserve);
+    auto SH = SparseMPO(H);
+    auto state = InitState(sites);
+    for(auto j : range1(N)) state.set(j,j%2==1 ? "Up" : "Dn");
+    auto psi = randomMPS(state,{"MaxDim=",4});
+
+    SECTION(format("Entries (QNs=%s)",conserve))
+        {
+        CHECK(length(SH) == N);
+        auto nid = 0;
+        for(auto j : range1(N))
+            {
+            CHECK(SH.linkDim(j) == (j < N ? dim(linkIndex(H,j)) : 1));
+            auto s = sites(j);
+            for(auto& t : SH.terms(j))
+                {
+                if(t.isId()) ++nid;
+                auto W = H(j);
+                if(j > 1) W *= setElt(dag(leftLinkIndex(H,j))=t.row);
+                if(j < N) W *= setElt(dag(rightLinkIndex(H,j))=t.col);
+                for(auto i : range1(dim(s)))
+                for(auto k : range1(dim(s)))
+                    {
+                    auto el = t.isId() ? Cplx(i == k) : eltC(SH.ops(j).at(t.op),s=i,prime(s)=k);
+                    CHECK(std::abs(eltC(W,s=i,prime(s)=k)-t.coef*el) < 1E-12);
+                    }
+                }
+            if(conserve) CHECK(SH.ops(j).size() <= 3);
+            }
+        CHECK(nid > 0);
+        auto k = SH.linkDim(N/2);
+        CHECK(SH.terms(N/2).size() < size_t(k*k));
+        }
+
+    SECTION(format("Product (QNs=%s)",conserve))
+        {
+        for(auto nc : {1,2})
+            {
+            auto PH = LocalMPO(H,{"NumCenter=",nc});
+            auto PS = LocalSparseMPO(SH,{"NumCenter=",nc});
+            //Move right, then back left to
+            //check reusing the edge tensors
+            for(auto b : {1,3,N-nc+1,2})
+                {
+                psi.position(b);
+                PH.position(b,psi);
+                PS.position(b,psi);
+                auto phi = psi(b);
+                if(nc == 2) phi *= psi(b+1);
+                ITensor Hphi,Sphi;
+                PH.product(phi,Hphi);
+                PS.product(phi,Sphi);
+                CHECK(norm(Hphi-Sphi) < 1E-12*norm(Hphi));
+                CHECK(PS.size() == PH.size());
+                CHECK_CLOSE(PS.expect(phi),PH.expect(phi));
+                }
+            }
+        }
+
+    SECTION(format("Delta Rho (QNs=%s)",conserve))
+        {
+        auto PH = LocalMPO(H);
+        auto PS = LocalSparseMPO(SH);
+        auto b = 3;
+        psi.position(b);
+        PH.position(b,psi);
+        PS.position(b,psi);
+        auto AA = psi(b)*psi(b+1);
+        auto C = std::get<0>(combiner(leftLinkIndex(psi,b),siteIndex(psi,b)));
+        auto dH = PH.deltaRho(AA,C,Fromleft),
+             dS = PS.deltaRho(AA,C,Fromleft);
+        CHECK(norm(dH-dS) < 1E-12*norm(dH));
+        C = std::get<0>(combiner(siteIndex(psi,b+1),rightLinkIndex(psi,b+1)));
+        dH = PH.deltaRho(AA,C,Fromright);
+        dS = PS.deltaRho(AA,C,Fromright);
+        CHECK(norm(dH-dS) < 1E-12*norm(dH));
+        }
+
+    SECTION(format("DMRG (QNs=%s)",conserve))
+        {
+        auto sweeps = Sweeps(4);
+        sweeps.maxdim() = 10,20;
+        sweeps.cutoff() = 1E-12;
+        sweeps.noise() = 1E-6,0.;
+        auto psiH = psi,
+             psiS = psi;
+        auto EH = dmrg(psiH,H,sweeps,{"Silent=",true});
+        auto ES = dmrg(psiS,SH,sweeps,{"Silent=",true});
+        CHECK_CLOSE(ES,EH);
+        }
+    }
+}
@@ -1,10 +1,13 @@
 #include "test.h"
 #include "itensor/mps/mps.h"
+#include "itensor/mps/metts.h"
 #include "itensor/mps/sites/spinhalf.h"
 #include "itensor/mps/sites/fermion.h"
+#include "itensor/mps/sites/electron.h"
 #include "itensor/util/print_macro.h"
 #include "itensor/util/str.h"
 #include "mps_mpo_test_helper.h"
+#include <future>
 
 using namespace itensor;
 using std::vector;
@@ -263,6 +266,53 @@ SECTION("PositionTest")
     CHECK_EQUAL(findCenter(psi),4);
     }
 
+SECTION("Position with QR")
+    {
+    auto shNeel2QNs = InitState(shsitesQNs);
+    for(auto j : range1(N))
+        shNeel2QNs.set(j,j%2==0 ? "Up" : "Dn");
+    auto psi = sum(randomMPS(shNeelQNs),randomMPS(shNeel2QNs));
+    psi.normalize();
+    auto phi = psi;
+
+    psi.position(N);
+    CHECK(checkOrtho(psi));
+    CHECK_EQUAL(findCenter(psi),N);
+    CHECK(checkTags(psi));
+    psi.position(3);
+    CHECK(checkOrtho(psi));
+    CHECK_EQUAL(findCenter(psi),3);
+    CHECK(checkTags(psi));
+    CHECK_CLOSE(inner(psi,phi),1.0);
+
+    //The svd gives the same state
+    auto psvd = phi;
+    psvd.position(N,{"UseSVD=",true});
+    CHECK_CLOSE(inner(psvd,psi),1.0);
+
+    //Truncating goes through the svd
+    auto ptr = phi;
+    ptr.position(N,{"MaxDim=",2});
+    psvd = phi;
+    psvd.position(N,{"UseSVD=",true,"MaxDim=",2});
+    CHECK(maxLinkDim(ptr) == maxLinkDim(psvd));
+    CHECK_CLOSE(std::abs(inner(ptr,psvd)),inner(psvd,psvd));
+    }
+
+SECTION("Orthogonalize without truncation")
+    {
+    auto sites = SpinHalf(N,{"ConserveQNs=",false});
+    auto psi = MPS(sites,6);
+    for(auto n : range1(N))
+        psi.ref(n).randomize();
+    auto opsi = psi;
+    opsi.orthogonalize({"Truncate=",false});
+    CHECK(checkOrtho(opsi));
+    CHECK_EQUAL(findCenter(opsi),1);
+    CHECK(checkTags(opsi));
+    CHECK_CLOSE(inner(opsi,psi)/inner(psi,psi),1.0);
+    }
+
 SECTION("Orthogonalize")
     {
     auto d = 20;
@@ -348,6 +398,263 @@ SECTION("replaceSiteInds")
       CHECK( siteIndex(psi1_new,n)==siteIndex(psi2,n) );
     }
 
+SECTION("expect")
+    {
+    auto shNeel2QNs = InitState(shsitesQNs);
+    for(auto j : range1(N))
+        shNeel2QNs.set(j,j%2==0 ? "Up" : "Dn");
+    auto psi = sum(randomMPS(shNeelQNs),randomMPS(shNeel2QNs));
+    psi *= 3.;
+
+    auto ex = expect(psi,shsitesQNs,{"Sz","S+*S-"});
+    REQUIRE(ex.size() == 2);
+    REQUIRE(ex[0].size() == size_t(N));
+    auto nrm2 = inner(psi,psi);
+    for(auto j : range1(N))
+        {
+        psi.position(j);
+        auto ket = psi(j);
+        auto bra = dag(prime(ket,"Site"));
+        CHECK_CLOSE(ex[0][j-1],elt(ket*op(shsitesQNs,"Sz",j)*bra)/nrm2);
+        CHECK_CLOSE(ex[1][j-1],elt(ket*op(shsitesQNs,"S+*S-",j)*bra)/nrm2);
+        }
+
+    auto exr = expect(psi,shsitesQNs,{"Sz"},{"SiteStart=",3,"SiteEnd=",5,"NThread=",2});
+    REQUIRE(exr[0].size() == 3);
+    for(auto j : range1(3,5)) CHECK_CLOSE(exr[0][j-3],ex[0][j-1]);
+    }
+
+SECTION("correlationMatrix")
+    {
+    auto checkCorr = [](MPS const& psi, SiteSet const& sites, 
+                        std::string A, std::string B, Args const& args)
+        {
+        auto N = length(psi);
+        auto C = correlationMatrix(psi,sites,A,B,args);
+        auto nrm2 = inner(psi,psi);
+        for(auto i : range1(N))
+        for(auto j : range1(N))
+            {
+            auto ampo = AutoMPO(sites);
+            ampo += A,i,B,j;
+            auto O = toMPO(ampo);
+            CHECK_CLOSE(C(i-1,j-1),inner(psi,O,psi)/nrm2);
+            }
+        };
+
+    SECTION("Spinless fermions")
+        {
+        auto sites = Fermion(6);
+        auto terms = std::vector<MPS>();
+        for(auto n : range1(6))
+            {
+            auto init = InitState(sites,"Emp");
+            init.set(n,"Occ");
+            init.set(n%6+1,"Occ");
+            auto phi = MPS(init);
+            phi *= 0.3*n-1.;
+            terms.push_back(phi);
+            }
+        auto psi = sum(terms);
+        checkCorr(psi,sites,"Cdag","C",{});
+        checkCorr(psi,sites,"C","Cdag",{"NThread=",3});
+        checkCorr(psi,sites,"N","N",{});
+        }
+
+    SECTION("Electrons")
+        {
+        auto sites = Electron(4);
+        auto terms = std::vector<MPS>();
+        auto states = std::vector<std::vector<std::string>>{{"Up","Dn","Emp","UpDn"},
+                                                            {"UpDn","Emp","Dn","Up"},
+                                                            {"Dn","Up","UpDn","Emp"},
+                                                            {"Emp","UpDn","Up","Dn"}};
+        for(auto n : range(states))
+            {
+            auto init = InitState(sites);
+            for(auto j : range1(4)) init.set(j,states[n][j-1]);
+            auto phi = MPS(init);
+            phi *= 1.+0.5*n;
+            terms.push_back(phi);
+            }
+        auto psi = sum(terms);
+        checkCorr(psi,sites,"Cdagup","Cup",{});
+        checkCorr(psi,sites,"Cdagdn","Cdn",{"NThread=",2});
+        }
+
+    SECTION("Site range")
+        {
+        auto psi = randomMPS(shNeelQNs);
+        auto C = correlationMatrix(psi,shsitesQNs,"Sz","Sz");
+        auto Cr = correlationMatrix(psi,shsitesQNs,"Sz","Sz",{"SiteStart=",4,"SiteEnd=",7});
+        REQUIRE(nrows(Cr) == 4);
+        for(auto i : range(4))
+        for(auto j : range(4))
+            {
+            CHECK_CLOSE(Cr(i,j),C(i+3,j+3));
+            }
+        }
+    }
+
+SECTION("entanglementSpectra")
+    {
+    auto shNeel2QNs = InitState(shsitesQNs);
+    for(auto j : range1(N))
+        shNeel2QNs.set(j,j%2==0 ? "Up" : "Dn");
+    auto psi = sum(randomMPS(shNeelQNs),0.5*randomMPS(shNeel2QNs));
+
+    auto specs = entanglementSpectra(psi);
+    auto S1 = entanglementEntropies(psi);
+    auto S2 = entanglementEntropies(psi,{"Alpha=",2.});
+    REQUIRE(specs.size() == size_t(N-1));
+    REQUIRE(S1.size() == size_t(N-1));
+
+    //Truncation args are ignored
+    auto tspecs = entanglementSpectra(psi,{"MaxDim=",1,"Cutoff=",0.1});
+    REQUIRE(tspecs.size() == specs.size());
+    for(auto b : range1(N-1))
+        {
+        CHECK(tspecs[b-1].size() == specs[b-1].size());
+        }
+
+    for(auto b : range1(N-1))
+        {
+        //Compare to an svd at bond b
+        auto phi = psi;
+        phi.position(b);
+        auto AA = phi(b)*phi(b+1);
+        auto U = ITensor(siteIndex(phi,b));
+        if(b > 1) U = ITensor(siteIndex(phi,b),linkIndex(phi,b-1));
+        ITensor D,V;
+        auto spec = svd(AA,U,D,V,{"ComputeQNs=",true});
+        auto p = spec.eigs();
+        p /= sumels(p);
+
+        auto& es = specs[b-1];
+        //The bond dimension may be smaller than the
+        //number of singular values of AA
+        REQUIRE(es.size() <= int(p.size()));
+        CHECK(es.hasQNs());
+        Real vN = 0, r2 = 0;
+        for(auto n : range1(int(p.size())))
+            {
+            CHECK_CLOSE((n <= es.size() ? es.eig(n) : 0.),p(n-1));
+            if(p(n-1) > 1E-12 && n <= es.size()) CHECK(es.qn(n) == spec.qn(n));
+            if(p(n-1) > 0) vN -= p(n-1)*std::log(p(n-1));
+            r2 += p(n-1)*p(n-1);
+            }
+        CHECK_CLOSE(S1[b-1],vN);
+        CHECK_CLOSE(S2[b-1],-std::log(r2));
+        }
+    }
+
+SECTION("sample")
+    {
+    auto psi = randomMPS(shsites,4);
+    auto nsample = 20000;
+    for(auto basis : {"Z","X"})
+        {
+        auto samples = sample(psi,nsample,{"Basis=",basis,"Seed=",7});
+        REQUIRE(samples.size() == size_t(nsample));
+        auto opname = std::string(basis) == "Z" ? "Sz" : "Sx";
+        auto ex = expect(psi,shsites,{opname});
+        for(auto j : range1(N))
+            {
+            auto avg = 0.;
+            for(auto& c : samples) avg += (c[j-1] == 1 ? 0.5 : -0.5);
+            avg /= nsample;
+            //About six standard deviations
+            CHECK(std::fabs(avg-ex[0][j-1]) < 0.02);
+            }
+        }
+
+    //Draws are fixed by the seed
+    auto s1 = sample(psi,10,{"Seed=",3,"BatchSize=",4});
+    auto s2 = sample(psi,10,{"Seed=",3,"BatchSize=",4});
+    CHECK(s1 == s2);
+
+    //Samples of a QN conserving MPS have its total QN,
+    //and are drawn sector by sector with the right weights
+    auto shNeel2QNs = InitState(shsitesQNs);
+    for(auto j : range1(N))
+        shNeel2QNs.set(j,j%2==0 ? "Up" : "Dn");
+    auto psiQN = sum(randomMPS(shNeelQNs),randomMPS(shNeel2QNs));
+    auto sQN = sample(psiQN,nsample,{"Seed=",5,"BatchSize=",1000});
+    for(auto& c : sQN)
+        {
+        auto nup = 0;
+        for(auto st : c) nup += (st == 1);
+        CHECK(nup == N/2);
+        }
+    auto exQN = expect(psiQN,shsitesQNs,{"Sz"});
+    for(auto j : range1(N))
+        {
+        auto avg = 0.;
+        for(auto& c : sQN) avg += (c[j-1] == 1 ? 0.5 : -0.5);
+        CHECK(std::fabs(avg/nsample-exQN[0][j-1]) < 0.02);
+        }
+
+    //A phase on one site does not change the draws
+    auto phiQN = psiQN;
+    phiQN.ref(2) *= Cplx_i;
+    CHECK(sample(phiQN,100,{"Seed=",9}) == sample(psiQN,100,{"Seed=",9}));
+    }
+
+SECTION("metts")
+    {
+    auto Ns = 4;
+    auto beta = 1.;
+    auto sites = SpinHalf(Ns,{"ConserveQNs=",false});
+    auto ampo = AutoMPO(sites);
+    for(auto j : range1(Ns-1))
+        {
+        ampo += 0.5,"S+",j,"S-",j+1;
+        ampo += 0.5,"S-",j,"S+",j+1;
+        ampo +=     "Sz",j,"Sz",j+1;
+        }
+    auto H = toMPO(ampo);
+
+    //Exact thermal energy
+    auto T = H(1);
+    for(auto j : range1(2,Ns)) T *= H(j);
+    ITensor U,D;
+    diagHermitian(T,U,D);
+    auto d = D.inds()[0];
+    auto Z = 0.,
+         E = 0.;
+    for(auto n : range1(dim(d)))
+        {
+        auto e = elt(D,n,n);
+        Z += std::exp(-beta*e);
+        E += e*std::exp(-beta*e);
+        }
+    E /= Z;
+
+    auto nchain = 4,
+         nstep = 60;
+    auto energies = [&](int nthread)
+        {
+        auto en = std::vector<std::vector<Real>>(nchain,std::vector<Real>(nstep));
+        auto measure = [&en,&H](int c, int step, MPS const& phi)
+            {
+            en[c][step] = inner(phi,H,phi);
+            };
+        metts(sites,H,beta,measure,{"NChain=",nchain,"NStep=",nstep,"NThread=",nthread,
+                                    "Seed=",11,"Cutoff=",1E-10,"Tau=",0.1});
+        return en;
+        };
+    auto en1 = energies(1);
+    auto en2 = energies(2);
+    auto avg = 0.;
+    for(auto c : range(nchain))
+    for(auto step : range(nstep))
+        {
+        CHECK_CLOSE(en1[c][step],en2[c][step]);
+        avg += en1[c][step]/(nchain*nstep);
+        }
+    CHECK(std::fabs(avg-E) < 0.1);
+    }
+
 SECTION("prime")
     {
     auto s = SpinHalf(N,{"ConserveQNs=",false});
@@ -375,4 +682,73 @@ SECTION("prime")
 
     }
 
+SECTION("Lazy relabeling")
+    {
+    auto s = SpinHalf(N,{"ConserveQNs=",false});
+    auto psi = randomMPS(s,4);
+    auto l3 = linkIndex(psi,3);
+
+    //Many more relabelings than tensors
+    auto phi = psi;
+    for(auto n : range(50))
+        {
+        phi.prime(2,"Site");
+        phi.mapPrime(2,0);
+        if(n%7 == 0) CHECK(siteIndex(phi,n%N+1) == s(n%N+1));
+        }
+    phi.replaceTags("Site","x").prime("Link");
+    for(auto j : range1(N))
+        {
+        CHECK(siteIndex(phi,j) == replaceTags(s(j),"Site","x"));
+        }
+    CHECK(linkIndex(phi,3) == prime(l3));
+    //psi is unaffected by relabeling its copy
+    CHECK(siteIndex(psi,3) == s(3));
+    CHECK(linkIndex(psi,3) == l3);
+
+    //Tensors replaced after a relabeling
+    //are not relabeled again
+    auto chi = psi;
+    chi.prime("Site");
+    chi.ref(2) = prime(psi(2),"Site");
+    CHECK(siteIndex(chi,2) == prime(s(2)));
+    CHECK_CLOSE(inner(psi,chi.noPrime()),1.);
+
+    //Relabeling an MPS kept on disk
+    auto psid = psi;
+    psid.doWrite(true);
+    psid.replaceTags("Site","y");
+    psid.position(N);
+    psid.position(1);
+    for(auto j : range1(N))
+        {
+        CHECK(hasTags(siteIndex(psid,j),"y"));
+        }
+    psid.doWrite(false);
+    CHECK(siteIndex(psid,5) == replaceTags(s(5),"Site","y"));
+    psid.replaceTags("y","Site");
+    CHECK_CLOSE(inner(psi,psid),1.);
+
+    //Const reads from several threads apply
+    //the pending relabelings once
+    auto xi = psi;
+    xi.prime("Site").replaceTags("Link","z");
+    auto read = [&xi]
+        {
+        auto ok = true;
+        for(auto j : range1(N)) ok = ok && hasTags(siteIndex(xi,j),"Site") && primeLevel(siteIndex(xi,j)) == 1;
+        return ok;
+        };
+    auto tasks = std::vector<std::future<bool>>();
+    for([[maybe_unused]] auto n : range(4)) tasks.push_back(std::async(std::launch::async,read));
+    for(auto& t : tasks) CHECK(t.get());
+    CHECK(hasTags(linkIndex(xi,3),"z"));
+    CHECK(not hasTags(linkIndex(xi,3),"Link"));
+
+    auto H = MPO(s);
+    H.prime("Site").mapPrime(1,0,"Site");
+    CHECK(hasIndex(H(4),prime(s(4),2)));
+    CHECK(hasIndex(H(4),s(4)));
+    }
+
 }
@@ -72,6 +72,53 @@ SECTION("SpinHalf (no QNs)")
     op(sites,"ISy",2); 
     }
 
+SECTION("Operator cache")
+    {
+    auto sites = SpinHalf(N,{"ConserveQNs=",false});
+    auto Sz = op(sites,"Sz",2);
+    CHECK(op(sites,"Sz",2).store() == Sz.store());
+    //Copies of a SiteSet share the cache
+    auto sites2 = sites;
+    CHECK(op(sites2,"Sz",2).store() == Sz.store());
+    CHECK(op(sites,"Sz",3).store() != Sz.store());
+
+    //Modifying a returned operator leaves the cached one alone
+    Sz.set(1,1,5.);
+    CHECK_CLOSE(elt(op(sites,"Sz",2),1,1),0.5);
+
+    //Operators depending on Args are cached separately
+    auto P1 = op(sites,"Proj",2,{"State=",1});
+    auto P2 = op(sites,"Proj",2,{"State=",2});
+    CHECK_CLOSE(elt(P1,1,1),1.);
+    CHECK_CLOSE(elt(P2,1,1),0.);
+    CHECK_CLOSE(elt(P2,2,2),1.);
+
+    CHECK_CLOSE(norm(op(sites,"Sz*Sz",4)-multSiteOps(op(sites,"Sz",4),op(sites,"Sz",4))),0.);
+
+    auto SzOps = ops(sites,"Sz",{1,3,5});
+    REQUIRE(SzOps.size() == 3);
+    CHECK(hasIndex(SzOps[1],sites(3)));
+    CHECK(SzOps[1].store() == op(sites,"Sz",3).store());
+
+    //The cache keeps only the most recently used
+    //operators, however many Args are passed
+    auto Sz5 = op(sites,"Sz",5);
+    for(auto n : range(SiteOpCache::max_size))
+        {
+        op(sites,"Sz",4,{"Tau=",0.01*n});
+        }
+    auto last = Args("Tau",0.01*(SiteOpCache::max_size-1));
+    CHECK(op(sites,"Sz",4,last).store() == op(sites,"Sz",4,last).store());
+    CHECK(op(sites,"Sz",5).store() != Sz5.store());
+    CHECK_CLOSE(norm(op(sites,"Sz",5)-Sz5),0.);
+
+    //Replacing a site drops its cached operators
+    auto s2 = sites(2);
+    sites.set(2,SpinHalfSite({"SiteNumber=",2,"ConserveQNs=",false}));
+    CHECK(hasIndex(op(sites,"Sz",2),sites(2)));
+    CHECK(not hasIndex(op(sites,"Sz",2),s2));
+    }
+
 SECTION("SpinOne")
     {
     auto sites = SpinOne(N,{"ConserveQNs=",false});
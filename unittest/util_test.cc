@@ -3,6 +3,7 @@
 #include "itensor/global.h"
 #include "itensor/util/infarray.h"
 #include "itensor/util/stats.h"
+#include "itensor/util/scratch.h"
 
 using namespace itensor;
 using namespace std;
@@ -261,3 +262,37 @@ SECTION("BinErr")
     }
 }
 
+
+TEST_CASE("ScratchArena")
+{
+scratchRelease();
+auto S0 = scratchStats();
+
+SECTION("Reuse")
+    {
+        {
+        auto b = scratchBuffer<Real>(100000);
+        CHECK(b.size() == 100000);
+        for(auto n : range(b.size())) b[n] = n;
+        CHECK(scratchStats().inuse >= 100000*sizeof(Real));
+        }
+    auto S1 = scratchStats();
+    CHECK(S1.inuse == S0.inuse);
+    CHECK(S1.cached > S0.cached);
+    CHECK(S1.peak >= 100000*sizeof(Real));
+        {
+        //Slightly smaller request falls in the same size class
+        auto b = scratchBuffer<Real>(99000);
+        CHECK(scratchStats().nreuse == S1.nreuse+1);
+        }
+    scratchRelease();
+    CHECK(scratchStats().cached == 0);
+    }
+
+SECTION("Empty")
+    {
+    auto b = scratchBuffer<Cplx>(0);
+    CHECK(b.data() == nullptr);
+    CHECK(scratchStats().nalloc == S0.nalloc);
+    }
+}